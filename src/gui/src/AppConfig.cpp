@@ -85,6 +85,8 @@ bool AppConfig::logToFile() const { return m_LogToFile; }
 
 const QString &AppConfig::logFilename() const { return m_LogFilename; }
 
+const QString &AppConfig::logCategories() const { return m_LogCategories; }
+
 QString AppConfig::log_dir() const
 {
 #if defined(Q_OS_WIN)
@@ -146,6 +148,7 @@ void AppConfig::loadSettings()
     m_LogLevel = settings().value("logLevel", 3).toInt(); // level 3: INFO
     m_LogToFile = settings().value("logToFile", false).toBool();
     m_LogFilename = settings().value("logFilename", log_dir() + "input-leap.log").toString();
+    m_LogCategories = settings().value("logCategories").toString();
     m_WizardLastRun = settings().value("wizardLastRun", 0).toInt();
     m_Language = settings().value("language", QLocale::system().name()).toString();
     m_StartedBefore = settings().value("startedBefore", false).toBool();
@@ -173,6 +176,7 @@ void AppConfig::saveSettings()
     settings().setValue("logLevel", m_LogLevel);
     settings().setValue("logToFile", m_LogToFile);
     settings().setValue("logFilename", m_LogFilename);
+    settings().setValue("logCategories", m_LogCategories);
     settings().setValue("wizardLastRun", kWizardVersion);
     settings().setValue("language", m_Language);
     settings().setValue("startedBefore", m_StartedBefore);
@@ -204,6 +208,8 @@ void AppConfig::setLogToFile(bool b) { m_LogToFile = b; }
 
 void AppConfig::setLogFilename(const QString &s) { m_LogFilename = s; }
 
+void AppConfig::setLogCategories(const QString &s) { m_LogCategories = s; }
+
 void AppConfig::setWizardHasRun() { m_WizardLastRun = kWizardVersion; }
 
 void AppConfig::setLanguage(const QString language) { m_Language = language; }
@@ -69,6 +69,7 @@ class AppConfig: public QObject
         const QString& logFilename() const;
         const QString logFilenameCmd() const;
         QString logLevelText() const;
+        const QString& logCategories() const;
         ProcessMode processMode() const;
         bool wizardShouldRun() const;
         const QString& language() const;
@@ -111,6 +112,7 @@ protected:
         void setLogLevel(int i);
         void setLogToFile(bool b);
         void setLogFilename(const QString& s);
+        void setLogCategories(const QString& s);
         void setWizardHasRun();
         void setLanguage(const QString language);
         void setStartedBefore(bool b);
@@ -125,6 +127,7 @@ protected:
         int m_LogLevel;
         bool m_LogToFile;
         QString m_LogFilename;
+        QString m_LogCategories;
         int m_WizardLastRun;
         ProcessMode m_ProcessMode;
         QString m_Language;
@@ -24,3 +24,4 @@ const char*                kIpcMsgHello        = "IHEL%1i";
 const char*                kIpcMsgLogLine        = "ILOG%s";
 const char*                kIpcMsgCommand        = "ICMD%s%1i";
 const char*                kIpcMsgShutdown        = "ISDN";
+const char*                kIpcMsgLogFilter        = "ILFL%s";
@@ -28,6 +28,7 @@ enum qIpcMessageType {
     kIpcLogLine,
     kIpcCommand,
     kIpcShutdown,
+    kIpcLogFilter,
 };
 
 enum qIpcClientType {
@@ -40,3 +41,4 @@ extern const char*        kIpcMsgHello;
 extern const char*        kIpcMsgLogLine;
 extern const char*        kIpcMsgCommand;
 extern const char*        kIpcMsgShutdown;
+extern const char*        kIpcMsgLogFilter;
@@ -123,6 +123,21 @@ void IpcClient::sendCommand(const QString& command, ElevateMode const elevate)
     stream.writeRawData(elevateBuf, 1);
 }
 
+void IpcClient::sendLogFilter(const QString& filters)
+{
+    QDataStream stream(m_Socket);
+
+    stream.writeRawData(kIpcMsgLogFilter, 4);
+
+    QByteArray utf8 = filters.toUtf8();
+    int length = utf8.size();
+
+    char lenBuf[4];
+    intToBytes(length, lenBuf, 4);
+    stream.writeRawData(lenBuf, 4);
+    stream.writeRawData(utf8.constData(), length);
+}
+
 void IpcClient::handleReadLogLine(const QString& text)
 {
     Q_EMIT readLogLine(text);
@@ -36,6 +36,7 @@ public:
 
     void sendHello();
     void sendCommand(const QString& command, ElevateMode elevate);
+    void sendLogFilter(const QString& filters);
     void connectToHost();
     void disconnectFromHost();
 
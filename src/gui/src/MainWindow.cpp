@@ -576,6 +576,10 @@ void MainWindow::start_cmd_app()
 
     args << "-f" << "--no-tray" << "--debug" << appConfig().logLevelText();
 
+    if (!appConfig().logCategories().isEmpty()) {
+        args << "--log-category" << appConfig().logCategories();
+    }
+
 
     args << "--name" << getScreenName();
 
@@ -1184,8 +1188,14 @@ void MainWindow::on_m_pActionSettings_triggered()
 {
     auto dialog = std::make_unique<SettingsDialog>(this, appConfig());
     connect(dialog.get(), &SettingsDialog::requestLanguageChange, this, &MainWindow::requestLanguageChange);
-    if (dialog.get()->exec() == QDialog::Accepted)
+    if (dialog.get()->exec() == QDialog::Accepted) {
         updateSSLFingerprint();
+
+        // the daemon applies new category filters without a restart
+        if (appConfig().processMode() == Service) {
+            m_IpcClient.sendLogFilter(appConfig().logCategories());
+        }
+    }
     disconnect(dialog.get(), &SettingsDialog::requestLanguageChange, this, &MainWindow::requestLanguageChange);
 }
 
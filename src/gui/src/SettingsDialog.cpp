@@ -49,6 +49,7 @@ SettingsDialog::SettingsDialog(QWidget* parent, AppConfig& config) :
     ui_->m_pComboLogLevel->setCurrentIndex(app_config_.logLevel());
     ui_->m_pCheckBoxLogToFile->setChecked(app_config_.logToFile());
     ui_->m_pLineEditLogFilename->setText(app_config_.logFilename());
+    ui_->m_pLineEditLogCategories->setText(app_config_.logCategories());
     setIndexFromItemData(ui_->m_pComboLanguage, app_config_.language());
     ui_->m_pCheckBoxAutoHide->setChecked(app_config_.getAutoHide());
     ui_->m_pCheckBoxAutoStart->setChecked(app_config_.getAutoStart());
@@ -79,6 +80,7 @@ void SettingsDialog::accept()
     app_config_.setLogLevel(ui_->m_pComboLogLevel->currentIndex());
     app_config_.setLogToFile(ui_->m_pCheckBoxLogToFile->isChecked());
     app_config_.setLogFilename(ui_->m_pLineEditLogFilename->text());
+    app_config_.setLogCategories(ui_->m_pLineEditLogCategories->text().trimmed());
     app_config_.setLanguage(ui_->m_pComboLanguage->itemData(ui_->m_pComboLanguage->currentIndex()).toString());
     app_config_.setElevateMode(static_cast<ElevateMode>(ui_->m_pComboElevate->currentIndex()));
     app_config_.setAutoHide(ui_->m_pCheckBoxAutoHide->isChecked());
@@ -0,0 +1,894 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/BinaryLog.h"
+#include "base/Log.h"
+#include "io/filesystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+namespace inputleap {
+
+/*
+File layout, all integers little endian:
+
+  header:  "ILBLOG" 0 1
+  site:    'S' u32 id, i32 line, u16 file length, file, u16 format length, format
+  record:  'R' u32 site id, i8 priority, u64 nanoseconds since the epoch,
+           u32 argument bytes, arguments
+
+Every argument is a type byte followed by its value: 'i' i64, 'u' u64,
+'f' double as u64, 'p' u64, or 's' u16 length and the bytes.
+*/
+
+namespace {
+
+const char kMagic[8] = { 'I', 'L', 'B', 'L', 'O', 'G', 0, 1 };
+
+// a thread's records are appended to the file once they exceed this size
+const std::size_t kFlushThreshold = 16 * 1024;
+
+// records that are still buffered are written this long after the first
+// one, so a crash loses little
+const std::chrono::milliseconds kFlushInterval(500);
+
+// longest string argument that is recorded
+const std::size_t kMaxStringArg = 4096;
+
+std::atomic<std::uint64_t> g_nextSerial{1};
+
+// the live writers by serial, so that a thread that exits after its writer
+// was destroyed doesn't touch it.  never destroyed, threads may exit late.
+std::mutex& writers_mutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+std::unordered_map<std::uint64_t, BinaryLogWriter*>& live_writers()
+{
+    static auto* writers = new std::unordered_map<std::uint64_t, BinaryLogWriter*>;
+    return *writers;
+}
+
+void put_u16(std::vector<unsigned char>& out, std::uint16_t value)
+{
+    out.push_back(static_cast<unsigned char>(value));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+}
+
+void put_u32(std::vector<unsigned char>& out, std::uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+void put_u64(std::vector<unsigned char>& out, std::uint64_t value)
+{
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+void put_string(std::vector<unsigned char>& out, const char* s, std::size_t length)
+{
+    put_u16(out, static_cast<std::uint16_t>(length));
+    out.insert(out.end(), s, s + length);
+}
+
+// one printf conversion specification, without the leading '%'
+struct Conversion {
+    const char* flags;
+    std::size_t flags_length;
+    const char* width;
+    std::size_t width_length;
+    bool has_precision;
+    const char* precision;
+    std::size_t precision_length;
+    const char* length;
+    std::size_t length_length;
+    char conversion;
+};
+
+// parses the conversion specification starting just after a '%' and
+// leaves p after it.  returns false if the specification is malformed.
+bool parse_conversion(const char*& p, Conversion& c)
+{
+    c.flags = p;
+    while (*p != '\0' && std::strchr("-+ #0'", *p) != nullptr) {
+        ++p;
+    }
+    c.flags_length = p - c.flags;
+
+    c.width = p;
+    if (*p == '*') {
+        ++p;
+    } else {
+        while (*p >= '0' && *p <= '9') {
+            ++p;
+        }
+    }
+    c.width_length = p - c.width;
+
+    c.has_precision = (*p == '.');
+    if (c.has_precision) {
+        ++p;
+    }
+    c.precision = p;
+    if (c.has_precision && *p == '*') {
+        ++p;
+    } else if (c.has_precision) {
+        while (*p >= '0' && *p <= '9') {
+            ++p;
+        }
+    }
+    c.precision_length = p - c.precision;
+
+    c.length = p;
+    while (*p != '\0' && std::strchr("hljztLq", *p) != nullptr) {
+        ++p;
+    }
+    c.length_length = p - c.length;
+
+    c.conversion = *p;
+    if (c.conversion == '\0' ||
+        std::strchr("%diuoxXcfFeEgGaAspn", c.conversion) == nullptr) {
+        return false;
+    }
+    ++p;
+    return true;
+}
+
+bool has_length(const Conversion& c, const char* length)
+{
+    return c.length_length == std::strlen(length) &&
+           std::strncmp(c.length, length, c.length_length) == 0;
+}
+
+// reads the arguments described by format from args and appends them to out
+void encode_args(std::vector<unsigned char>& out, const char* format, va_list args)
+{
+    using ssize = std::make_signed<std::size_t>::type;
+
+    for (const char* p = format; *p != '\0';) {
+        if (*p++ != '%') {
+            continue;
+        }
+
+        Conversion c;
+        if (!parse_conversion(p, c)) {
+            // the decoder stops at the same place
+            return;
+        }
+
+        if (c.width_length == 1 && *c.width == '*') {
+            out.push_back('i');
+            put_u64(out, static_cast<std::uint64_t>(static_cast<std::int64_t>(va_arg(args, int))));
+        }
+        int precision = -1;
+        if (c.precision_length == 1 && *c.precision == '*') {
+            precision = va_arg(args, int);
+            out.push_back('i');
+            put_u64(out, static_cast<std::uint64_t>(static_cast<std::int64_t>(precision)));
+        } else if (c.has_precision) {
+            precision = 0;
+            for (std::size_t i = 0; i < c.precision_length; ++i) {
+                precision = precision * 10 + (c.precision[i] - '0');
+            }
+        }
+
+        switch (c.conversion) {
+        case '%':
+            break;
+
+        case 'd':
+        case 'i': {
+            std::int64_t value;
+            if (has_length(c, "l")) {
+                value = va_arg(args, long);
+            } else if (has_length(c, "ll") || has_length(c, "q")) {
+                value = va_arg(args, long long);
+            } else if (has_length(c, "j")) {
+                value = va_arg(args, std::intmax_t);
+            } else if (has_length(c, "z")) {
+                value = va_arg(args, ssize);
+            } else if (has_length(c, "t")) {
+                value = va_arg(args, std::ptrdiff_t);
+            } else {
+                value = va_arg(args, int);
+            }
+            out.push_back('i');
+            put_u64(out, static_cast<std::uint64_t>(value));
+            break;
+        }
+
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X': {
+            std::uint64_t value;
+            if (has_length(c, "l")) {
+                value = va_arg(args, unsigned long);
+            } else if (has_length(c, "ll") || has_length(c, "q")) {
+                value = va_arg(args, unsigned long long);
+            } else if (has_length(c, "j")) {
+                value = va_arg(args, std::uintmax_t);
+            } else if (has_length(c, "z")) {
+                value = va_arg(args, std::size_t);
+            } else if (has_length(c, "t")) {
+                value = static_cast<std::uint64_t>(va_arg(args, std::ptrdiff_t));
+            } else {
+                value = va_arg(args, unsigned int);
+            }
+            // keep the width of the original type so that e.g. %hx of a
+            // negative short decodes the same
+            if (has_length(c, "hh")) {
+                value = static_cast<unsigned char>(value);
+            } else if (has_length(c, "h")) {
+                value = static_cast<unsigned short>(value);
+            }
+            out.push_back('u');
+            put_u64(out, value);
+            break;
+        }
+
+        case 'c':
+            out.push_back('i');
+            put_u64(out, static_cast<std::uint64_t>(static_cast<std::int64_t>(va_arg(args, int))));
+            break;
+
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A': {
+            double value;
+            if (has_length(c, "L")) {
+                value = static_cast<double>(va_arg(args, long double));
+            } else {
+                value = va_arg(args, double);
+            }
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            out.push_back('f');
+            put_u64(out, bits);
+            break;
+        }
+
+        case 's': {
+            out.push_back('s');
+            if (has_length(c, "l")) {
+                // wide strings are not used for logging; don't guess at them
+                va_arg(args, const wchar_t*);
+                put_string(out, "", 0);
+                break;
+            }
+            const char* s = va_arg(args, const char*);
+            if (s == nullptr) {
+                s = "(null)";
+            }
+            std::size_t limit = kMaxStringArg;
+            if (precision >= 0 && static_cast<std::size_t>(precision) < limit) {
+                limit = precision;
+            }
+            // the string need not be terminated if a precision was given
+            const void* end = std::memchr(s, '\0', limit);
+            std::size_t length = end != nullptr ? static_cast<const char*>(end) - s : limit;
+            put_string(out, s, length);
+            break;
+        }
+
+        case 'p':
+            out.push_back('p');
+            put_u64(out, reinterpret_cast<std::uintptr_t>(va_arg(args, void*)));
+            break;
+
+        case 'n':
+            // never write through the pointer
+            va_arg(args, void*);
+            break;
+        }
+    }
+}
+
+std::uint64_t now_ns()
+{
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+//
+// decoding
+//
+
+class Reader {
+public:
+    Reader(const unsigned char* data, std::size_t size) : p_(data), end_(data + size) { }
+
+    bool at_end() const { return p_ == end_; }
+
+    bool get_u8(std::uint8_t& value)
+    {
+        if (end_ - p_ < 1) {
+            return false;
+        }
+        value = *p_++;
+        return true;
+    }
+
+    bool get_u16(std::uint16_t& value)
+    {
+        std::uint64_t v;
+        if (!get(2, v)) {
+            return false;
+        }
+        value = static_cast<std::uint16_t>(v);
+        return true;
+    }
+
+    bool get_u32(std::uint32_t& value)
+    {
+        std::uint64_t v;
+        if (!get(4, v)) {
+            return false;
+        }
+        value = static_cast<std::uint32_t>(v);
+        return true;
+    }
+
+    bool get_u64(std::uint64_t& value) { return get(8, value); }
+
+    bool get_bytes(std::size_t size, std::string& value)
+    {
+        if (static_cast<std::size_t>(end_ - p_) < size) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(p_), size);
+        p_ += size;
+        return true;
+    }
+
+    bool get_string(std::string& value)
+    {
+        std::uint16_t size;
+        return get_u16(size) && get_bytes(size, value);
+    }
+
+private:
+    bool get(int size, std::uint64_t& value)
+    {
+        if (end_ - p_ < size) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < size; ++i) {
+            value |= static_cast<std::uint64_t>(*p_++) << (8 * i);
+        }
+        return true;
+    }
+
+    const unsigned char* p_;
+    const unsigned char* end_;
+};
+
+struct Site {
+    std::string file;
+    int line;
+    std::string format;
+};
+
+struct Message {
+    std::uint64_t time;
+    std::string text;
+};
+
+void append_printf(std::string& out, const std::string& spec, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, spec);
+    int n = std::vsnprintf(buffer, sizeof(buffer), spec.c_str(), args);
+    va_end(args);
+    if (n < 0) {
+        return;
+    }
+    if (static_cast<std::size_t>(n) < sizeof(buffer)) {
+        out.append(buffer, n);
+        return;
+    }
+
+    std::vector<char> large(n + 1);
+    va_start(args, spec);
+    std::vsnprintf(large.data(), large.size(), spec.c_str(), args);
+    va_end(args);
+    out.append(large.data(), n);
+}
+
+// formats the arguments in args according to format
+bool format_args(const std::string& format, Reader& args, std::string& out)
+{
+    auto next = [&args](char type, std::uint64_t& value) {
+        std::uint8_t actual;
+        return args.get_u8(actual) && actual == type && args.get_u64(value);
+    };
+
+    const char* p = format.c_str();
+    while (*p != '\0') {
+        if (*p != '%') {
+            out += *p++;
+            continue;
+        }
+        const char* start = p++;
+
+        Conversion c;
+        if (!parse_conversion(p, c)) {
+            out.append(start);
+            return true;
+        }
+        if (c.conversion == '%') {
+            out += '%';
+            continue;
+        }
+
+        std::string spec = "%";
+        spec.append(c.flags, c.flags_length);
+        std::uint64_t value;
+        if (c.width_length == 1 && *c.width == '*') {
+            if (!next('i', value)) {
+                return false;
+            }
+            spec += std::to_string(static_cast<std::int64_t>(value));
+        } else {
+            spec.append(c.width, c.width_length);
+        }
+        if (c.has_precision) {
+            spec += '.';
+            if (c.precision_length == 1 && *c.precision == '*') {
+                if (!next('i', value)) {
+                    return false;
+                }
+                spec += std::to_string(static_cast<std::int64_t>(value));
+            } else {
+                spec.append(c.precision, c.precision_length);
+            }
+        }
+
+        switch (c.conversion) {
+        case 'd':
+        case 'i':
+            if (!next('i', value)) {
+                return false;
+            }
+            spec += "ll";
+            spec += c.conversion;
+            append_printf(out, spec, static_cast<long long>(value));
+            break;
+
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            if (!next('u', value)) {
+                return false;
+            }
+            spec += "ll";
+            spec += c.conversion;
+            append_printf(out, spec, static_cast<unsigned long long>(value));
+            break;
+
+        case 'c':
+            if (!next('i', value)) {
+                return false;
+            }
+            spec += 'c';
+            append_printf(out, spec, static_cast<int>(value));
+            break;
+
+        case 's': {
+            std::uint8_t type;
+            std::string s;
+            if (!args.get_u8(type) || type != 's' || !args.get_string(s)) {
+                return false;
+            }
+            spec += 's';
+            append_printf(out, spec, s.c_str());
+            break;
+        }
+
+        case 'p':
+            if (!next('p', value)) {
+                return false;
+            }
+            spec += 'p';
+            append_printf(out, spec, reinterpret_cast<void*>(static_cast<std::uintptr_t>(value)));
+            break;
+
+        case 'n':
+            break;
+
+        default: {
+            if (!next('f', value)) {
+                return false;
+            }
+            double d;
+            std::memcpy(&d, &value, sizeof(d));
+            spec += c.conversion;
+            append_printf(out, spec, d);
+            break;
+        }
+        }
+    }
+    return args.at_end();
+}
+
+void format_prefix(std::string& out, int priority, std::uint64_t time)
+{
+    if (priority == kPRINT) {
+        return;
+    }
+
+    std::time_t seconds = static_cast<std::time_t>(time / 1000000000);
+    unsigned micros = static_cast<unsigned>((time % 1000000000) / 1000);
+    struct tm* tm = std::localtime(&seconds);
+
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "[%04i-%02i-%02iT%02i:%02i:%02i.%06u] ",
+                  tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
+                  tm->tm_hour, tm->tm_min, tm->tm_sec, micros);
+    out += buffer;
+    out += CLOG->getFilterName(priority);
+    out += ": ";
+}
+
+} // namespace
+
+//
+// BinaryLogWriter
+//
+
+struct BinaryLogWriter::ThreadBuffer {
+    // guards data against flush() from other threads
+    std::mutex mutex;
+    std::vector<unsigned char> data;
+
+    // call sites this thread has used, only touched by the owning thread
+    std::unordered_map<SiteKey, std::uint32_t, SiteKeyHash> sites;
+};
+
+// hands the buffer of a thread back to its writer when the thread exits
+struct BinaryLogWriter::ThreadLease {
+    ~ThreadLease()
+    {
+        release();
+    }
+
+    void release()
+    {
+        if (buffer == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(writers_mutex());
+        auto writer = live_writers().find(serial);
+        if (writer != live_writers().end()) {
+            writer->second->release_buffer(*buffer);
+        }
+        serial = 0;
+        buffer = nullptr;
+    }
+
+    std::uint64_t serial = 0;
+    ThreadBuffer* buffer = nullptr;
+};
+
+std::size_t BinaryLogWriter::SiteKeyHash::operator()(const SiteKey& key) const
+{
+    std::size_t hash = std::hash<const void*>()(key.format);
+    hash ^= std::hash<const void*>()(key.file) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.line) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+BinaryLogWriter::BinaryLogWriter(const std::string& path) :
+    serial_(g_nextSerial.fetch_add(1))
+{
+    open_utf8_path(file_, path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (file_.is_open()) {
+        // nothing stays buffered for a forked child to write a second time
+        file_.write(kMagic, sizeof(kMagic));
+        file_.flush();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(writers_mutex());
+        live_writers().emplace(serial_, this);
+    }
+}
+
+BinaryLogWriter::~BinaryLogWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(writers_mutex());
+        live_writers().erase(serial_);
+    }
+    {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        stopping_ = true;
+    }
+    flush_cv_.notify_one();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    flush();
+}
+
+void
+BinaryLogWriter::record(ELevel priority, const char* file, int line,
+                        const char* format, va_list args)
+{
+    ThreadBuffer& buffer = thread_buffer();
+    std::uint32_t id = site_id(buffer, SiteKey{ format, file, line });
+
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        auto& data = buffer.data;
+        data.push_back('R');
+        put_u32(data, id);
+        data.push_back(static_cast<unsigned char>(static_cast<std::int8_t>(priority)));
+        put_u64(data, now_ns());
+
+        std::size_t size_offset = data.size();
+        put_u32(data, 0);
+        encode_args(data, format, args);
+        std::uint32_t size = static_cast<std::uint32_t>(data.size() - size_offset - 4);
+        for (int i = 0; i < 4; ++i) {
+            data[size_offset + i] = static_cast<unsigned char>(size >> (8 * i));
+        }
+        full = data.size() >= kFlushThreshold;
+    }
+
+    if (full) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        write_buffer(buffer);
+        file_.flush();
+    }
+    else if (!pending_.exchange(true)) {
+        // the first record since the last flush starts the flush timer.
+        // the thread is only created here so a writer made before a fork
+        // works in the child as long as nothing was recorded.
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        if (!flusher_.joinable()) {
+            flusher_ = std::thread([this]() { flush_pending(); });
+        }
+        flush_cv_.notify_one();
+    }
+}
+
+void
+BinaryLogWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& buffer : buffers_) {
+        write_buffer(*buffer);
+    }
+    file_.flush();
+}
+
+std::size_t
+BinaryLogWriter::buffer_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffers_.size();
+}
+
+BinaryLogWriter::ThreadBuffer&
+BinaryLogWriter::thread_buffer()
+{
+    static thread_local ThreadLease lease;
+    if (lease.serial == serial_) {
+        return *lease.buffer;
+    }
+
+    // the thread used another writer before
+    lease.release();
+
+    ThreadBuffer* buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_buffers_.empty()) {
+            buffer = free_buffers_.back();
+            free_buffers_.pop_back();
+        } else {
+            buffers_.push_back(std::make_unique<ThreadBuffer>());
+            buffer = buffers_.back().get();
+        }
+    }
+    lease.serial = serial_;
+    lease.buffer = buffer;
+    return *buffer;
+}
+
+void
+BinaryLogWriter::release_buffer(ThreadBuffer& buffer)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_buffer(buffer);
+    free_buffers_.push_back(&buffer);
+}
+
+void
+BinaryLogWriter::flush_pending()
+{
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    for (;;) {
+        // sleep until something is recorded, then give it time to add up
+        flush_cv_.wait(lock, [this]() { return stopping_ || pending_; });
+        if (flush_cv_.wait_for(lock, kFlushInterval, [this]() { return stopping_; })) {
+            return;
+        }
+        pending_ = false;
+
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+std::uint32_t
+BinaryLogWriter::site_id(ThreadBuffer& buffer, const SiteKey& key)
+{
+    auto cached = buffer.sites.find(key);
+    if (cached != buffer.sites.end()) {
+        return cached->second;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = sites_.find(key);
+    std::uint32_t id;
+    if (found != sites_.end()) {
+        id = found->second;
+    } else {
+        id = static_cast<std::uint32_t>(sites_.size() + 1);
+        sites_.emplace(key, id);
+
+        const char* file = key.file != nullptr ? key.file : "";
+        std::vector<unsigned char> entry;
+        entry.push_back('S');
+        put_u32(entry, id);
+        put_u32(entry, static_cast<std::uint32_t>(key.line));
+        put_string(entry, file, std::min<std::size_t>(std::strlen(file), 0xffff));
+        put_string(entry, key.format, std::min<std::size_t>(std::strlen(key.format), 0xffff));
+        file_.write(reinterpret_cast<const char*>(entry.data()), entry.size());
+    }
+    buffer.sites.emplace(key, id);
+    return id;
+}
+
+void
+BinaryLogWriter::write_buffer(ThreadBuffer& buffer)
+{
+    // mutex_ is held by the caller
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (!buffer.data.empty()) {
+        file_.write(reinterpret_cast<const char*>(buffer.data.data()), buffer.data.size());
+        buffer.data.clear();
+    }
+}
+
+//
+// decoding
+//
+
+bool decode_binary_log(std::istream& in, std::ostream& out, std::string& error)
+{
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)),
+                                    std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(kMagic) ||
+            std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+        error = "not a binary log";
+        return false;
+    }
+
+    Reader reader(data.data() + sizeof(kMagic), data.size() - sizeof(kMagic));
+    std::unordered_map<std::uint32_t, Site> sites;
+    std::vector<Message> messages;
+    bool ok = true;
+
+    while (!reader.at_end()) {
+        std::uint8_t tag;
+        reader.get_u8(tag);
+
+        if (tag == 'S') {
+            std::uint32_t id;
+            std::uint32_t line;
+            Site site;
+            if (!reader.get_u32(id) || !reader.get_u32(line) ||
+                    !reader.get_string(site.file) || !reader.get_string(site.format)) {
+                error = "truncated call site";
+                ok = false;
+                break;
+            }
+            site.line = static_cast<int>(line);
+            sites[id] = std::move(site);
+        }
+        else if (tag == 'R') {
+            std::uint32_t id;
+            std::uint8_t priority;
+            std::uint64_t time;
+            std::uint32_t size;
+            std::string args;
+            if (!reader.get_u32(id) || !reader.get_u8(priority) || !reader.get_u64(time) ||
+                    !reader.get_u32(size) || !reader.get_bytes(size, args)) {
+                error = "truncated record";
+                ok = false;
+                break;
+            }
+
+            auto site = sites.find(id);
+            if (site == sites.end()) {
+                error = "record for unknown call site " + std::to_string(id);
+                ok = false;
+                break;
+            }
+
+            Message message;
+            message.time = time;
+            format_prefix(message.text, static_cast<std::int8_t>(priority), time);
+            Reader arg_reader(reinterpret_cast<const unsigned char*>(args.data()), args.size());
+            if (!format_args(site->second.format, arg_reader, message.text)) {
+                error = "arguments do not match format \"" + site->second.format + "\"";
+                ok = false;
+                break;
+            }
+            if (!site->second.file.empty()) {
+                message.text += "\n\t" + site->second.file + "," +
+                                std::to_string(site->second.line);
+            }
+            messages.push_back(std::move(message));
+        }
+        else {
+            error = "unknown entry";
+            ok = false;
+            break;
+        }
+    }
+
+    // each thread's records are written in batches, so restore the order
+    std::stable_sort(messages.begin(), messages.end(),
+                     [](const Message& a, const Message& b) { return a.time < b.time; });
+    for (const auto& message : messages) {
+        out << message.text << '\n';
+    }
+    return ok;
+}
+
+} // namespace inputleap
@@ -0,0 +1,136 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "base/ELevel.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace inputleap {
+
+//! Log writer that defers formatting
+/*!
+Instead of formatting a message, \c record() stores an ID for the call
+site (format string, file and line), a timestamp and the raw arguments.
+The arguments are found by scanning the format string for conversions,
+which is much cheaper than formatting.  Records are collected in a buffer
+per thread and appended to the file in batches, when a buffer fills up or
+shortly after the first record of a batch, so a crash loses little.  The
+buffer of a thread that exits is written and reused by the next new
+thread.  Each call site is written to the file once, the first time it is
+used.  The thread that writes batches is started by the first record, so
+a daemon creates the writer after forking or records nothing before.
+
+\c decode_binary_log() turns the file back into the usual text log.
+*/
+class BinaryLogWriter {
+public:
+    //! Create \p path, replacing an existing file
+    /*!
+    Check \c is_open() to see whether the file could be created.
+    */
+    explicit BinaryLogWriter(const std::string& path);
+    BinaryLogWriter(const BinaryLogWriter&) = delete;
+    BinaryLogWriter& operator=(const BinaryLogWriter&) = delete;
+    ~BinaryLogWriter();
+
+    //! @name manipulators
+    //@{
+
+    //! Record a message
+    /*!
+    Records a message with the printf-like \p format and \p args.  May be
+    called from any thread.
+    */
+    void record(ELevel priority, const char* file, int line,
+                const char* format, va_list args);
+
+    //! Write all buffered records to the file
+    void flush();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Returns true if the file was created
+    bool is_open() const { return file_.is_open(); }
+
+    //! Returns the number of thread buffers allocated so far
+    std::size_t buffer_count() const;
+
+    //@}
+
+private:
+    struct ThreadBuffer;
+    struct ThreadLease;
+    struct SiteKey {
+        const char* format;
+        const char* file;
+        int line;
+        bool operator==(const SiteKey& other) const
+        {
+            return format == other.format && file == other.file && line == other.line;
+        }
+    };
+    struct SiteKeyHash {
+        std::size_t operator()(const SiteKey& key) const;
+    };
+
+    ThreadBuffer& thread_buffer();
+    void release_buffer(ThreadBuffer& buffer);
+    std::uint32_t site_id(ThreadBuffer& buffer, const SiteKey& key);
+    void write_buffer(ThreadBuffer& buffer);
+    void flush_pending();
+
+    const std::uint64_t serial_;
+
+    mutable std::mutex mutex_;
+    std::ofstream file_;
+    std::unordered_map<SiteKey, std::uint32_t, SiteKeyHash> sites_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::vector<ThreadBuffer*> free_buffers_;
+
+    // writes what was recorded shortly after the first record of a batch
+    std::thread flusher_;
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    std::atomic<bool> pending_{false};
+    bool stopping_ = false;
+};
+
+//! Decode a binary log
+/*!
+Reads a file written by BinaryLogWriter from \p in and writes the
+formatted messages to \p out, one per line and ordered by time.  Returns
+false and sets \p error if the input is not a binary log or is corrupt;
+messages decoded before the problem are still written.
+*/
+bool decode_binary_log(std::istream& in, std::ostream& out, std::string& error);
+
+} // namespace inputleap
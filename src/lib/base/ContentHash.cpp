@@ -0,0 +1,124 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/ContentHash.h"
+
+namespace inputleap {
+
+namespace {
+
+const std::uint64_t c1 = 0x87c37b91114253d5ULL;
+const std::uint64_t c2 = 0x4cf5ad432745937fULL;
+
+inline std::uint64_t rotl(std::uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline std::uint64_t load64(const unsigned char* p)
+{
+    // little endian regardless of the host so digests are portable
+    std::uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline std::uint64_t fmix(std::uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+inline std::uint64_t mix1(std::uint64_t k)
+{
+    k *= c1;
+    k = rotl(k, 31);
+    k *= c2;
+    return k;
+}
+
+inline std::uint64_t mix2(std::uint64_t k)
+{
+    k *= c2;
+    k = rotl(k, 33);
+    k *= c1;
+    return k;
+}
+
+} // namespace
+
+ContentHash content_hash(const void* data, std::size_t size, std::uint64_t seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t h1 = seed;
+    std::uint64_t h2 = seed;
+
+    // body
+    const std::size_t blocks = size / 16;
+    for (std::size_t i = 0; i < blocks; ++i) {
+        h1 ^= mix1(load64(bytes + i * 16));
+        h1 = rotl(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        h2 ^= mix2(load64(bytes + i * 16 + 8));
+        h2 = rotl(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    // tail
+    const unsigned char* tail = bytes + blocks * 16;
+    const std::size_t rest = size & 15;
+    std::uint64_t k1 = 0;
+    std::uint64_t k2 = 0;
+    for (std::size_t i = rest; i > 8; --i) {
+        k2 = (k2 << 8) | tail[i - 1];
+    }
+    for (std::size_t i = rest < 8 ? rest : 8; i > 0; --i) {
+        k1 = (k1 << 8) | tail[i - 1];
+    }
+    if (rest > 8) {
+        h2 ^= mix2(k2);
+    }
+    if (rest > 0) {
+        h1 ^= mix1(k1);
+    }
+
+    // finalization
+    h1 ^= size;
+    h2 ^= size;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix(h1);
+    h2 = fmix(h2);
+    h1 += h2;
+    h2 += h1;
+
+    ContentHash hash;
+    hash.low = h1;
+    hash.high = h2;
+    return hash;
+}
+
+} // namespace inputleap
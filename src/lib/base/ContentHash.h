@@ -0,0 +1,57 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace inputleap {
+
+//! 128-bit content hash
+/*!
+A MurmurHash3 (x64, 128-bit) digest, used to tell whether data such as
+clipboard contents changed without keeping a copy of the old data.  It
+is not a cryptographic hash and must not be used where an attacker
+chooses the data and profits from a collision.
+*/
+struct ContentHash {
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+};
+
+inline bool operator==(const ContentHash& a, const ContentHash& b)
+{
+    return a.low == b.low && a.high == b.high;
+}
+
+inline bool operator!=(const ContentHash& a, const ContentHash& b)
+{
+    return !(a == b);
+}
+
+//! Hash \p size bytes at \p data
+ContentHash content_hash(const void* data, std::size_t size, std::uint64_t seed = 0);
+
+//! Hash the bytes of \p data
+inline ContentHash content_hash(const std::string& data, std::uint64_t seed = 0)
+{
+    return content_hash(data.data(), data.size(), seed);
+}
+
+} // namespace inputleap
@@ -0,0 +1,172 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/EventProfiler.h"
+#include "base/Log.h"
+
+namespace inputleap {
+
+namespace {
+
+std::uint64_t to_us(EventProfiler::Clock::duration d)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    return us < 0 ? 0 : static_cast<std::uint64_t>(us);
+}
+
+void update_max(std::atomic<std::uint64_t>& max, std::uint64_t value)
+{
+    std::uint64_t old = max.load(std::memory_order_relaxed);
+    while (value > old && !max.compare_exchange_weak(old, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+EventProfiler::EventProfiler()
+{
+    reset();
+}
+
+void EventProfiler::record_post(EventType type, std::size_t depth)
+{
+    auto index = static_cast<std::size_t>(type);
+    if (index >= kNumTypes) {
+        return;
+    }
+    TypeStats& stats = stats_[index];
+    stats.posted.fetch_add(1, std::memory_order_relaxed);
+    update_max(stats.peak_depth, depth);
+}
+
+void EventProfiler::record_dispatch(EventType type, Clock::time_point posted,
+                                    Clock::time_point started, Clock::time_point finished)
+{
+    auto index = static_cast<std::size_t>(type);
+    if (index >= kNumTypes) {
+        return;
+    }
+    TypeStats& stats = stats_[index];
+    if (posted != Clock::time_point()) {
+        stats.wait.add(to_us(started - posted));
+    }
+    stats.handler.add(to_us(finished - started));
+}
+
+void EventProfiler::reset()
+{
+    for (auto& stats : stats_) {
+        stats.posted.store(0, std::memory_order_relaxed);
+        stats.peak_depth.store(0, std::memory_order_relaxed);
+        stats.wait.reset();
+        stats.handler.reset();
+    }
+}
+
+void EventProfiler::dump() const
+{
+    LOG_INFO("event loop profile (times in us, pNN are bucket upper bounds):");
+    for (std::size_t i = 0; i < kNumTypes; ++i) {
+        const TypeStats& stats = stats_[i];
+        std::uint64_t count = stats.handler.count();
+        if (count == 0 && stats.posted.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+
+        const Histogram& wait = stats.wait;
+        std::uint64_t waited = wait.count();
+        LOG_INFO("%s: dispatched=%llu depth_peak=%llu"
+                 " wait avg=%llu p50=%llu p99=%llu max=%llu"
+                 " handler avg=%llu p50=%llu p99=%llu max=%llu",
+                 event_type_name(static_cast<EventType>(i)),
+                 static_cast<unsigned long long>(count),
+                 static_cast<unsigned long long>(stats.peak_depth.load(std::memory_order_relaxed)),
+                 static_cast<unsigned long long>(waited ? wait.total() / waited : 0),
+                 static_cast<unsigned long long>(wait.percentile(0.5)),
+                 static_cast<unsigned long long>(wait.percentile(0.99)),
+                 static_cast<unsigned long long>(wait.max()),
+                 static_cast<unsigned long long>(count ? stats.handler.total() / count : 0),
+                 static_cast<unsigned long long>(stats.handler.percentile(0.5)),
+                 static_cast<unsigned long long>(stats.handler.percentile(0.99)),
+                 static_cast<unsigned long long>(stats.handler.max()));
+    }
+}
+
+std::uint64_t EventProfiler::dispatched(EventType type) const
+{
+    auto index = static_cast<std::size_t>(type);
+    return index < kNumTypes ? stats_[index].handler.count() : 0;
+}
+
+std::uint64_t EventProfiler::peak_depth(EventType type) const
+{
+    auto index = static_cast<std::size_t>(type);
+    return index < kNumTypes ? stats_[index].peak_depth.load(std::memory_order_relaxed) : 0;
+}
+
+//
+// EventProfiler::Histogram
+//
+
+void EventProfiler::Histogram::add(std::uint64_t us)
+{
+    // bucket 0 holds [0, 1), bucket n holds [2^(n-1), 2^n)
+    std::size_t bucket = 0;
+    while (bucket + 1 < kBuckets && us >= (std::uint64_t(1) << bucket)) {
+        ++bucket;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    total_us_.fetch_add(us, std::memory_order_relaxed);
+    update_max(max_us_, us);
+}
+
+void EventProfiler::Histogram::reset()
+{
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total_us_.store(0, std::memory_order_relaxed);
+    max_us_.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t EventProfiler::Histogram::count() const
+{
+    std::uint64_t count = 0;
+    for (const auto& bucket : buckets_) {
+        count += bucket.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+std::uint64_t EventProfiler::Histogram::percentile(double fraction) const
+{
+    std::uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    auto wanted = static_cast<std::uint64_t>(static_cast<double>(total) * fraction);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen > wanted || seen == total) {
+            return std::uint64_t(1) << i;
+        }
+    }
+    return std::uint64_t(1) << (kBuckets - 1);
+}
+
+} // namespace inputleap
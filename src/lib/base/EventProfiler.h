@@ -0,0 +1,110 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "base/EventTypes.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace inputleap {
+
+//! Event loop profiler
+/*!
+Collects, for every event type, how long events waited between being posted
+and being dispatched, how long their handlers ran and how many events were
+queued when one was posted.  Times are kept in histograms with power-of-two
+microsecond buckets.  Recording is lock-free and may happen on any thread.
+
+EventQueue only uses this when built with INPUTLEAP_EVENT_PROFILER.
+*/
+class EventProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    //! Number of histogram buckets, the last one collects everything from ~2s up
+    static const std::size_t kBuckets = 23;
+
+    EventProfiler();
+    EventProfiler(const EventProfiler&) = delete;
+    EventProfiler& operator=(const EventProfiler&) = delete;
+
+    //! @name manipulators
+    //@{
+
+    //! Record that an event was queued while \p depth events were queued
+    void record_post(EventType type, std::size_t depth);
+
+    //! Record the dispatch of an event
+    /*!
+    \p posted is when the event was queued, or a default constructed time
+    point for events that did not pass through the queue (system events
+    and timers).  The handler ran from \p started to \p finished.
+    */
+    void record_dispatch(EventType type, Clock::time_point posted,
+                         Clock::time_point started, Clock::time_point finished);
+
+    //! Forget everything recorded so far
+    void reset();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Write a summary for every event type seen so far to the log
+    void dump() const;
+
+    //! Returns the number of dispatched events of \p type
+    std::uint64_t dispatched(EventType type) const;
+
+    //! Returns the highest queue depth seen when an event of \p type was posted
+    std::uint64_t peak_depth(EventType type) const;
+
+    //@}
+
+private:
+    class Histogram {
+    public:
+        void add(std::uint64_t us);
+        void reset();
+        std::uint64_t count() const;
+        std::uint64_t total() const { return total_us_.load(std::memory_order_relaxed); }
+        std::uint64_t max() const { return max_us_.load(std::memory_order_relaxed); }
+        // upper bound in microseconds of the bucket holding the given fraction
+        std::uint64_t percentile(double fraction) const;
+
+    private:
+        std::atomic<std::uint64_t> buckets_[kBuckets];
+        std::atomic<std::uint64_t> total_us_;
+        std::atomic<std::uint64_t> max_us_;
+    };
+
+    struct TypeStats {
+        std::atomic<std::uint64_t> posted;
+        std::atomic<std::uint64_t> peak_depth;
+        Histogram wait;
+        Histogram handler;
+    };
+
+    static const std::size_t kNumTypes = static_cast<std::size_t>(EventType::EVENT_COUNT);
+
+    TypeStats stats_[kNumTypes];
+};
+
+} // namespace inputleap
@@ -37,10 +37,24 @@ interrupt(Arch::ESignal, void* data)
     events->add_event(EventType::QUIT);
 }
 
+#if INPUTLEAP_EVENT_PROFILER
+// SIGUSR2 handler.  the profiler is lock-free so it's safe to dump it from
+// the signal handling thread.
+static
+void
+dump_profile(Arch::ESignal, void* data)
+{
+    static_cast<EventProfiler*>(data)->dump();
+}
+#endif
+
 EventQueue::EventQueue()
 {
     ARCH->setSignalHandler(Arch::kINTERRUPT, &interrupt, this);
     ARCH->setSignalHandler(Arch::kTERMINATE, &interrupt, this);
+#if INPUTLEAP_EVENT_PROFILER
+    ARCH->setSignalHandler(Arch::kUSER, &dump_profile, &profiler_);
+#endif
     buffer_ = std::make_unique<SimpleEventQueueBuffer>();
 }
 
@@ -48,6 +62,10 @@ EventQueue::~EventQueue()
 {
     ARCH->setSignalHandler(Arch::kINTERRUPT, nullptr, nullptr);
     ARCH->setSignalHandler(Arch::kTERMINATE, nullptr, nullptr);
+#if INPUTLEAP_EVENT_PROFILER
+    ARCH->setSignalHandler(Arch::kUSER, nullptr, nullptr);
+    profiler_.dump();
+#endif
 
     for (const auto& handlers : m_handlers) {
         handlers.first->event_queue_ = nullptr;
@@ -74,7 +92,13 @@ EventQueue::loop()
     Event event;
     getEvent(event);
     while (event.getType() != EventType::QUIT) {
+#if INPUTLEAP_EVENT_PROFILER
+        auto started = EventProfiler::Clock::now();
+        dispatchEvent(event);
+        profiler_.record_dispatch(event.getType(), posted_, started, EventProfiler::Clock::now());
+#else
         dispatchEvent(event);
+#endif
         Event::deleteData(event);
         getEvent(event);
     }
@@ -82,7 +106,8 @@ EventQueue::loop()
 
 void EventQueue::set_buffer(std::unique_ptr<IEventQueueBuffer> buffer)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::shared_timed_mutex> buffer_lock(buffer_mutex_);
+    std::lock_guard<std::mutex> lock(events_mutex_);
 
     LOG_DEBUG("adopting new buffer");
 
@@ -94,11 +119,7 @@ void EventQueue::set_buffer(std::unique_ptr<IEventQueueBuffer> buffer)
 
     // discard old buffer and old events
     buffer_.reset();
-    for (auto i = m_events.begin(); i != m_events.end(); ++i) {
-        Event::deleteData(i->second);
-    }
-    m_events.clear();
-    m_oldEventIDs.clear();
+    m_events.clear([](const SavedEvent& saved) { Event::deleteData(saved.event); });
 
     // use new buffer
     buffer_ = std::move(buffer);
@@ -111,6 +132,9 @@ bool
 EventQueue::getEvent(Event& event, double timeout)
 {
     Stopwatch timer(true);
+#if INPUTLEAP_EVENT_PROFILER
+    posted_ = EventProfiler::Clock::time_point();
+#endif
 retry:
     // if no events are waiting then handle timers and then wait
     while (buffer_->isEmpty()) {
@@ -155,10 +179,17 @@ retry:
 
     case IEventQueueBuffer::kUser:
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            event = removeEvent(dataID);
-            return true;
+            SavedEvent saved;
+            {
+                std::lock_guard<std::mutex> lock(events_mutex_);
+                saved = removeEvent(dataID);
+            }
+            event = std::move(saved.event);
+#if INPUTLEAP_EVENT_PROFILER
+            posted_ = saved.posted;
+#endif
         }
+        return true;
 
     default:
         assert(0 && "invalid event type");
@@ -211,16 +242,27 @@ void EventQueue::add_event(Event&& event)
 
 void EventQueue::add_event_to_buffer(Event&& event)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    // only set_buffer() excludes posting threads.  they share this lock and
+    // hold events_mutex_ just to store the event, so they don't wait for
+    // each other or for the dispatching thread in the buffer.
+    std::shared_lock<std::shared_timed_mutex> buffer_lock(buffer_mutex_);
 
     // store the event's data locally
-    std::uint32_t eventID = save_event(std::move(event));
+    std::uint32_t eventID;
+    {
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        eventID = save_event(std::move(event));
+    }
 
     // add it
     if (!buffer_->addEvent(eventID)) {
         // failed to send event
-        auto removed_event = removeEvent(eventID);
-        Event::deleteData(removed_event);
+        SavedEvent removed;
+        {
+            std::lock_guard<std::mutex> lock(events_mutex_);
+            removed = removeEvent(eventID);
+        }
+        Event::deleteData(removed.event);
     }
 }
 
@@ -347,39 +389,20 @@ std::shared_ptr<EventQueue::EventHandler>
 
 std::uint32_t EventQueue::save_event(Event&& event)
 {
-    // choose id
-    std::uint32_t id;
-    if (!m_oldEventIDs.empty()) {
-        // reuse an id
-        id = m_oldEventIDs.back();
-        m_oldEventIDs.pop_back();
-    }
-    else {
-        // make a new id
-        id = static_cast<std::uint32_t>(m_events.size());
-    }
-
-    // save data
-    m_events[id] = std::move(event);
-    return id;
+    SavedEvent saved;
+#if INPUTLEAP_EVENT_PROFILER
+    saved.posted = EventProfiler::Clock::now();
+    profiler_.record_post(event.getType(), m_events.size());
+#endif
+    saved.event = std::move(event);
+    return m_events.insert(std::move(saved));
 }
 
-Event EventQueue::removeEvent(std::uint32_t eventID)
+EventQueue::SavedEvent EventQueue::removeEvent(std::uint32_t eventID)
 {
-    // look up id
-    auto index = m_events.find(eventID);
-    if (index == m_events.end()) {
-        return Event();
-    }
-
-    // get data
-    Event event = std::move(index->second);
-    m_events.erase(index);
-
-    // save old id for reuse
-    m_oldEventIDs.push_back(eventID);
-
-    return event;
+    SavedEvent saved;
+    m_events.take(eventID, saved);
+    return saved;
 }
 
 bool
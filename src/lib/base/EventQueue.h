@@ -22,7 +22,9 @@
 #include "EventTarget.h"
 #include "base/IEventQueue.h"
 #include "base/Event.h"
+#include "base/EventProfiler.h"
 #include "base/PriorityQueue.h"
+#include "base/SlotMap.h"
 #include "base/Stopwatch.h"
 
 #include <condition_variable>
@@ -31,6 +33,7 @@
 #include <mutex>
 #include <queue>
 #include <set>
+#include <shared_mutex>
 
 namespace inputleap {
 
@@ -38,6 +41,15 @@ namespace inputleap {
 /*!
 An event queue that implements the platform independent parts and
 delegates the platform dependent parts to a subclass.
+
+Events are dispatched in the order they were added.  Clipboard and file
+transfers don't get a lower priority class:  ClipboardStreamer and
+FileStreamer only produce the next chunk once the connection has drained,
+so a transfer has at most one event queued ahead of input at any time.
+
+When built with INPUTLEAP_EVENT_PROFILER, the queue records per event type
+queue wait and handler times in an EventProfiler.  The profile is written
+to the log on SIGUSR2 and when the queue is destroyed.
 */
 class EventQueue : public IEventQueue {
 public:
@@ -61,8 +73,17 @@ public:
     void waitForReady() const override;
 
 private:
+    // an event that was posted but not dispatched yet
+    struct SavedEvent {
+        Event event;
+#if INPUTLEAP_EVENT_PROFILER
+        EventProfiler::Clock::time_point posted;
+#endif
+    };
+
+    // events_mutex_ must be locked
     std::uint32_t save_event(Event&& event);
-    Event removeEvent(std::uint32_t eventID);
+    SavedEvent removeEvent(std::uint32_t eventID);
     bool hasTimerExpired(Event& event);
     double getNextTimerTimeout() const;
     void add_event_to_buffer(Event&& event);
@@ -96,20 +117,27 @@ private:
 
     typedef std::set<EventQueueTimer*> Timers;
     typedef PriorityQueue<Timer> TimerQueue;
-    typedef std::map<std::uint32_t, Event> EventTable;
-    typedef std::vector<std::uint32_t> EventIDList;
+    typedef SlotMap<SavedEvent> EventTable;
     using TypeHandlerTable = std::map<EventType, std::shared_ptr<EventHandler>>;
     using HandlerTable = std::map<const EventTarget*, TypeHandlerTable>;
 
     EventTarget system_target_;
     mutable std::mutex mutex_;
 
-    // buffer of events
+    // buffer of events.  posting threads hold buffer_mutex_ shared, only
+    // set_buffer() takes it exclusively.
+    std::shared_timed_mutex buffer_mutex_;
     std::unique_ptr<IEventQueueBuffer> buffer_;
 
-    // saved events
+    // saved events, guarded by events_mutex_
+    std::mutex events_mutex_;
     EventTable m_events;
-    EventIDList m_oldEventIDs;
+
+#if INPUTLEAP_EVENT_PROFILER
+    EventProfiler profiler_;
+    // when the event last returned by getEvent() was posted
+    EventProfiler::Clock::time_point posted_;
+#endif
 
     // timers
     Stopwatch m_time;
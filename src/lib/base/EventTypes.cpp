@@ -0,0 +1,99 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/EventTypes.h"
+
+namespace inputleap {
+
+const char* event_type_name(EventType type)
+{
+    switch (type) {
+    case EventType::UNKNOWN: return "UNKNOWN";
+    case EventType::QUIT: return "QUIT";
+    case EventType::SYSTEM: return "SYSTEM";
+    case EventType::TIMER: return "TIMER";
+    case EventType::CLIENT_CONNECTED: return "CLIENT_CONNECTED";
+    case EventType::CLIENT_CONNECTION_FAILED: return "CLIENT_CONNECTION_FAILED";
+    case EventType::CLIENT_DISCONNECTED: return "CLIENT_DISCONNECTED";
+    case EventType::STREAM_INPUT_READY: return "STREAM_INPUT_READY";
+    case EventType::STREAM_OUTPUT_FLUSHED: return "STREAM_OUTPUT_FLUSHED";
+    case EventType::STREAM_OUTPUT_ERROR: return "STREAM_OUTPUT_ERROR";
+    case EventType::STREAM_INPUT_SHUTDOWN: return "STREAM_INPUT_SHUTDOWN";
+    case EventType::STREAM_OUTPUT_SHUTDOWN: return "STREAM_OUTPUT_SHUTDOWN";
+    case EventType::STREAM_INPUT_FORMAT_ERROR: return "STREAM_INPUT_FORMAT_ERROR";
+    case EventType::IPC_CLIENT_CONNECTED: return "IPC_CLIENT_CONNECTED";
+    case EventType::IPC_CLIENT_MESSAGE_RECEIVED: return "IPC_CLIENT_MESSAGE_RECEIVED";
+    case EventType::IPC_CLIENT_PROXY_MESSAGE_RECEIVED: return "IPC_CLIENT_PROXY_MESSAGE_RECEIVED";
+    case EventType::IPC_CLIENT_PROXY_DISCONNECTED: return "IPC_CLIENT_PROXY_DISCONNECTED";
+    case EventType::IPC_SERVER_CLIENT_CONNECTED: return "IPC_SERVER_CLIENT_CONNECTED";
+    case EventType::IPC_SERVER_MESSAGE_RECEIVED: return "IPC_SERVER_MESSAGE_RECEIVED";
+    case EventType::IPC_SERVER_PROXY_MESSAGE_RECEIVED: return "IPC_SERVER_PROXY_MESSAGE_RECEIVED";
+    case EventType::DATA_SOCKET_CONNECTED: return "DATA_SOCKET_CONNECTED";
+    case EventType::DATA_SOCKET_SECURE_CONNECTED: return "DATA_SOCKET_SECURE_CONNECTED";
+    case EventType::DATA_SOCKET_CONNECTION_FAILED: return "DATA_SOCKET_CONNECTION_FAILED";
+    case EventType::LISTEN_SOCKET_CONNECTING: return "LISTEN_SOCKET_CONNECTING";
+    case EventType::SOCKET_DISCONNECTED: return "SOCKET_DISCONNECTED";
+    case EventType::SOCKET_STOP_RETRY: return "SOCKET_STOP_RETRY";
+    case EventType::OSX_SCREEN_CONFIRM_SLEEP: return "OSX_SCREEN_CONFIRM_SLEEP";
+    case EventType::EI_SCREEN_CONNECTED_TO_EIS: return "EI_SCREEN_CONNECTED_TO_EIS";
+    case EventType::EI_SESSION_CLOSED: return "EI_SESSION_CLOSED";
+    case EventType::CLIENT_LISTENER_ACCEPTED: return "CLIENT_LISTENER_ACCEPTED";
+    case EventType::CLIENT_LISTENER_CONNECTED: return "CLIENT_LISTENER_CONNECTED";
+    case EventType::CLIENT_PROXY_READY: return "CLIENT_PROXY_READY";
+    case EventType::CLIENT_PROXY_DISCONNECTED: return "CLIENT_PROXY_DISCONNECTED";
+    case EventType::CLIENT_PROXY_UNKNOWN_SUCCESS: return "CLIENT_PROXY_UNKNOWN_SUCCESS";
+    case EventType::CLIENT_PROXY_UNKNOWN_FAILURE: return "CLIENT_PROXY_UNKNOWN_FAILURE";
+    case EventType::SERVER_ERROR: return "SERVER_ERROR";
+    case EventType::SERVER_CONNECTED: return "SERVER_CONNECTED";
+    case EventType::SERVER_DISCONNECTED: return "SERVER_DISCONNECTED";
+    case EventType::SERVER_SWITCH_TO_SCREEN: return "SERVER_SWITCH_TO_SCREEN";
+    case EventType::SERVER_TOGGLE_SCREEN: return "SERVER_TOGGLE_SCREEN";
+    case EventType::SERVER_SWITCH_INDIRECTION: return "SERVER_SWITCH_INDIRECTION";
+    case EventType::SERVER_KEYBOARD_BROADCAST: return "SERVER_KEYBOARD_BROADCAST";
+    case EventType::SERVER_LOCK_CURSOR_TO_SCREEN: return "SERVER_LOCK_CURSOR_TO_SCREEN";
+    case EventType::SERVER_SCREEN_SWITCHED: return "SERVER_SCREEN_SWITCHED";
+    case EventType::SERVER_APP_RELOAD_CONFIG: return "SERVER_APP_RELOAD_CONFIG";
+    case EventType::SERVER_APP_FORCE_RECONNECT: return "SERVER_APP_FORCE_RECONNECT";
+    case EventType::SERVER_APP_RESET_SERVER: return "SERVER_APP_RESET_SERVER";
+    case EventType::KEY_STATE_KEY_DOWN: return "KEY_STATE_KEY_DOWN";
+    case EventType::KEY_STATE_KEY_UP: return "KEY_STATE_KEY_UP";
+    case EventType::KEY_STATE_KEY_REPEAT: return "KEY_STATE_KEY_REPEAT";
+    case EventType::PRIMARY_SCREEN_BUTTON_DOWN: return "PRIMARY_SCREEN_BUTTON_DOWN";
+    case EventType::PRIMARY_SCREEN_BUTTON_UP: return "PRIMARY_SCREEN_BUTTON_UP";
+    case EventType::PRIMARY_SCREEN_MOTION_ON_PRIMARY: return "PRIMARY_SCREEN_MOTION_ON_PRIMARY";
+    case EventType::PRIMARY_SCREEN_MOTION_ON_SECONDARY: return "PRIMARY_SCREEN_MOTION_ON_SECONDARY";
+    case EventType::PRIMARY_SCREEN_WHEEL: return "PRIMARY_SCREEN_WHEEL";
+    case EventType::PRIMARY_SCREEN_SAVER_ACTIVATED: return "PRIMARY_SCREEN_SAVER_ACTIVATED";
+    case EventType::PRIMARY_SCREEN_SAVER_DEACTIVATED: return "PRIMARY_SCREEN_SAVER_DEACTIVATED";
+    case EventType::PRIMARY_SCREEN_HOTKEY_DOWN: return "PRIMARY_SCREEN_HOTKEY_DOWN";
+    case EventType::PRIMARY_SCREEN_HOTKEY_UP: return "PRIMARY_SCREEN_HOTKEY_UP";
+    case EventType::PRIMARY_SCREEN_FAKE_INPUT_BEGIN: return "PRIMARY_SCREEN_FAKE_INPUT_BEGIN";
+    case EventType::PRIMARY_SCREEN_FAKE_INPUT_END: return "PRIMARY_SCREEN_FAKE_INPUT_END";
+    case EventType::SCREEN_ERROR: return "SCREEN_ERROR";
+    case EventType::SCREEN_SHAPE_CHANGED: return "SCREEN_SHAPE_CHANGED";
+    case EventType::SCREEN_SUSPEND: return "SCREEN_SUSPEND";
+    case EventType::SCREEN_RESUME: return "SCREEN_RESUME";
+    case EventType::CLIPBOARD_GRABBED: return "CLIPBOARD_GRABBED";
+    case EventType::CLIPBOARD_CHANGED: return "CLIPBOARD_CHANGED";
+    case EventType::CLIPBOARD_DATA_REQUESTED: return "CLIPBOARD_DATA_REQUESTED";
+    case EventType::FILE_CHUNK_SENDING: return "FILE_CHUNK_SENDING";
+    case EventType::FILE_RECEIVE_COMPLETED: return "FILE_RECEIVE_COMPLETED";
+    default: return "INVALID";
+    }
+}
+
+} // namespace inputleap
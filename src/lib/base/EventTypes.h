@@ -271,20 +271,23 @@ enum class EventType : std::uint32_t {
     */
     CLIPBOARD_CHANGED,
 
-    /// This event is sent whenever a clipboard chunk is transferred.
-    CLIPBOARD_SENDING,
+    /** This event is sent when something wants the data of a clipboard that was offered
+        without it, see IPlatformScreen::offer_clipboard().  The data an instance of a
+        ClipboardInfo.
+    */
+    CLIPBOARD_DATA_REQUESTED,
 
-    /// This event is sent whenever a file chunk is transferred.
+    /// This event is sent when a FileStreamer read a chunk of the file it's sending.
     FILE_CHUNK_SENDING,
 
     /// This event is sent whenever file has been received.
     FILE_RECEIVE_COMPLETED,
 
-    /// This event is a keepalive event.
-    FILE_KEEPALIVE,
-
     /// The total number of known event types.
     EVENT_COUNT,
 };
 
+/// Returns the name of the enumerator, for use in diagnostics
+const char* event_type_name(EventType type);
+
 } // namespace inputleap
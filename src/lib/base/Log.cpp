@@ -19,13 +19,20 @@
 #include "arch/Arch.h"
 #include "arch/XArch.h"
 #include "base/Log.h"
+#include "base/BinaryLog.h"
 #include "base/log_outputters.h"
+#include "base/MpscRing.h"
 #include "common/Version.h"
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <ctime>
+#include <memory>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace inputleap {
@@ -48,6 +55,19 @@ static const char*        g_priority[] = {
 // number of priorities
 static const int g_numPriority = static_cast<int>(sizeof(g_priority) / sizeof(g_priority[0]));
 
+// names of categories, as accepted by set_category_filters()
+static const char*        g_category[kNumLogCategories] = {
+    "general",
+    "net",
+    "protocol",
+    "server",
+    "client",
+    "x11",
+    "keys",
+    "clipboard",
+    "ipc"
+};
+
 // the default priority
 #ifndef NDEBUG
 static const int        g_defaultMaxPriority = kDEBUG;
@@ -55,6 +75,169 @@ static const int        g_defaultMaxPriority = kDEBUG;
 static const int        g_defaultMaxPriority = kINFO;
 #endif
 
+// longest formatted message, including the terminating nul
+static const std::size_t g_maxMessageLength = 2048;
+
+// number of messages the asynchronous writer can hold
+static const std::size_t g_asyncCapacity = 256;
+
+// writes the time and priority prefix into buffer and returns its length,
+// or -1 on error
+static int print_prefix(char* buffer, std::size_t size, ELevel priority)
+{
+    struct tm *tm;
+    time_t t;
+    time(&t);
+    tm = localtime(&t);
+
+    return std::snprintf(buffer, size, "[%04i-%02i-%02iT%02i:%02i:%02i] %s: ",
+                         tm->tm_year + 1900, tm->tm_mon+1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec,
+                         g_priority[priority]);
+}
+
+//
+// Log::AsyncWriter
+//
+
+/*
+Formatted messages are copied into a lock-free ring by the logging threads
+and written to the outputters by a single writer thread.  The writer sleeps
+on a condition variable when the ring is empty; producers only take the
+mutex to wake it when it announced that it is going to sleep.
+*/
+class Log::AsyncWriter {
+public:
+    explicit AsyncWriter(Log* log) :
+        log_(log)
+    {
+        thread_ = ARCH->newThread([this]() { run(); });
+    }
+
+    ~AsyncWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            wake_cv_.notify_one();
+        }
+        ARCH->wait(thread_, -1.0);
+        ARCH->closeThread(thread_);
+    }
+
+    void push(ELevel priority, const char* msg)
+    {
+        std::size_t length = std::strlen(msg);
+        if (length >= g_maxMessageLength) {
+            length = g_maxMessageLength - 1;
+        }
+
+        bool pushed = ring_.try_push_with([&](Record& record) {
+            record.priority = priority;
+            std::memcpy(record.message, msg, length);
+            record.message[length] = '\0';
+        });
+        if (!pushed) {
+            log_->m_droppedMessages.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        enqueued_.fetch_add(1, std::memory_order_release);
+
+        // pairs with the fence in run() so that either we see the writer
+        // sleeping or the writer sees our message
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (writer_sleeping_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_cv_.notify_one();
+        }
+    }
+
+    void flush()
+    {
+        // the writer can't wait for itself, e.g. when an outputter logs
+        if (std::this_thread::get_id() == writer_id_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::uint64_t target = enqueued_.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_cv_.notify_one();
+        flushed_cv_.wait(lock, [this, target]() {
+            return written_.load(std::memory_order_acquire) >= target;
+        });
+    }
+
+private:
+    struct Record {
+        ELevel priority;
+        char message[g_maxMessageLength];
+    };
+
+    void run()
+    {
+        writer_id_.store(std::this_thread::get_id(), std::memory_order_release);
+
+        for (;;) {
+            std::uint64_t written = 0;
+            while (ring_.try_pop_with([this](Record& record) {
+                       log_->output(record.priority, record.message);
+                   })) {
+                ++written;
+            }
+            report_dropped();
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (written != 0) {
+                written_.fetch_add(written, std::memory_order_release);
+                flushed_cv_.notify_all();
+            }
+            if (stopping_ && ring_.empty()) {
+                break;
+            }
+
+            writer_sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ring_.empty() && !stopping_) {
+                wake_cv_.wait_for(lock, std::chrono::milliseconds(100));
+            }
+            writer_sleeping_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void report_dropped()
+    {
+        std::uint64_t dropped = log_->m_droppedMessages.load(std::memory_order_relaxed);
+        if (dropped == reported_dropped_) {
+            return;
+        }
+
+        char buffer[128];
+        int offset = print_prefix(buffer, sizeof(buffer), kWARNING);
+        if (offset < 0) {
+            offset = 0;
+        }
+        std::snprintf(buffer + offset, sizeof(buffer) - offset,
+                      "%llu log messages were dropped",
+                      static_cast<unsigned long long>(dropped - reported_dropped_));
+        reported_dropped_ = dropped;
+        log_->output(kWARNING, buffer);
+    }
+
+    Log* log_;
+    MpscRing<Record> ring_{g_asyncCapacity};
+    ArchThread thread_ = nullptr;
+    std::atomic<std::thread::id> writer_id_{};
+
+    std::atomic<std::uint64_t> enqueued_{0};
+    std::atomic<std::uint64_t> written_{0};
+    std::uint64_t reported_dropped_ = 0;
+
+    std::atomic<bool> writer_sleeping_{false};
+    bool stopping_ = false;
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable flushed_cv_;
+};
+
 //
 // Log
 //
@@ -67,6 +250,9 @@ Log::Log()
 
     // other initialization
     m_maxPriority = g_defaultMaxPriority;
+    for (auto& filter : m_categoryFilter) {
+        filter.store(g_defaultMaxPriority, std::memory_order_relaxed);
+    }
     insert(new ConsoleLogOutputter);
 
     s_log = this;
@@ -79,6 +265,10 @@ Log::Log(Log* src)
 
 Log::~Log()
 {
+    // write pending messages before the outputters go away
+    set_async(false);
+    set_binary_log(nullptr);
+
     // clean up
     for (auto index= m_outputters.begin(); index != m_outputters.end(); ++index) {
         delete *index;
@@ -113,27 +303,31 @@ Log::getFilterName(int level) const
 void
 Log::print(ELevel priority, const char* file, int line, const char* fmt, ...)
 {
-    // done if below priority threshold
-    if (priority > getFilter()) {
-        return;
+    // debug messages are only recorded, other messages are also formatted
+    BinaryLogWriter* binary = m_binary.load(std::memory_order_acquire);
+    if (binary != nullptr) {
+        va_list args;
+        va_start(args, fmt);
+        binary->record(priority, file, line, fmt, args);
+        va_end(args);
+
+        if (priority >= kDEBUG) {
+            return;
+        }
+        if (priority == kFATAL) {
+            binary->flush();
+        }
     }
 
-    std::vector<char> buffer(2048);
+    char buffer[g_maxMessageLength];
     int offset = 0;
-    size_t remaining = buffer.size();
+    size_t remaining = sizeof(buffer);
     int n;
 
     // print the prefix to the buffer
     // do not prefix time and file for kPRINT (CLOG_PRINT)
     if (priority != kPRINT) {
-        struct tm *tm;
-        time_t t;
-        time(&t);
-        tm = localtime(&t);
-
-        offset = std::snprintf(buffer.data(), remaining, "[%04i-%02i-%02iT%02i:%02i:%02i] %s: ",
-                               tm->tm_year + 1900, tm->tm_mon+1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec,
-                               g_priority[priority]);
+        offset = print_prefix(buffer, remaining, priority);
         if (offset == -1) {
             output(kERROR, "Failed to print to log");
             return;
@@ -145,21 +339,80 @@ Log::print(ELevel priority, const char* file, int line, const char* fmt, ...)
     // now print our actual message
     va_list args;
     va_start(args, fmt);
-    n = std::vsnprintf(buffer.data() + offset, remaining, fmt, args);
+    n = std::vsnprintf(buffer + offset, remaining, fmt, args);
     va_end(args);
     if (n == -1) {
         output(kERROR, "Failed to print to log (invalid arguments)");
         return;
     }
 
-    remaining -= n;
-    offset += n;
-
 #ifndef NDEBUG
-    n = std::snprintf(buffer.data() + offset, remaining - offset, "\n\t%s,%d", file, line);
+    // skip the location if the message was truncated
+    if (static_cast<size_t>(n) < remaining) {
+        std::snprintf(buffer + offset + n, remaining - n, "\n\t%s,%d", file, line);
+    }
 #endif
 
-    output(priority, buffer.data());
+    AsyncWriter* async = m_async.load(std::memory_order_acquire);
+    if (async != nullptr) {
+        if (priority != kFATAL) {
+            async->push(priority, buffer);
+            return;
+        }
+
+        // write everything logged before the fatal message, then the
+        // message itself, before the caller gets to exit
+        async->flush();
+    }
+    output(priority, buffer);
+}
+
+void
+Log::set_async(bool enable)
+{
+    if (enable) {
+        if (m_async.load(std::memory_order_acquire) == nullptr) {
+            m_async.store(new AsyncWriter(this), std::memory_order_release);
+        }
+    }
+    else {
+        delete m_async.exchange(nullptr, std::memory_order_acq_rel);
+    }
+}
+
+bool
+Log::set_binary_log(const char* path)
+{
+    delete m_binary.exchange(nullptr, std::memory_order_acq_rel);
+    if (path == nullptr) {
+        return true;
+    }
+
+    std::unique_ptr<BinaryLogWriter> binary(new BinaryLogWriter(path));
+    if (!binary->is_open()) {
+        return false;
+    }
+    m_binary.store(binary.release(), std::memory_order_release);
+    return true;
+}
+
+void
+Log::flush()
+{
+    AsyncWriter* async = m_async.load(std::memory_order_acquire);
+    if (async != nullptr) {
+        async->flush();
+    }
+    BinaryLogWriter* binary = m_binary.load(std::memory_order_acquire);
+    if (binary != nullptr) {
+        binary->flush();
+    }
+}
+
+std::uint64_t
+Log::dropped_messages() const
+{
+    return m_droppedMessages.load(std::memory_order_relaxed);
 }
 
 void
@@ -190,6 +443,9 @@ Log::insert(ILogOutputter* outputter, bool alwaysAtHead)
 void
 Log::remove(ILogOutputter* outputter)
 {
+    // let the outputter see everything logged while it was installed
+    flush();
+
     std::lock_guard<std::mutex> lock(m_mutex);
     m_outputters.remove(outputter);
     m_alwaysOutputters.remove(outputter);
@@ -198,6 +454,8 @@ Log::remove(ILogOutputter* outputter)
 void
 Log::pop_front(bool alwaysAtHead)
 {
+    flush();
+
     std::lock_guard<std::mutex> lock(m_mutex);
     OutputterList* list = alwaysAtHead ? &m_alwaysOutputters : &m_outputters;
     if (!list->empty()) {
@@ -224,15 +482,107 @@ Log::setFilter(const char* maxPriority)
 void
 Log::setFilter(int maxPriority)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_maxPriority = maxPriority;
+    std::lock_guard<std::mutex> lock(m_filterMutex);
+    m_maxPriority.store(maxPriority, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kNumLogCategories; ++i) {
+        if (!m_categoryOverride[i]) {
+            m_categoryFilter[i].store(maxPriority, std::memory_order_relaxed);
+        }
+    }
+}
+
+void
+Log::set_category_filter(LogCategory category, int level)
+{
+    auto index = static_cast<std::size_t>(category);
+    std::lock_guard<std::mutex> lock(m_filterMutex);
+    m_categoryOverride[index] = true;
+    m_categoryFilter[index].store(level, std::memory_order_relaxed);
+}
+
+void
+Log::clear_category_filter(LogCategory category)
+{
+    auto index = static_cast<std::size_t>(category);
+    std::lock_guard<std::mutex> lock(m_filterMutex);
+    m_categoryOverride[index] = false;
+    m_categoryFilter[index].store(m_maxPriority.load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+}
+
+bool
+Log::set_category_filters(const std::string& spec)
+{
+    if (spec.empty()) {
+        for (std::size_t category = 0; category < kNumLogCategories; ++category) {
+            clear_category_filter(static_cast<LogCategory>(category));
+        }
+        return true;
+    }
+
+    // parse everything first so that a bad entry changes nothing
+    std::vector<std::pair<LogCategory, int>> filters;
+    std::size_t start = 0;
+    while (start <= spec.size()) {
+        std::size_t end = spec.find(',', start);
+        if (end == std::string::npos) {
+            end = spec.size();
+        }
+        std::string entry = spec.substr(start, end - start);
+        start = end + 1;
+
+        std::size_t equals = entry.find('=');
+        if (equals == std::string::npos) {
+            return false;
+        }
+        std::string name = entry.substr(0, equals);
+        std::string level = entry.substr(equals + 1);
+
+        std::size_t category = 0;
+        while (category < kNumLogCategories && name != g_category[category]) {
+            ++category;
+        }
+        if (category == kNumLogCategories) {
+            return false;
+        }
+
+        // -1 marks a filter that is cleared
+        int priority = 0;
+        if (level == "default") {
+            priority = -1;
+        } else {
+            while (priority < g_numPriority && level != g_priority[priority]) {
+                ++priority;
+            }
+            if (priority == g_numPriority) {
+                return false;
+            }
+        }
+        filters.emplace_back(static_cast<LogCategory>(category), priority);
+    }
+
+    for (const auto& filter : filters) {
+        if (filter.second < 0) {
+            clear_category_filter(filter.first);
+        } else {
+            set_category_filter(filter.first, filter.second);
+        }
+    }
+    return true;
+}
+
+const char*
+Log::category_name(LogCategory category)
+{
+    return g_category[static_cast<std::size_t>(category)];
 }
 
 int
 Log::getFilter() const
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_maxPriority;
+    // read without m_mutex so that filtered messages never wait for an
+    // outputter that is busy writing
+    return m_maxPriority.load(std::memory_order_relaxed);
 }
 
 void
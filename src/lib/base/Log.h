@@ -24,22 +24,59 @@
 #include "common/common.h"
 
 #include <stdarg.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <list>
 #include <mutex>
+#include <string>
 
 #define CLOG (Log::getInstance())
 #define BYE "\nTry `%s --help' for more information."
 
 namespace inputleap {
 
+class BinaryLogWriter;
 class Thread;
 
+//! Log categories
+/*!
+Subsystems whose messages can be filtered separately.  A translation unit
+puts its messages in a category by defining \c INPUTLEAP_LOG_CATEGORY to
+one of the enumerants before including any header, e.g.
+\code
+#define INPUTLEAP_LOG_CATEGORY NET
+\endcode
+Everything else is in \c GENERAL.
+*/
+enum class LogCategory {
+    GENERAL,
+    NET,
+    PROTOCOL,
+    SERVER,
+    CLIENT,
+    X11,
+    KEYS,
+    CLIPBOARD,
+    IPC,
+};
+
+//! Number of log categories
+constexpr std::size_t kNumLogCategories = 9;
+
 //! Logging facility
 /*!
 The logging class;  all console output should go through this class.
 It supports multithread safe operation, several message priority levels,
 filtering by priority, and output redirection.  The macros LOG_DEBUG(),
 LOG_INFO() etc. provide convenient access.
+
+In asynchronous mode (see \c set_async()) messages are formatted on the
+caller's thread and handed to a background thread that writes them to
+the outputters, so slow outputters do not block the caller.
+
+With a binary log (see \c set_binary_log()) debug messages are not
+formatted at all but recorded in a compact form that is decoded later.
 */
 class Log {
 public:
@@ -94,8 +131,62 @@ public:
     bool setFilter(const char* name);
 
     //! Set the minimum priority filter (by ordinal).
+    /*!
+    Also applies to every category without a filter of its own.
+    */
     void setFilter(int);
 
+    //! Set the filter of a category
+    /*!
+    Messages in \p category below \p level are discarded, regardless of
+    the global filter.
+    */
+    void set_category_filter(LogCategory category, int level);
+
+    //! Make a category follow the global filter again
+    void clear_category_filter(LogCategory category);
+
+    //! Set category filters from a string
+    /*!
+    Parses a comma separated list of \c category=level pairs such as
+    \c "net=DEBUG2,x11=INFO" and applies it.  Category names are the
+    lower case enumerant names; the level may also be \c default to
+    clear the filter of the category.  An empty \p spec clears the filters
+    of all categories.  Returns false and changes nothing if \p spec is
+    malformed.
+    */
+    bool set_category_filters(const std::string& spec);
+
+    //! Enable or disable asynchronous output
+    /*!
+    When enabled, messages are copied into a bounded ring and written to
+    the outputters by a background thread.  Messages that do not fit in
+    the ring are dropped and counted; the writer reports the count.
+    FATAL messages flush the ring and are written synchronously.
+    Disabling flushes pending messages and stops the writer.  Enabling
+    creates a thread, so on unix it must happen after daemonizing.  Must
+    not be called while other threads may be logging.
+    */
+    void set_async(bool enable);
+
+    //! Record messages to a binary log
+    /*!
+    Creates \p path and records every message that passes the filter to
+    it without formatting (see BinaryLogWriter).  DEBUG and more verbose
+    messages go only to the binary log; more important messages are also
+    written to the outputters as usual.  A nullptr \p path closes the
+    binary log.  Returns false if \p path could not be created.  Must not
+    be called while other threads may be logging.
+    */
+    bool set_binary_log(const char* path);
+
+    //! Write pending messages
+    /*!
+    In asynchronous mode, waits until every message queued before the
+    call has been written.  Also writes buffered binary log records.
+    */
+    void flush();
+
     //@}
     //! @name accessors
     //@{
@@ -104,7 +195,8 @@ public:
     /*!
     Print a log message using the printf-like \c format and arguments
     preceded by the filename and line number.  If \c file is nullptr then
-    neither the file nor the line are printed.
+    neither the file nor the line are printed.  The message is not
+    filtered; the LOG_* macros check \c is_enabled() first.
     */
     INPUTLEAP_ATTRIBUTE_PRINTF(5, 6)
     void print(ELevel priority,
@@ -114,6 +206,21 @@ public:
     //! Get the minimum priority level.
     int getFilter() const;
 
+    //! Get the filter that applies to a category
+    int get_category_filter(LogCategory category) const
+    {
+        return m_categoryFilter[static_cast<std::size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    //! Returns true if a message would pass the filter of its category
+    bool is_enabled(LogCategory category, int priority) const
+    {
+        return priority <= get_category_filter(category);
+    }
+
+    //! Get the name of a category
+    static const char* category_name(LogCategory category);
+
     //! Get the filter name of the current filter level.
     const char* getFilterName() const;
 
@@ -126,9 +233,17 @@ public:
     //! Get the console filter level (messages above this are not sent to console).
     int getConsoleMaxLevel() const { return kDEBUG2; }
 
+    //! Returns true if asynchronous output is enabled
+    bool is_async() const { return m_async.load(std::memory_order_acquire) != nullptr; }
+
+    //! Get the number of messages dropped because the async ring was full
+    std::uint64_t dropped_messages() const;
+
     //@}
 
 private:
+    class AsyncWriter;
+
     void output(ELevel priority, const char* msg);
 
 private:
@@ -139,7 +254,17 @@ private:
     mutable std::mutex m_mutex;
     OutputterList m_outputters;
     OutputterList m_alwaysOutputters;
-    int m_maxPriority;
+    std::atomic<int> m_maxPriority;
+
+    // effective filter of every category, and whether it was set
+    // explicitly.  guarded by m_filterMutex for writing.
+    std::mutex m_filterMutex;
+    std::atomic<int> m_categoryFilter[kNumLogCategories];
+    bool m_categoryOverride[kNumLogCategories] = {};
+
+    std::atomic<AsyncWriter*> m_async{nullptr};
+    std::atomic<BinaryLogWriter*> m_binary{nullptr};
+    std::atomic<std::uint64_t> m_droppedMessages{0};
 };
 
 /*!
@@ -154,17 +279,27 @@ replaced by one of enumerants in \c Log::ELevel without the leading
 not be filtered and is never prefixed by the filename and line number.
 
 If \c NOLOGGING is defined during the build then this macro expands to
-nothing.  If \c NDEBUG is defined during the build then it expands to a
-call to Log::print.  Otherwise it expands to a call to Log::printt,
-which includes the filename and line number.
+nothing.  Otherwise it checks the filter of the translation unit's
+category (see LogCategory) and, if the message passes, calls Log::print.
+Unless \c NDEBUG is defined, the filename and line number are included.
 */
 
+#ifndef INPUTLEAP_LOG_CATEGORY
+#define INPUTLEAP_LOG_CATEGORY GENERAL
+#endif
+
 #if defined(NOLOGGING)
 #define LOG(...) do { } while(0)
 #elif defined(NDEBUG)
-#define LOG(pri_, ...) CLOG->print(pri_, nullptr, 0, __VA_ARGS__)
+#define LOG(pri_, ...) do { \
+    if (CLOG->is_enabled(LogCategory::INPUTLEAP_LOG_CATEGORY, pri_)) { \
+        CLOG->print(pri_, nullptr, 0, __VA_ARGS__); \
+    } } while (0)
 #else
-#define LOG(pri_, ...) CLOG->print(pri_, __FILE__, __LINE__, __VA_ARGS__)
+#define LOG(pri_, ...) do { \
+    if (CLOG->is_enabled(LogCategory::INPUTLEAP_LOG_CATEGORY, pri_)) { \
+        CLOG->print(pri_, __FILE__, __LINE__, __VA_ARGS__); \
+    } } while (0)
 #endif
 
 // the CLOG_* defines %z and an octal number (060=0, 071=9),
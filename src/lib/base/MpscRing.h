@@ -0,0 +1,164 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace inputleap {
+
+//! Bounded lock-free multi-producer single-consumer ring
+/*!
+Any number of threads may call \c try_push() concurrently; only one thread
+may call \c try_pop().  Every cell carries a sequence number that tells
+producers and the consumer whether the cell is free or filled for the
+current lap, so neither side takes a lock.  \p T must be cheap to copy
+unless it is only accessed in place through \c try_push_with() and
+\c try_pop_with().
+*/
+template<class T>
+class MpscRing {
+public:
+    //! Create a ring holding up to \p capacity elements, rounded up to a power of two
+    explicit MpscRing(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    //! @name manipulators
+    //@{
+
+    //! Add element
+    /*!
+    Appends \p value and returns true, or returns false if the ring is full.
+    */
+    bool try_push(const T& value)
+    {
+        return try_push_with([&value](T& cell) { cell = value; });
+    }
+
+    //! Add element in place
+    /*!
+    Claims a free cell and calls \p fill with a reference to it, then
+    publishes the cell.  Returns false without calling \p fill if the ring
+    is full.  The consumer waits for the cell while \p fill runs, so
+    \p fill should be short.
+    */
+    template<class Fn>
+    bool try_push_with(Fn fill)
+    {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(cell.value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+                // another producer claimed the cell first; pos was reloaded
+                contended_.fetch_add(1, std::memory_order_relaxed);
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //! Remove head element
+    /*!
+    Stores the oldest element in \p value and returns true, or returns
+    false if the ring is empty.  Must only be called from the consumer.
+    */
+    bool try_pop(T& value)
+    {
+        return try_pop_with([&value](T& cell) { value = cell; });
+    }
+
+    //! Remove head element in place
+    /*!
+    Calls \p consume with a reference to the oldest element and then frees
+    its cell.  Returns false without calling \p consume if the ring is
+    empty.  Must only be called from the consumer.
+    */
+    template<class Fn>
+    bool try_pop_with(Fn consume)
+    {
+        Cell& cell = cells_[head_ & mask_];
+        std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq != head_ + 1) {
+            return false;
+        }
+        consume(cell.value);
+        cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Returns true if the consumer would find no element
+    /*!
+    Must only be called from the consumer.
+    */
+    bool empty() const
+    {
+        return cells_[head_ & mask_].sequence.load(std::memory_order_acquire) != head_ + 1;
+    }
+
+    //! Returns the number of elements the ring can hold
+    std::size_t capacity() const { return mask_ + 1; }
+
+    //! Returns how often a producer lost a race for a cell
+    std::uint64_t contended() const { return contended_.load(std::memory_order_relaxed); }
+
+    //@}
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_ = 0;
+
+    std::atomic<std::size_t> tail_{0};
+    std::atomic<std::uint64_t> contended_{0};
+    std::size_t head_ = 0;
+};
+
+} // namespace inputleap
@@ -18,26 +18,39 @@
 
 #include "EventQueueTimer.h"
 #include "base/SimpleEventQueueBuffer.h"
+#include "base/Log.h"
 #include "base/Stopwatch.h"
 #include "arch/Arch.h"
 
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#endif
+
 namespace inputleap {
 
-SimpleEventQueueBuffer::SimpleEventQueueBuffer()
+SimpleEventQueueBuffer::SimpleEventQueueBuffer() :
+    ring_(kRingCapacity)
 {
-    m_queueReady     = false;
 }
 
 SimpleEventQueueBuffer::~SimpleEventQueueBuffer()
 {
+    Stats stats = get_stats();
+    LOG_DEBUG1("event queue buffer: %llu contended, %llu overflowed, %llu sleeps, %llu wakes",
+               static_cast<unsigned long long>(stats.contended),
+               static_cast<unsigned long long>(stats.overflowed),
+               static_cast<unsigned long long>(stats.sleeps),
+               static_cast<unsigned long long>(stats.wakes));
 }
 
 void
 SimpleEventQueueBuffer::waitForEvent(double timeout)
 {
-    std::unique_lock<std::mutex> lock(queue_mutex_);
     Stopwatch timer(true);
-    while (!m_queueReady) {
+    while (isEmpty()) {
         double timeLeft = timeout;
         if (timeLeft >= 0.0) {
             timeLeft -= timer.getTime();
@@ -45,38 +58,120 @@ SimpleEventQueueBuffer::waitForEvent(double timeout)
                 return;
             }
         }
-        ARCH->wait_cond_var(queue_ready_cv_, lock, timeLeft);
+        sleep_consumer(timeLeft);
     }
 }
 
 IEventQueueBuffer::Type SimpleEventQueueBuffer::getEvent(Event&, std::uint32_t& dataID)
 {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    if (!m_queueReady) {
+    if (ring_.try_pop(dataID)) {
+        return kUser;
+    }
+    if (!overflowing_.load(std::memory_order_acquire)) {
         return kNone;
     }
-    dataID = m_queue.back();
-    m_queue.pop_back();
-    m_queueReady = !m_queue.empty();
+
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    if (overflow_.empty()) {
+        overflowing_.store(false, std::memory_order_release);
+        return kNone;
+    }
+    dataID = overflow_.front();
+    overflow_.pop_front();
+    if (overflow_.empty()) {
+        overflowing_.store(false, std::memory_order_release);
+    }
     return kUser;
 }
 
 bool SimpleEventQueueBuffer::addEvent(std::uint32_t dataID)
 {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    m_queue.push_front(dataID);
-    if (!m_queueReady) {
-        m_queueReady = true;
-        queue_ready_cv_.notify_all();
+    if (overflowing_.load(std::memory_order_acquire) || !ring_.try_push(dataID)) {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        if (overflowing_.load(std::memory_order_relaxed) || !ring_.try_push(dataID)) {
+            overflow_.push_back(dataID);
+            overflowing_.store(true, std::memory_order_release);
+            overflowed_.fetch_add(1, std::memory_order_relaxed);
+        }
     }
+    wake_consumer();
     return true;
 }
 
 bool
 SimpleEventQueueBuffer::isEmpty() const
 {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    return !m_queueReady;
+    return ring_.empty() && !overflowing_.load(std::memory_order_acquire);
+}
+
+SimpleEventQueueBuffer::Stats SimpleEventQueueBuffer::get_stats() const
+{
+    Stats stats;
+    stats.contended = ring_.contended();
+    stats.overflowed = overflowed_.load(std::memory_order_relaxed);
+    stats.sleeps = sleeps_.load(std::memory_order_relaxed);
+    stats.wakes = wakes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SimpleEventQueueBuffer::sleep_consumer(double timeout)
+{
+    // like IArchMultithread::wait_cond_var(), wake up periodically so that
+    // thread cancellation is noticed
+    static const double maxCancellationLatency = 0.1;
+    if (timeout < 0.0 || timeout > maxCancellationLatency) {
+        timeout = maxCancellationLatency;
+    }
+
+    ARCH->testCancelThread();
+
+    std::uint32_t seq = wake_seq_.load(std::memory_order_acquire);
+    consumer_sleeping_.store(true, std::memory_order_relaxed);
+    // pairs with the fence in wake_consumer(): either we see the new event
+    // or the producer sees that we are sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (isEmpty()) {
+        sleeps_.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(timeout);
+        ts.tv_nsec = static_cast<long>((timeout - static_cast<double>(ts.tv_sec)) * 1.0e9);
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&wake_seq_), FUTEX_WAIT_PRIVATE,
+                seq, &ts, nullptr, 0);
+#else
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, seconds_to_chrono(timeout), [this, seq]() {
+            return wake_seq_.load(std::memory_order_acquire) != seq;
+        });
+#endif
+    }
+
+    consumer_sleeping_.store(false, std::memory_order_relaxed);
+
+    ARCH->testCancelThread();
+}
+
+void SimpleEventQueueBuffer::wake_consumer()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!consumer_sleeping_.load(std::memory_order_relaxed) ||
+        !consumer_sleeping_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    wakes_.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+    wake_seq_.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&wake_seq_), FUTEX_WAKE_PRIVATE,
+            1, nullptr, nullptr, 0);
+#else
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_seq_.fetch_add(1, std::memory_order_release);
+    }
+    wake_cv_.notify_one();
+#endif
 }
 
 } // namespace inputleap
@@ -19,20 +19,33 @@
 #pragma once
 
 #include "base/IEventQueueBuffer.h"
-#include "arch/IArchMultithread.h"
+#include "base/MpscRing.h"
+#include <atomic>
 #include <condition_variable>
 #include <deque>
+#include <mutex>
 
 namespace inputleap {
 
 //! In-memory event queue buffer
 /*!
 An event queue buffer provides a queue of events for an IEventQueue.
+Producers post into a lock-free ring and only wake the consumer when it
+is actually blocked in \c waitForEvent().  If the ring fills up, events
+spill into a locked overflow list so that none are dropped.
 */
 class SimpleEventQueueBuffer : public IEventQueueBuffer {
 public:
+    //! Counters describing producer and consumer activity
+    struct Stats {
+        std::uint64_t contended = 0;  //!< Producers that lost a race for a ring cell
+        std::uint64_t overflowed = 0; //!< Events that did not fit into the ring
+        std::uint64_t sleeps = 0;     //!< Times the consumer blocked
+        std::uint64_t wakes = 0;      //!< Times a producer woke the consumer
+    };
+
     SimpleEventQueueBuffer();
-    ~SimpleEventQueueBuffer();
+    ~SimpleEventQueueBuffer() override;
 
     // IEventQueueBuffer overrides
     void init() override { }
@@ -41,13 +54,35 @@ public:
     bool addEvent(std::uint32_t dataID) override;
     bool isEmpty() const override;
 
+    //! Get activity counters
+    Stats get_stats() const;
+
 private:
-    typedef std::deque<std::uint32_t> EventDeque;
+    void sleep_consumer(double timeout);
+    void wake_consumer();
+
+    static const std::size_t kRingCapacity = 1024;
+
+    MpscRing<std::uint32_t> ring_;
+
+    // events that did not fit into the ring.  while this is non-empty all
+    // producers append here so that events from one thread stay in order.
+    mutable std::mutex overflow_mutex_;
+    std::deque<std::uint32_t> overflow_;
+    std::atomic<bool> overflowing_{false};
+
+    // the consumer publishes that it is about to block and producers only
+    // bump wake_seq_ and wake it up if that flag is set
+    std::atomic<bool> consumer_sleeping_{false};
+    std::atomic<std::uint32_t> wake_seq_{0};
+#if !defined(__linux__)
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+#endif
 
-    mutable std::mutex queue_mutex_;
-    std::condition_variable queue_ready_cv_;
-    bool m_queueReady;
-    EventDeque m_queue;
+    std::atomic<std::uint64_t> overflowed_{0};
+    std::atomic<std::uint64_t> sleeps_{0};
+    std::atomic<std::uint64_t> wakes_{0};
 };
 
 } // namespace inputleap
@@ -0,0 +1,168 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace inputleap {
+
+//! Contiguous storage addressed by generational IDs
+/*!
+Values are kept in a vector of slots and addressed by a 32-bit ID that
+packs the slot index in the low bits and the generation of the slot in
+the high bits.  Insertion and removal are O(1) and do not allocate once
+the slot vector has grown to the peak number of live values.  Every
+removal bumps the generation of the slot, so an ID that was already
+removed is not confused with a later value stored in the same slot.
+
+Only kGenerationBits of the generation fit in the ID, so a stale ID
+matches again after the slot has been reused 256 times.  IDs must not be
+held on to for that long;  the event queue, which passes them through
+the 32-bit data of its buffers, only keeps them until the event is
+dispatched.
+*/
+template<class T>
+class SlotMap {
+public:
+    using Id = std::uint32_t;
+
+    static constexpr unsigned kIndexBits = 24;
+    static constexpr unsigned kGenerationBits = 32 - kIndexBits;
+    static constexpr Id kIndexMask = (Id(1) << kIndexBits) - 1;
+    static constexpr std::size_t kMaxSlots = std::size_t(1) << kIndexBits;
+
+    //! @name manipulators
+    //@{
+
+    //! Store value
+    /*!
+    Stores \p value and returns the ID under which it can be taken back.
+    Throws std::length_error if all slots are in use.
+    */
+    Id insert(T&& value)
+    {
+        std::uint32_t index;
+        if (!free_.empty()) {
+            index = free_.back();
+            free_.pop_back();
+        } else {
+            if (slots_.size() >= kMaxSlots) {
+                throw std::length_error("SlotMap is full");
+            }
+            index = static_cast<std::uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+
+        Slot& slot = slots_[index];
+        slot.value = std::move(value);
+        slot.used = true;
+        ++size_;
+        return make_id(index, slot.generation);
+    }
+
+    //! Remove value
+    /*!
+    Moves the value stored under \p id into \p value and frees its slot.
+    Returns false and leaves \p value untouched if \p id is unknown or
+    was already removed.
+    */
+    bool take(Id id, T& value)
+    {
+        std::uint32_t index = id & kIndexMask;
+        if (!contains(id)) {
+            return false;
+        }
+
+        Slot& slot = slots_[index];
+        value = std::move(slot.value);
+        slot.value = T();
+        slot.used = false;
+        ++slot.generation;
+        free_.push_back(index);
+        --size_;
+        return true;
+    }
+
+    //! Remove all values
+    /*!
+    Calls \p fn with each stored value and then frees every slot.  Slot
+    storage is kept so that later insertions do not allocate again.
+    */
+    template<class Fn>
+    void clear(Fn fn)
+    {
+        free_.clear();
+        for (std::size_t i = slots_.size(); i-- > 0;) {
+            Slot& slot = slots_[i];
+            if (slot.used) {
+                fn(slot.value);
+                slot.value = T();
+                slot.used = false;
+                ++slot.generation;
+            }
+            free_.push_back(static_cast<std::uint32_t>(i));
+        }
+        size_ = 0;
+    }
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Test for a live ID
+    /*!
+    Returns false for an ID that was removed, unless its slot has since
+    been reused a multiple of 2^kGenerationBits times.
+    */
+    bool contains(Id id) const
+    {
+        std::uint32_t index = id & kIndexMask;
+        return index < slots_.size() && slots_[index].used &&
+               make_id(index, slots_[index].generation) == id;
+    }
+
+    //! Returns the number of stored values
+    std::size_t size() const { return size_; }
+
+    //! Returns true if no values are stored
+    bool empty() const { return size_ == 0; }
+
+    //@}
+
+private:
+    struct Slot {
+        T value{};
+        std::uint32_t generation = 0;
+        bool used = false;
+    };
+
+    static Id make_id(std::uint32_t index, std::uint32_t generation)
+    {
+        return (generation << kIndexBits) | index;
+    }
+
+    std::vector<Slot> slots_;
+    std::vector<std::uint32_t> free_;
+    std::size_t size_ = 0;
+};
+
+} // namespace inputleap
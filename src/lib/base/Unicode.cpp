@@ -18,7 +18,9 @@
 
 #include "arch/Arch.h"
 #include "base/Unicode.h"
+#include "base/UnicodeSimd.h"
 
+#include <algorithm>
 #include <climits>
 #include <cstring>
 
@@ -42,9 +44,95 @@ EWideCharEncoding get_wide_char_encoding()
 #endif
 }
 
+// stages converted text in a block on the stack and appends the block to
+// dst whenever it fills up, so dst can be sized with reserve() up front
+// and is never zero filled.  writers keep their own output pointer, get
+// room for the next step with room() and cut bulk steps to run().
+class OutputBlocks {
+public:
+    explicit OutputBlocks(std::string& dst) : dst_(dst) {}
+    OutputBlocks(const OutputBlocks&) = delete;
+    OutputBlocks& operator=(const OutputBlocks&) = delete;
+
+    std::uint8_t* begin() { return block_; }
+
+    // returns where to continue writing, with room for a bulk step
+    std::uint8_t* room(std::uint8_t* out)
+    {
+        if (space(out) < kRoom) {
+            flush(out);
+            return block_;
+        }
+        return out;
+    }
+
+    // characters of unit bytes that a bulk step may write at out, leaving
+    // room for one more character of up to kChar bytes after it
+    std::size_t run(const std::uint8_t* out, std::size_t unit) const
+    {
+        return (space(out) - kChar) / unit;
+    }
+
+    // appends what was written up to out
+    void finish(const std::uint8_t* out) { flush(out); }
+
+private:
+    static const std::size_t kChar = 8;
+    static const std::size_t kRoom = 256;
+
+    std::size_t space(const std::uint8_t* out) const
+    {
+        return static_cast<std::size_t>(block_ + sizeof(block_) - out);
+    }
+
+    void flush(const std::uint8_t* out)
+    {
+        dst_.append(reinterpret_cast<const char*>(block_),
+                    static_cast<std::size_t>(out - block_));
+    }
+
+    std::string& dst_;
+    std::uint8_t block_[8192];
+};
+
+void put16(std::uint8_t*& dst, std::uint32_t c)
+{
+    std::uint16_t c16 = static_cast<std::uint16_t>(c);
+    std::memcpy(dst, &c16, 2);
+    dst += 2;
+}
+
+void put32(std::uint8_t*& dst, std::uint32_t c)
+{
+    std::memcpy(dst, &c, 4);
+    dst += 4;
+}
+
+// write a character of unit (1 or 2) bytes
+void put_unit(std::uint8_t*& dst, std::size_t unit, std::uint32_t c)
+{
+    if (unit == 1) {
+        *dst++ = static_cast<std::uint8_t>(c);
+    }
+    else {
+        put16(dst, c);
+    }
+}
+
+void put_newline(std::uint8_t*& dst, std::size_t unit, Unicode::Newline newline)
+{
+    if (newline != Unicode::Newline::LF) {
+        put_unit(dst, unit, '\r');
+    }
+    if (newline != Unicode::Newline::CR) {
+        put_unit(dst, unit, '\n');
+    }
+}
 
 } // namespace
 
+using namespace inputleap;
+
 inline static std::uint16_t decode16(const std::uint8_t* n, bool byteSwapped)
 {
     union x16 {
@@ -103,6 +191,146 @@ setError(bool* errors)
     }
 }
 
+// the sizes below are exact for well formed input.  malformed input can
+// convert to a little more, which the output then grows to hold.  runs
+// of ASCII are skipped in bulk, the narrowing ones into a scratch block.
+static const std::size_t kScratch = 1024;
+
+// number of characters in UTF-8, counting those outside the BMP twice
+// when they become surrogate pairs.  counts the bytes other than
+// 10xxxxxx, and with pairs 11110xxx once more, 8 bytes at a time.
+static std::size_t utf8_chars(const std::uint8_t* data, std::size_t n, bool pairs)
+{
+    const std::uint64_t high  = 0x8080808080808080u;
+    const std::uint64_t lanes = 0x0101010101010101u;
+    std::size_t chars = n;
+    while (n >= 8) {
+        std::uint64_t w;
+        std::memcpy(&w, data, 8);
+        if ((w & high) == 0) {
+            // skip longer runs of ASCII in bulk
+            std::size_t ascii = (n >= 64 && (data[63] & 0x80) == 0) ?
+                                    unicode_simd::ascii_prefix(data, n) : 8;
+            data += ascii;
+            n    -= ascii;
+            continue;
+        }
+        std::uint64_t more = w & ~(w << 1) & high;
+        chars -= static_cast<std::size_t>(((more >> 7) * lanes) >> 56);
+        if (pairs) {
+            std::uint64_t four = w & (w << 1) & (w << 2) & (w << 3) & high;
+            chars += static_cast<std::size_t>(((four >> 7) * lanes) >> 56);
+        }
+        data += 8;
+        n    -= 8;
+    }
+    for (; n > 0; ++data, --n) {
+        if ((*data & 0xc0) == 0x80) {
+            --chars;
+        }
+        else if (pairs && *data >= 0xf0) {
+            ++chars;
+        }
+    }
+    return chars;
+}
+
+// bytes of UTF-8 for n 16 bit characters.  with pairs a surrogate pair
+// makes one character.
+static std::size_t utf8_size16(const std::uint8_t* data, std::size_t n,
+                               bool byteSwapped, bool pairs)
+{
+    std::uint8_t scratch[kScratch];
+    std::size_t size = 0;
+    while (n > 0) {
+        if (!byteSwapped) {
+            std::size_t m = std::min(n, kScratch);
+            std::size_t ascii = unicode_simd::narrow_ascii16(data, m, scratch);
+            size += ascii;
+            data += 2 * ascii;
+            n    -= ascii;
+            if (n == 0 || ascii == m) {
+                continue;
+            }
+        }
+        std::uint32_t c = decode16(data, byteSwapped);
+        if (pairs && c >= 0x0000dc00 && c <= 0x0000dfff) {
+            // the rest of the 4 bytes for the pair
+            size += 1;
+        }
+        else {
+            size += 1 + (c >= 0x00000080) + (c >= 0x00000800);
+        }
+        data += 2;
+        --n;
+    }
+    return size;
+}
+
+// bytes of UTF-8 for n 32 bit characters, those from limit up replaced
+static std::size_t utf8_size32(const std::uint8_t* data, std::size_t n,
+                               bool byteSwapped, std::uint32_t limit)
+{
+    std::uint8_t scratch[kScratch];
+    std::size_t size = 0;
+    while (n > 0) {
+        if (!byteSwapped) {
+            std::size_t m = std::min(n, kScratch);
+            std::size_t ascii = unicode_simd::narrow_ascii32(data, m, scratch);
+            size += ascii;
+            data += 4 * ascii;
+            n    -= ascii;
+            if (n == 0 || ascii == m) {
+                continue;
+            }
+        }
+        std::uint32_t c = decode32(data, byteSwapped);
+        if (c >= limit || (c >= 0x0000d800 && c <= 0x0000dfff)) {
+            c = 0x0000fffd;
+        }
+        size += 1 + (c >= 0x00000080) + (c >= 0x00000800) + (c >= 0x00010000) +
+                (c >= 0x00200000) + (c >= 0x04000000);
+        data += 4;
+        --n;
+    }
+    return size;
+}
+
+// change in the number of characters when every line ending (CR LF, CR
+// or LF) among n characters of unit (1 or 2) bytes becomes newline
+static std::ptrdiff_t line_ending_change(const std::uint8_t* data, std::size_t n,
+                                         std::size_t unit, bool byteSwapped,
+                                         Unicode::Newline newline)
+{
+    const std::ptrdiff_t size = (newline == Unicode::Newline::CRLF) ? 2 : 1;
+    std::uint8_t scratch[kScratch];
+    std::ptrdiff_t change = 0;
+    while (n > 0) {
+        if (unit == 1 || !byteSwapped) {
+            std::size_t m = std::min(n, kScratch);
+            std::size_t plain = (unit == 1) ? unicode_simd::copy_plain(data, m, scratch) :
+                                              unicode_simd::narrow_plain16(data, m, scratch);
+            data += unit * plain;
+            n    -= plain;
+            if (n == 0 || plain == m) {
+                continue;
+            }
+        }
+        std::uint32_t c = (unit == 1) ? *data : decode16(data, byteSwapped);
+        data += unit;
+        --n;
+        if (c == '\r' && n > 0 && ((unit == 1) ? *data : decode16(data, byteSwapped)) == '\n') {
+            change += size - 2;
+            data += unit;
+            --n;
+        }
+        else if (c == '\r' || c == '\n') {
+            change += size - 1;
+        }
+    }
+    return change;
+}
+
 
 //
 // Unicode
@@ -113,9 +341,15 @@ std::uint32_t Unicode::s_replacement = 0x0000fffd;
 
 bool Unicode::isUTF8(const std::string& src)
 {
-    // convert and test each character
+    // skip runs of ASCII in bulk and test each other character
     const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     for (std::size_t n = src.size(); n > 0; ) {
+        if (*data < 0x80) {
+            std::size_t ascii = unicode_simd::ascii_prefix(data, n);
+            data += ascii;
+            n    -= ascii;
+            continue;
+        }
         if (fromUTF8(data, n) == s_invalid) {
             return false;
         }
@@ -128,14 +362,24 @@ std::string Unicode::UTF8ToUCS2(const std::string& src, bool* errors)
     // default to success
     resetError(errors);
 
-    // get size of input string and reserve some space in output
     std::size_t n = src.size();
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     std::string dst;
-    dst.reserve(2 * n);
+    dst.reserve(2 * utf8_chars(data, n, false));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
 
-    // convert each character
-    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
+    // convert runs of ASCII in bulk and each other character alone
     while (n > 0) {
+        out = output.room(out);
+        if (*data < 0x80) {
+            std::size_t m = std::min(n, output.run(out, 2));
+            std::size_t ascii = unicode_simd::widen_ascii16(data, m, out);
+            data += ascii;
+            n    -= ascii;
+            out  += 2 * ascii;
+            continue;
+        }
         std::uint32_t c = fromUTF8(data, n);
         if (c == s_invalid) {
             c = s_replacement;
@@ -144,10 +388,10 @@ std::string Unicode::UTF8ToUCS2(const std::string& src, bool* errors)
             setError(errors);
             c = s_replacement;
         }
-        std::uint16_t ucs2 = static_cast<std::uint16_t>(c);
-        dst.append(reinterpret_cast<const char*>(&ucs2), 2);
+        put16(out, c);
     }
 
+    output.finish(out);
     return dst;
 }
 
@@ -157,21 +401,32 @@ Unicode::UTF8ToUCS4(const std::string& src, bool* errors)
     // default to success
     resetError(errors);
 
-    // get size of input string and reserve some space in output
     std::size_t n = src.size();
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     std::string dst;
-    dst.reserve(4 * n);
+    dst.reserve(4 * utf8_chars(data, n, false));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
 
-    // convert each character
-    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
+    // convert runs of ASCII in bulk and each other character alone
     while (n > 0) {
+        out = output.room(out);
+        if (*data < 0x80) {
+            std::size_t m = std::min(n, output.run(out, 4));
+            std::size_t ascii = unicode_simd::widen_ascii32(data, m, out);
+            data += ascii;
+            n    -= ascii;
+            out  += 4 * ascii;
+            continue;
+        }
         std::uint32_t c = fromUTF8(data, n);
         if (c == s_invalid) {
             c = s_replacement;
         }
-        dst.append(reinterpret_cast<const char*>(&c), 4);
+        put32(out, c);
     }
 
+    output.finish(out);
     return dst;
 }
 
@@ -181,14 +436,24 @@ Unicode::UTF8ToUTF16(const std::string& src, bool* errors)
     // default to success
     resetError(errors);
 
-    // get size of input string and reserve some space in output
     std::size_t n = src.size();
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     std::string dst;
-    dst.reserve(2 * n);
+    dst.reserve(2 * utf8_chars(data, n, true));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
 
-    // convert each character
-    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
+    // convert runs of ASCII in bulk and each other character alone
     while (n > 0) {
+        out = output.room(out);
+        if (*data < 0x80) {
+            std::size_t m = std::min(n, output.run(out, 2));
+            std::size_t ascii = unicode_simd::widen_ascii16(data, m, out);
+            data += ascii;
+            n    -= ascii;
+            out  += 2 * ascii;
+            continue;
+        }
         std::uint32_t c = fromUTF8(data, n);
         if (c == s_invalid) {
             c = s_replacement;
@@ -198,18 +463,16 @@ Unicode::UTF8ToUTF16(const std::string& src, bool* errors)
             c = s_replacement;
         }
         if (c < 0x00010000) {
-            std::uint16_t ucs2 = static_cast<std::uint16_t>(c);
-            dst.append(reinterpret_cast<const char*>(&ucs2), 2);
+            put16(out, c);
         }
         else {
             c -= 0x00010000;
-            std::uint16_t utf16h = static_cast<std::uint16_t>((c >> 10) + 0xd800);
-            std::uint16_t utf16l = static_cast<std::uint16_t>((c & 0x03ff) + 0xdc00);
-            dst.append(reinterpret_cast<const char*>(&utf16h), 2);
-            dst.append(reinterpret_cast<const char*>(&utf16l), 2);
+            put16(out, (c >> 10) + 0xd800);
+            put16(out, (c & 0x03ff) + 0xdc00);
         }
     }
 
+    output.finish(out);
     return dst;
 }
 
@@ -219,14 +482,24 @@ Unicode::UTF8ToUTF32(const std::string& src, bool* errors)
     // default to success
     resetError(errors);
 
-    // get size of input string and reserve some space in output
     std::size_t n = src.size();
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     std::string dst;
-    dst.reserve(4 * n);
+    dst.reserve(4 * utf8_chars(data, n, false));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
 
-    // convert each character
-    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
+    // convert runs of ASCII in bulk and each other character alone
     while (n > 0) {
+        out = output.room(out);
+        if (*data < 0x80) {
+            std::size_t m = std::min(n, output.run(out, 4));
+            std::size_t ascii = unicode_simd::widen_ascii32(data, m, out);
+            data += ascii;
+            n    -= ascii;
+            out  += 4 * ascii;
+            continue;
+        }
         std::uint32_t c = fromUTF8(data, n);
         if (c == s_invalid) {
             c = s_replacement;
@@ -235,9 +508,10 @@ Unicode::UTF8ToUTF32(const std::string& src, bool* errors)
             setError(errors);
             c = s_replacement;
         }
-        dst.append(reinterpret_cast<const char*>(&c), 4);
+        put32(out, c);
     }
 
+    output.finish(out);
     return dst;
 }
 
@@ -395,6 +669,179 @@ Unicode::textToUTF8(const std::string& src, bool* errors)
     return utf8;
 }
 
+std::string Unicode::from_utf8_text(const std::string& src, TextEncoding encoding,
+                                    Newline newline, bool* errors)
+{
+    // default to success
+    resetError(errors);
+
+    // UTF-8 with Unix line endings usually needs no change at all
+    if (encoding == TextEncoding::UTF8 && newline == Newline::LF &&
+            std::memchr(src.data(), '\r', src.size()) == nullptr) {
+        return src;
+    }
+
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
+    std::size_t n = src.size();
+    const std::size_t unit = (encoding == TextEncoding::UTF8) ? 1 : 2;
+    std::size_t chars = (unit == 1) ? n : utf8_chars(data, n, encoding == TextEncoding::UTF16);
+    std::string dst;
+    dst.reserve(unit * (chars + line_ending_change(data, n, 1, false, newline)));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
+
+    while (n > 0) {
+        // copy runs of ASCII other than line endings in bulk
+        out = output.room(out);
+        std::size_t m = std::min(n, output.run(out, unit));
+        std::size_t plain = (unit == 1) ? unicode_simd::copy_plain(data, m, out) :
+                                          unicode_simd::widen_plain16(data, m, out);
+        data += plain;
+        n    -= plain;
+        out  += unit * plain;
+        if (n == 0) {
+            break;
+        }
+
+        if (*data == '\r' || *data == '\n') {
+            if (n > 1 && data[0] == '\r' && data[1] == '\n') {
+                ++data;
+                --n;
+            }
+            ++data;
+            --n;
+            put_newline(out, unit, newline);
+            continue;
+        }
+
+        if (encoding == TextEncoding::UTF8) {
+            // copy other bytes unchanged.  CR and LF never occur inside
+            // a multibyte sequence.
+            const std::uint8_t* end = out + output.run(out, 1);
+            do {
+                *out++ = *data++;
+                --n;
+            } while (n > 0 && *data >= 0x80 && out < end);
+            continue;
+        }
+
+        std::uint32_t c = fromUTF8(data, n);
+        if (c == s_invalid) {
+            c = s_replacement;
+        }
+        else if (c >= 0x00110000 ||
+                 (c >= 0x00010000 && encoding == TextEncoding::UCS2)) {
+            setError(errors);
+            c = s_replacement;
+        }
+        if (c < 0x00010000) {
+            put16(out, c);
+        }
+        else {
+            c -= 0x00010000;
+            put16(out, (c >> 10) + 0xd800);
+            put16(out, (c & 0x03ff) + 0xdc00);
+        }
+    }
+
+    output.finish(out);
+    return dst;
+}
+
+std::string Unicode::to_utf8_text(const std::string& src, TextEncoding encoding,
+                                  Newline newline, bool* errors)
+{
+    if (encoding == TextEncoding::UTF8) {
+        return from_utf8_text(src, encoding, newline, errors);
+    }
+
+    // default to success
+    resetError(errors);
+
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.data());
+    std::size_t n = src.size() >> 1;
+
+    // check if first character is 0xfffe or 0xfeff
+    bool byteSwapped = false;
+    if (n >= 1) {
+        switch (decode16(data, false)) {
+        case 0x0000feff:
+            data += 2;
+            --n;
+            break;
+
+        case 0x0000fffe:
+            byteSwapped = true;
+            data += 2;
+            --n;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    std::string dst;
+    dst.reserve(utf8_size16(data, n, byteSwapped, encoding == TextEncoding::UTF16) +
+                line_ending_change(data, n, 2, byteSwapped, newline));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
+
+    for (; n > 0; data += 2, --n) {
+        // convert runs of ASCII other than line endings in bulk
+        out = output.room(out);
+        if (!byteSwapped) {
+            std::size_t m = std::min(n, output.run(out, 1));
+            std::size_t plain = unicode_simd::narrow_plain16(data, m, out);
+            data += 2 * plain;
+            n    -= plain;
+            out  += plain;
+            if (n == 0) {
+                break;
+            }
+        }
+
+        std::uint32_t c = decode16(data, byteSwapped);
+        if (c == '\r' || c == '\n') {
+            if (c == '\r' && n > 1 && decode16(data + 2, byteSwapped) == '\n') {
+                data += 2;
+                --n;
+            }
+            put_newline(out, 1, newline);
+        }
+        else if (encoding == TextEncoding::UCS2 || c < 0x0000d800 || c > 0x0000dfff) {
+            out = toUTF8(out, c, errors);
+        }
+        else if (n == 1) {
+            // error -- missing second word
+            setError(errors);
+            out = toUTF8(out, s_replacement, nullptr);
+        }
+        else if (c <= 0x0000dbff) {
+            std::uint32_t c2 = decode16(data + 2, byteSwapped);
+            if (c2 < 0x0000dc00 || c2 > 0x0000dfff) {
+                // error -- [d800,dbff] not followed by [dc00,dfff]
+                setError(errors);
+                out = toUTF8(out, s_replacement, nullptr);
+            }
+            else {
+                c = (((c - 0x0000d800) << 10) | (c2 - 0x0000dc00)) + 0x00010000;
+                out = toUTF8(out, c, errors);
+            }
+            data += 2;
+            --n;
+        }
+        else {
+            // error -- [dc00,dfff] without leading [d800,dbff]
+            setError(errors);
+            out = toUTF8(out, s_replacement, nullptr);
+        }
+    }
+
+    output.finish(out);
+    return dst;
+}
+
 wchar_t* Unicode::UTF8ToWideChar(const std::string& src, std::uint32_t& size, bool* errors)
 {
     // convert to platform's wide character encoding
@@ -457,10 +904,6 @@ Unicode::wideCharToUTF8(const wchar_t* src, std::size_t size, bool* errors)
 
 std::string Unicode::doUCS2ToUTF8(const std::uint8_t* data, std::size_t n, bool* errors)
 {
-    // make some space
-    std::string dst;
-    dst.reserve(n);
-
     // check if first character is 0xfffe or 0xfeff
     bool byteSwapped = false;
     if (n >= 1) {
@@ -481,21 +924,36 @@ std::string Unicode::doUCS2ToUTF8(const std::uint8_t* data, std::size_t n, bool*
         }
     }
 
-    // convert each character
-    for (; n > 0; data += 2, --n) {
+    std::string dst;
+    dst.reserve(utf8_size16(data, n, byteSwapped, false));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
+
+    // convert runs of ASCII in bulk and each other character alone
+    while (n > 0) {
+        out = output.room(out);
+        if (!byteSwapped) {
+            std::size_t m = std::min(n, output.run(out, 1));
+            std::size_t ascii = unicode_simd::narrow_ascii16(data, m, out);
+            data += 2 * ascii;
+            n    -= ascii;
+            out  += ascii;
+            if (n == 0) {
+                break;
+            }
+        }
         std::uint32_t c = decode16(data, byteSwapped);
-        toUTF8(dst, c, errors);
+        out = toUTF8(out, c, errors);
+        data += 2;
+        --n;
     }
 
+    output.finish(out);
     return dst;
 }
 
 std::string Unicode::doUCS4ToUTF8(const std::uint8_t* data, std::size_t n, bool* errors)
 {
-    // make some space
-    std::string dst;
-    dst.reserve(n);
-
     // check if first character is 0xfffe or 0xfeff
     bool byteSwapped = false;
     if (n >= 1) {
@@ -516,21 +974,36 @@ std::string Unicode::doUCS4ToUTF8(const std::uint8_t* data, std::size_t n, bool*
         }
     }
 
-    // convert each character
-    for (; n > 0; data += 4, --n) {
+    std::string dst;
+    dst.reserve(utf8_size32(data, n, byteSwapped, 0x80000000));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
+
+    // convert runs of ASCII in bulk and each other character alone
+    while (n > 0) {
+        out = output.room(out);
+        if (!byteSwapped) {
+            std::size_t m = std::min(n, output.run(out, 1));
+            std::size_t ascii = unicode_simd::narrow_ascii32(data, m, out);
+            data += 4 * ascii;
+            n    -= ascii;
+            out  += ascii;
+            if (n == 0) {
+                break;
+            }
+        }
         std::uint32_t c = decode32(data, byteSwapped);
-        toUTF8(dst, c, errors);
+        out = toUTF8(out, c, errors);
+        data += 4;
+        --n;
     }
 
+    output.finish(out);
     return dst;
 }
 
 std::string Unicode::doUTF16ToUTF8(const std::uint8_t* data, std::size_t n, bool* errors)
 {
-    // make some space
-    std::string dst;
-    dst.reserve(n);
-
     // check if first character is 0xfffe or 0xfeff
     bool byteSwapped = false;
     if (n >= 1) {
@@ -551,16 +1024,32 @@ std::string Unicode::doUTF16ToUTF8(const std::uint8_t* data, std::size_t n, bool
         }
     }
 
-    // convert each character
+    std::string dst;
+    dst.reserve(utf8_size16(data, n, byteSwapped, true));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
+
+    // convert runs of ASCII in bulk and each other character alone
     for (; n > 0; data += 2, --n) {
+        out = output.room(out);
+        if (!byteSwapped) {
+            std::size_t m = std::min(n, output.run(out, 1));
+            std::size_t ascii = unicode_simd::narrow_ascii16(data, m, out);
+            data += 2 * ascii;
+            n    -= ascii;
+            out  += ascii;
+            if (n == 0) {
+                break;
+            }
+        }
         std::uint32_t c = decode16(data, byteSwapped);
         if (c < 0x0000d800 || c > 0x0000dfff) {
-            toUTF8(dst, c, errors);
+            out = toUTF8(out, c, errors);
         }
         else if (n == 1) {
             // error -- missing second word
             setError(errors);
-            toUTF8(dst, s_replacement, nullptr);
+            out = toUTF8(out, s_replacement, nullptr);
         }
         else if (c >= 0x0000d800 && c <= 0x0000dbff) {
             data += 2;
@@ -569,29 +1058,26 @@ std::string Unicode::doUTF16ToUTF8(const std::uint8_t* data, std::size_t n, bool
             if (c2 < 0x0000dc00 || c2 > 0x0000dfff) {
                 // error -- [d800,dbff] not followed by [dc00,dfff]
                 setError(errors);
-                toUTF8(dst, s_replacement, nullptr);
+                out = toUTF8(out, s_replacement, nullptr);
             }
             else {
                 c = (((c - 0x0000d800) << 10) | (c2 - 0x0000dc00)) + 0x00010000;
-                toUTF8(dst, c, errors);
+                out = toUTF8(out, c, errors);
             }
         }
         else {
             // error -- [dc00,dfff] without leading [d800,dbff]
             setError(errors);
-            toUTF8(dst, s_replacement, nullptr);
+            out = toUTF8(out, s_replacement, nullptr);
         }
     }
 
+    output.finish(out);
     return dst;
 }
 
 std::string Unicode::doUTF32ToUTF8(const std::uint8_t* data, std::size_t n, bool* errors)
 {
-    // make some space
-    std::string dst;
-    dst.reserve(n);
-
     // check if first character is 0xfffe or 0xfeff
     bool byteSwapped = false;
     if (n >= 1) {
@@ -612,16 +1098,35 @@ std::string Unicode::doUTF32ToUTF8(const std::uint8_t* data, std::size_t n, bool
         }
     }
 
-    // convert each character
-    for (; n > 0; data += 4, --n) {
+    std::string dst;
+    dst.reserve(utf8_size32(data, n, byteSwapped, 0x00110000));
+    OutputBlocks output(dst);
+    std::uint8_t* out = output.begin();
+
+    // convert runs of ASCII in bulk and each other character alone
+    while (n > 0) {
+        out = output.room(out);
+        if (!byteSwapped) {
+            std::size_t m = std::min(n, output.run(out, 1));
+            std::size_t ascii = unicode_simd::narrow_ascii32(data, m, out);
+            data += 4 * ascii;
+            n    -= ascii;
+            out  += ascii;
+            if (n == 0) {
+                break;
+            }
+        }
         std::uint32_t c = decode32(data, byteSwapped);
         if (c >= 0x00110000) {
             setError(errors);
             c = s_replacement;
         }
-        toUTF8(dst, c, errors);
+        out = toUTF8(out, c, errors);
+        data += 4;
+        --n;
     }
 
+    output.finish(out);
     return dst;
 }
 
@@ -801,10 +1306,8 @@ std::uint32_t Unicode::fromUTF8(const std::uint8_t*& data, std::size_t& n)
     return c;
 }
 
-void Unicode::toUTF8(std::string& dst, std::size_t c, bool* errors)
+std::uint8_t* Unicode::toUTF8(std::uint8_t* data, std::size_t c, bool* errors)
 {
-    std::uint8_t data[6];
-
     // handle characters outside the valid range
     if ((c >= 0x0000d800 && c <= 0x0000dfff) || c >= 0x80000000) {
         setError(errors);
@@ -814,25 +1317,25 @@ void Unicode::toUTF8(std::string& dst, std::size_t c, bool* errors)
     // convert to UTF-8
     if (c < 0x00000080) {
         data[0] = static_cast<std::uint8_t>(c);
-        dst.append(reinterpret_cast<char*>(data), 1);
+        return data + 1;
     }
     else if (c < 0x00000800) {
         data[0] = static_cast<std::uint8_t>(((c >>  6) & 0x0000001f) + 0xc0);
         data[1] = static_cast<std::uint8_t>((c         & 0x0000003f) + 0x80);
-        dst.append(reinterpret_cast<char*>(data), 2);
+        return data + 2;
     }
     else if (c < 0x00010000) {
         data[0] = static_cast<std::uint8_t>(((c >> 12) & 0x0000000f) + 0xe0);
         data[1] = static_cast<std::uint8_t>(((c >>  6) & 0x0000003f) + 0x80);
         data[2] = static_cast<std::uint8_t>((c         & 0x0000003f) + 0x80);
-        dst.append(reinterpret_cast<char*>(data), 3);
+        return data + 3;
     }
     else if (c < 0x00200000) {
         data[0] = static_cast<std::uint8_t>(((c >> 18) & 0x00000007) + 0xf0);
         data[1] = static_cast<std::uint8_t>(((c >> 12) & 0x0000003f) + 0x80);
         data[2] = static_cast<std::uint8_t>(((c >>  6) & 0x0000003f) + 0x80);
         data[3] = static_cast<std::uint8_t>((c         & 0x0000003f) + 0x80);
-        dst.append(reinterpret_cast<char*>(data), 4);
+        return data + 4;
     }
     else if (c < 0x04000000) {
         data[0] = static_cast<std::uint8_t>(((c >> 24) & 0x00000003) + 0xf8);
@@ -840,7 +1343,7 @@ void Unicode::toUTF8(std::string& dst, std::size_t c, bool* errors)
         data[2] = static_cast<std::uint8_t>(((c >> 12) & 0x0000003f) + 0x80);
         data[3] = static_cast<std::uint8_t>(((c >>  6) & 0x0000003f) + 0x80);
         data[4] = static_cast<std::uint8_t>((c         & 0x0000003f) + 0x80);
-        dst.append(reinterpret_cast<char*>(data), 5);
+        return data + 5;
     }
     else if (c < 0x80000000) {
         data[0] = static_cast<std::uint8_t>(((c >> 30) & 0x00000001) + 0xfc);
@@ -849,9 +1352,10 @@ void Unicode::toUTF8(std::string& dst, std::size_t c, bool* errors)
         data[3] = static_cast<std::uint8_t>(((c >> 12) & 0x0000003f) + 0x80);
         data[4] = static_cast<std::uint8_t>(((c >>  6) & 0x0000003f) + 0x80);
         data[5] = static_cast<std::uint8_t>((c         & 0x0000003f) + 0x80);
-        dst.append(reinterpret_cast<char*>(data), 6);
+        return data + 6;
     }
     else {
         assert(0 && "character out of range");
+        return data;
     }
 }
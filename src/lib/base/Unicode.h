@@ -28,6 +28,12 @@ encodings and the current locale encoding.
 */
 class Unicode {
 public:
+    //! Encodings handled by the text conversions
+    enum class TextEncoding { UTF8, UCS2, UTF16 };
+
+    //! Line ending conventions
+    enum class Newline { LF, CRLF, CR };
+
     //! @name accessors
     //@{
 
@@ -113,6 +119,25 @@ public:
     */
     static std::string textToUTF8(const std::string&, bool* errors = nullptr);
 
+    //! Convert UTF-8 text, normalizing line endings
+    /*!
+    Converts UTF-8 \p src to \p encoding and replaces every line ending
+    (CR LF, CR or LF) with \p newline while converting.  UTF-8 output
+    keeps all other bytes unchanged.  UCS-2 and UTF-16 output is the same
+    as from UTF8ToUCS2() and UTF8ToUTF16(), including how *errors is set.
+    Output is native byte order without a byte order mark.
+    */
+    static std::string from_utf8_text(const std::string& src, TextEncoding encoding,
+                                      Newline newline, bool* errors = nullptr);
+
+    //! Convert text to UTF-8, normalizing line endings
+    /*!
+    The reverse of from_utf8_text().  UCS-2 and UTF-16 input is handled
+    like UCS2ToUTF8() and UTF16ToUTF8(), including a byte order mark.
+    */
+    static std::string to_utf8_text(const std::string& src, TextEncoding encoding,
+                                    Newline newline, bool* errors = nullptr);
+
     //@}
 
 private:
@@ -132,9 +157,10 @@ private:
     static std::string doUTF16ToUTF8(const std::uint8_t* src, std::size_t n, bool* errors);
     static std::string doUTF32ToUTF8(const std::uint8_t* src, std::size_t n, bool* errors);
 
-    // convert characters to/from UTF8
+    // convert characters to/from UTF8.  toUTF8() writes up to 6 bytes
+    // and returns the end of what it wrote.
     static std::uint32_t fromUTF8(const std::uint8_t*& src, std::size_t& size);
-    static void toUTF8(std::string& dst, std::size_t c, bool* errors);
+    static std::uint8_t* toUTF8(std::uint8_t* dst, std::size_t c, bool* errors);
 
 private:
     static std::uint32_t s_invalid;
@@ -0,0 +1,628 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/UnicodeSimd.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INPUTLEAP_SIMD_SSE2 1
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define INPUTLEAP_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#elif (defined(__aarch64__) && !defined(__AARCH64EB__)) || defined(_M_ARM64)
+#define INPUTLEAP_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace inputleap {
+namespace unicode_simd {
+
+namespace {
+
+//
+// portable versions, also used to finish what the vector loops leave
+//
+
+std::size_t ascii_prefix_scalar(const std::uint8_t* src, std::size_t n, std::size_t i)
+{
+    for (; i + 8 <= n; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, src + i, 8);
+        if ((word & 0x8080808080808080ull) != 0) {
+            break;
+        }
+    }
+    while (i < n && src[i] < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+std::size_t widen_ascii16_scalar(const std::uint8_t* src, std::size_t n,
+                                 std::uint8_t* dst, std::size_t i)
+{
+    for (; i < n && src[i] < 0x80; ++i) {
+        std::uint16_t c = src[i];
+        std::memcpy(dst + 2 * i, &c, 2);
+    }
+    return i;
+}
+
+std::size_t widen_ascii32_scalar(const std::uint8_t* src, std::size_t n,
+                                 std::uint8_t* dst, std::size_t i)
+{
+    for (; i < n && src[i] < 0x80; ++i) {
+        std::uint32_t c = src[i];
+        std::memcpy(dst + 4 * i, &c, 4);
+    }
+    return i;
+}
+
+std::size_t narrow_ascii16_scalar(const std::uint8_t* src, std::size_t n,
+                                  std::uint8_t* dst, std::size_t i)
+{
+    for (; i < n; ++i) {
+        std::uint16_t c;
+        std::memcpy(&c, src + 2 * i, 2);
+        if (c >= 0x80) {
+            break;
+        }
+        dst[i] = static_cast<std::uint8_t>(c);
+    }
+    return i;
+}
+
+std::size_t narrow_ascii32_scalar(const std::uint8_t* src, std::size_t n,
+                                  std::uint8_t* dst, std::size_t i)
+{
+    for (; i < n; ++i) {
+        std::uint32_t c;
+        std::memcpy(&c, src + 4 * i, 4);
+        if (c >= 0x80) {
+            break;
+        }
+        dst[i] = static_cast<std::uint8_t>(c);
+    }
+    return i;
+}
+
+bool is_plain(std::uint32_t c)
+{
+    return c < 0x80 && c != '\r' && c != '\n';
+}
+
+std::size_t copy_plain_scalar(const std::uint8_t* src, std::size_t n,
+                              std::uint8_t* dst, std::size_t i)
+{
+    for (; i < n && is_plain(src[i]); ++i) {
+        dst[i] = src[i];
+    }
+    return i;
+}
+
+std::size_t widen_plain16_scalar(const std::uint8_t* src, std::size_t n,
+                                 std::uint8_t* dst, std::size_t i)
+{
+    for (; i < n && is_plain(src[i]); ++i) {
+        std::uint16_t c = src[i];
+        std::memcpy(dst + 2 * i, &c, 2);
+    }
+    return i;
+}
+
+std::size_t narrow_plain16_scalar(const std::uint8_t* src, std::size_t n,
+                                  std::uint8_t* dst, std::size_t i)
+{
+    for (; i < n; ++i) {
+        std::uint16_t c;
+        std::memcpy(&c, src + 2 * i, 2);
+        if (!is_plain(c)) {
+            break;
+        }
+        dst[i] = static_cast<std::uint8_t>(c);
+    }
+    return i;
+}
+
+#if INPUTLEAP_SIMD_SSE2
+
+//
+// SSE2
+//
+
+std::size_t ascii_prefix_sse2(const std::uint8_t* src, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+    }
+    return ascii_prefix_scalar(src, n, i);
+}
+
+std::size_t widen_ascii16_sse2(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+        __m128i* out = reinterpret_cast<__m128i*>(dst + 2 * i);
+        _mm_storeu_si128(out,     _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(v, zero));
+    }
+    return widen_ascii16_scalar(src, n, dst, i);
+}
+
+std::size_t widen_ascii32_sse2(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i* out = reinterpret_cast<__m128i*>(dst + 4 * i);
+        _mm_storeu_si128(out,     _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+    }
+    return widen_ascii32_scalar(src, n, dst, i);
+}
+
+std::size_t narrow_ascii16_sse2(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i high = _mm_set1_epi16(static_cast<short>(0xff80));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(src + 2 * i);
+        __m128i a = _mm_loadu_si128(in);
+        __m128i b = _mm_loadu_si128(in + 1);
+        __m128i any = _mm_and_si128(_mm_or_si128(a, b), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(any, zero)) != 0xffff) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+    }
+    return narrow_ascii16_scalar(src, n, dst, i);
+}
+
+std::size_t narrow_ascii32_sse2(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i high = _mm_set1_epi32(static_cast<int>(0xffffff80));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(src + 4 * i);
+        __m128i a = _mm_loadu_si128(in);
+        __m128i b = _mm_loadu_si128(in + 1);
+        __m128i c = _mm_loadu_si128(in + 2);
+        __m128i d = _mm_loadu_si128(in + 3);
+        __m128i any = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(any, zero)) != 0xffff) {
+            break;
+        }
+        __m128i ab = _mm_packs_epi32(a, b);
+        __m128i cd = _mm_packs_epi32(c, d);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(ab, cd));
+    }
+    return narrow_ascii32_scalar(src, n, dst, i);
+}
+
+// mask of the bytes of v that are not ASCII or are CR or LF
+int special_bytes_sse2(__m128i v)
+{
+    __m128i cr = _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'));
+    __m128i lf = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+    return _mm_movemask_epi8(_mm_or_si128(v, _mm_or_si128(cr, lf)));
+}
+
+// true if any 16 bit character in a or b is not ASCII or is CR or LF
+bool special_words_sse2(__m128i a, __m128i b)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i high = _mm_set1_epi16(static_cast<short>(0xff80));
+    const __m128i cr = _mm_set1_epi16('\r');
+    const __m128i lf = _mm_set1_epi16('\n');
+    __m128i wide = _mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), high), zero);
+    __m128i line = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(a, cr), _mm_cmpeq_epi16(a, lf)),
+                                _mm_or_si128(_mm_cmpeq_epi16(b, cr), _mm_cmpeq_epi16(b, lf)));
+    return _mm_movemask_epi8(wide) != 0xffff || _mm_movemask_epi8(line) != 0;
+}
+
+std::size_t copy_plain_sse2(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (special_bytes_sse2(v) != 0) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    return copy_plain_scalar(src, n, dst, i);
+}
+
+std::size_t widen_plain16_sse2(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (special_bytes_sse2(v) != 0) {
+            break;
+        }
+        __m128i* out = reinterpret_cast<__m128i*>(dst + 2 * i);
+        _mm_storeu_si128(out,     _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(v, zero));
+    }
+    return widen_plain16_scalar(src, n, dst, i);
+}
+
+std::size_t narrow_plain16_sse2(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(src + 2 * i);
+        __m128i a = _mm_loadu_si128(in);
+        __m128i b = _mm_loadu_si128(in + 1);
+        if (special_words_sse2(a, b)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+    }
+    return narrow_plain16_scalar(src, n, dst, i);
+}
+
+#endif
+
+#if INPUTLEAP_SIMD_AVX2
+
+//
+// AVX2, only called if the CPU supports it
+//
+
+bool has_avx2()
+{
+    static const bool s_avx2 = __builtin_cpu_supports("avx2");
+    return s_avx2;
+}
+
+__attribute__((target("avx2")))
+std::size_t ascii_prefix_avx2(const std::uint8_t* src, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        if (_mm256_movemask_epi8(v) != 0) {
+            break;
+        }
+    }
+    return ascii_prefix_scalar(src, n, i);
+}
+
+__attribute__((target("avx2")))
+std::size_t widen_ascii16_avx2(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        if (_mm256_movemask_epi8(v) != 0) {
+            break;
+        }
+        __m256i* out = reinterpret_cast<__m256i*>(dst + 2 * i);
+        _mm256_storeu_si256(out,     _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+        _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+    }
+    return widen_ascii16_scalar(src, n, dst, i);
+}
+
+__attribute__((target("avx2")))
+std::size_t widen_ascii32_avx2(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        if (_mm256_movemask_epi8(v) != 0) {
+            break;
+        }
+        __m128i lo = _mm256_castsi256_si128(v);
+        __m128i hi = _mm256_extracti128_si256(v, 1);
+        __m256i* out = reinterpret_cast<__m256i*>(dst + 4 * i);
+        _mm256_storeu_si256(out,     _mm256_cvtepu8_epi32(lo));
+        _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+        _mm256_storeu_si256(out + 2, _mm256_cvtepu8_epi32(hi));
+        _mm256_storeu_si256(out + 3, _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+    }
+    return widen_ascii32_scalar(src, n, dst, i);
+}
+
+#endif
+
+#if INPUTLEAP_SIMD_NEON
+
+//
+// NEON
+//
+
+std::size_t ascii_prefix_neon(const std::uint8_t* src, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        if (vmaxvq_u8(vld1q_u8(src + i)) >= 0x80) {
+            break;
+        }
+    }
+    return ascii_prefix_scalar(src, n, i);
+}
+
+std::size_t widen_ascii16_neon(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (vmaxvq_u8(v) >= 0x80) {
+            break;
+        }
+        vst1q_u8(dst + 2 * i,      vreinterpretq_u8_u16(vmovl_u8(vget_low_u8(v))));
+        vst1q_u8(dst + 2 * i + 16, vreinterpretq_u8_u16(vmovl_u8(vget_high_u8(v))));
+    }
+    return widen_ascii16_scalar(src, n, dst, i);
+}
+
+std::size_t widen_ascii32_neon(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (vmaxvq_u8(v) >= 0x80) {
+            break;
+        }
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        vst1q_u8(dst + 4 * i,      vreinterpretq_u8_u32(vmovl_u16(vget_low_u16(lo))));
+        vst1q_u8(dst + 4 * i + 16, vreinterpretq_u8_u32(vmovl_u16(vget_high_u16(lo))));
+        vst1q_u8(dst + 4 * i + 32, vreinterpretq_u8_u32(vmovl_u16(vget_low_u16(hi))));
+        vst1q_u8(dst + 4 * i + 48, vreinterpretq_u8_u32(vmovl_u16(vget_high_u16(hi))));
+    }
+    return widen_ascii32_scalar(src, n, dst, i);
+}
+
+std::size_t narrow_ascii16_neon(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint16x8_t a = vreinterpretq_u16_u8(vld1q_u8(src + 2 * i));
+        uint16x8_t b = vreinterpretq_u16_u8(vld1q_u8(src + 2 * i + 16));
+        if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) {
+            break;
+        }
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+    return narrow_ascii16_scalar(src, n, dst, i);
+}
+
+std::size_t narrow_ascii32_neon(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint32x4_t a = vreinterpretq_u32_u8(vld1q_u8(src + 4 * i));
+        uint32x4_t b = vreinterpretq_u32_u8(vld1q_u8(src + 4 * i + 16));
+        uint32x4_t c = vreinterpretq_u32_u8(vld1q_u8(src + 4 * i + 32));
+        uint32x4_t d = vreinterpretq_u32_u8(vld1q_u8(src + 4 * i + 48));
+        if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) {
+            break;
+        }
+        uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+        uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+    }
+    return narrow_ascii32_scalar(src, n, dst, i);
+}
+
+// true if any byte of v is not ASCII or is CR or LF
+bool special_bytes_neon(uint8x16_t v)
+{
+    uint8x16_t line = vorrq_u8(vceqq_u8(v, vdupq_n_u8('\r')), vceqq_u8(v, vdupq_n_u8('\n')));
+    return vmaxvq_u8(vorrq_u8(v, line)) >= 0x80;
+}
+
+// true if any 16 bit character of v is not ASCII or is CR or LF
+bool special_words_neon(uint16x8_t v)
+{
+    uint16x8_t line = vorrq_u16(vceqq_u16(v, vdupq_n_u16('\r')), vceqq_u16(v, vdupq_n_u16('\n')));
+    return vmaxvq_u16(vorrq_u16(v, line)) >= 0x80;
+}
+
+std::size_t copy_plain_neon(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (special_bytes_neon(v)) {
+            break;
+        }
+        vst1q_u8(dst + i, v);
+    }
+    return copy_plain_scalar(src, n, dst, i);
+}
+
+std::size_t widen_plain16_neon(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (special_bytes_neon(v)) {
+            break;
+        }
+        vst1q_u8(dst + 2 * i,      vreinterpretq_u8_u16(vmovl_u8(vget_low_u8(v))));
+        vst1q_u8(dst + 2 * i + 16, vreinterpretq_u8_u16(vmovl_u8(vget_high_u8(v))));
+    }
+    return widen_plain16_scalar(src, n, dst, i);
+}
+
+std::size_t narrow_plain16_neon(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint16x8_t a = vreinterpretq_u16_u8(vld1q_u8(src + 2 * i));
+        uint16x8_t b = vreinterpretq_u16_u8(vld1q_u8(src + 2 * i + 16));
+        if (special_words_neon(a) || special_words_neon(b)) {
+            break;
+        }
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+    return narrow_plain16_scalar(src, n, dst, i);
+}
+
+#endif
+
+} // namespace
+
+std::size_t ascii_prefix(const std::uint8_t* src, std::size_t n)
+{
+#if INPUTLEAP_SIMD_AVX2
+    if (has_avx2()) {
+        return ascii_prefix_avx2(src, n);
+    }
+#endif
+#if INPUTLEAP_SIMD_SSE2
+    return ascii_prefix_sse2(src, n);
+#elif INPUTLEAP_SIMD_NEON
+    return ascii_prefix_neon(src, n);
+#else
+    return ascii_prefix_scalar(src, n, 0);
+#endif
+}
+
+std::size_t widen_ascii16(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+#if INPUTLEAP_SIMD_AVX2
+    if (has_avx2()) {
+        return widen_ascii16_avx2(src, n, dst);
+    }
+#endif
+#if INPUTLEAP_SIMD_SSE2
+    return widen_ascii16_sse2(src, n, dst);
+#elif INPUTLEAP_SIMD_NEON
+    return widen_ascii16_neon(src, n, dst);
+#else
+    return widen_ascii16_scalar(src, n, dst, 0);
+#endif
+}
+
+std::size_t widen_ascii32(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+#if INPUTLEAP_SIMD_AVX2
+    if (has_avx2()) {
+        return widen_ascii32_avx2(src, n, dst);
+    }
+#endif
+#if INPUTLEAP_SIMD_SSE2
+    return widen_ascii32_sse2(src, n, dst);
+#elif INPUTLEAP_SIMD_NEON
+    return widen_ascii32_neon(src, n, dst);
+#else
+    return widen_ascii32_scalar(src, n, dst, 0);
+#endif
+}
+
+std::size_t narrow_ascii16(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+#if INPUTLEAP_SIMD_SSE2
+    return narrow_ascii16_sse2(src, n, dst);
+#elif INPUTLEAP_SIMD_NEON
+    return narrow_ascii16_neon(src, n, dst);
+#else
+    return narrow_ascii16_scalar(src, n, dst, 0);
+#endif
+}
+
+std::size_t narrow_ascii32(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+#if INPUTLEAP_SIMD_SSE2
+    return narrow_ascii32_sse2(src, n, dst);
+#elif INPUTLEAP_SIMD_NEON
+    return narrow_ascii32_neon(src, n, dst);
+#else
+    return narrow_ascii32_scalar(src, n, dst, 0);
+#endif
+}
+
+std::size_t copy_plain(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+#if INPUTLEAP_SIMD_SSE2
+    return copy_plain_sse2(src, n, dst);
+#elif INPUTLEAP_SIMD_NEON
+    return copy_plain_neon(src, n, dst);
+#else
+    return copy_plain_scalar(src, n, dst, 0);
+#endif
+}
+
+std::size_t widen_plain16(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+#if INPUTLEAP_SIMD_SSE2
+    return widen_plain16_sse2(src, n, dst);
+#elif INPUTLEAP_SIMD_NEON
+    return widen_plain16_neon(src, n, dst);
+#else
+    return widen_plain16_scalar(src, n, dst, 0);
+#endif
+}
+
+std::size_t narrow_plain16(const std::uint8_t* src, std::size_t n, std::uint8_t* dst)
+{
+#if INPUTLEAP_SIMD_SSE2
+    return narrow_plain16_sse2(src, n, dst);
+#elif INPUTLEAP_SIMD_NEON
+    return narrow_plain16_neon(src, n, dst);
+#else
+    return narrow_plain16_scalar(src, n, dst, 0);
+#endif
+}
+
+const char* implementation()
+{
+#if INPUTLEAP_SIMD_AVX2
+    if (has_avx2()) {
+        return "avx2";
+    }
+#endif
+#if INPUTLEAP_SIMD_SSE2
+    return "sse2";
+#elif INPUTLEAP_SIMD_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace unicode_simd
+} // namespace inputleap
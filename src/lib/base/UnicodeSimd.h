@@ -0,0 +1,90 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace inputleap {
+
+//! Vectorized text helpers
+/*!
+Bulk operations on runs of ASCII text used by the Unicode conversions.
+Each function handles the longest prefix of its input that consists of
+ASCII characters and returns its length in characters, leaving the rest
+to the caller's scalar code.  Wide characters are in native byte order
+and need not be aligned.
+
+The SSE2 (x86-64), AVX2 (selected at runtime on x86 with GCC or Clang)
+and NEON (AArch64) implementations are picked automatically; other
+targets use a portable scalar version.
+*/
+namespace unicode_simd {
+
+//! Returns the number of leading bytes of \p src below 0x80
+std::size_t ascii_prefix(const std::uint8_t* src, std::size_t n);
+
+//! Widen leading ASCII bytes to 16 bit characters
+/*!
+Writes two bytes to \p dst for every leading ASCII byte of \p src.
+*/
+std::size_t widen_ascii16(const std::uint8_t* src, std::size_t n, std::uint8_t* dst);
+
+//! Widen leading ASCII bytes to 32 bit characters
+/*!
+Writes four bytes to \p dst for every leading ASCII byte of \p src.
+*/
+std::size_t widen_ascii32(const std::uint8_t* src, std::size_t n, std::uint8_t* dst);
+
+//! Narrow leading ASCII 16 bit characters to bytes
+/*!
+\p n is the number of characters in \p src.  Writes one byte to \p dst
+for every leading character below 0x80.
+*/
+std::size_t narrow_ascii16(const std::uint8_t* src, std::size_t n, std::uint8_t* dst);
+
+//! Narrow leading ASCII 32 bit characters to bytes
+/*!
+\p n is the number of characters in \p src.  Writes one byte to \p dst
+for every leading character below 0x80.
+*/
+std::size_t narrow_ascii32(const std::uint8_t* src, std::size_t n, std::uint8_t* dst);
+
+//! Copy leading plain text
+/*!
+Copies leading bytes of \p src that are ASCII but not CR or LF to \p dst.
+*/
+std::size_t copy_plain(const std::uint8_t* src, std::size_t n, std::uint8_t* dst);
+
+//! Widen leading plain text to 16 bit characters
+/*!
+Like widen_ascii16() but also stops at CR and LF.
+*/
+std::size_t widen_plain16(const std::uint8_t* src, std::size_t n, std::uint8_t* dst);
+
+//! Narrow leading plain 16 bit characters to bytes
+/*!
+Like narrow_ascii16() but also stops at CR and LF.
+*/
+std::size_t narrow_plain16(const std::uint8_t* src, std::size_t n, std::uint8_t* dst);
+
+//! Returns the name of the implementation in use
+const char* implementation();
+
+} // namespace unicode_simd
+} // namespace inputleap
@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY CLIENT
+
 #include "client/Client.h"
 
 #include "client/ServerProxy.h"
@@ -26,7 +28,6 @@
 #include "inputleap/ProtocolUtil.h"
 #include "inputleap/protocol_types.h"
 #include "inputleap/Exceptions.h"
-#include "inputleap/StreamChunker.h"
 #include "inputleap/IPlatformScreen.h"
 #include "mt/Thread.h"
 #include "net/TCPSocket.h"
@@ -66,7 +67,6 @@ Client::Client(IEventQueue* events, const std::string& name, const NetworkAddres
     m_suspended(false),
     m_connectOnResume(false),
     m_events(events),
-    m_sendFileThread(nullptr),
     m_writeToDropDirThread(nullptr),
     m_useSecureNetwork(args.m_enableCrypto),
     m_args(args),
@@ -83,8 +83,6 @@ Client::Client(IEventQueue* events, const std::string& name, const NetworkAddres
                           [this](const auto& e){ handle_resume(); });
 
     if (m_args.m_enableDragDrop) {
-        m_events->add_handler(EventType::FILE_CHUNK_SENDING, this,
-                              [this](const auto& e){ handle_file_chunk_sending(e); });
         m_events->add_handler(EventType::FILE_RECEIVE_COMPLETED, this,
                               [this](const auto& e){ handle_file_receive_completed(e); });
     }
@@ -232,9 +230,8 @@ void Client::enter(std::int32_t xAbs, std::int32_t yAbs, std::uint32_t, KeyModif
     m_screen->mouseMove(xAbs, yAbs);
     m_screen->enter(mask);
 
-    if (m_sendFileThread != nullptr) {
-        StreamChunker::interruptFile();
-        m_sendFileThread = nullptr;
+    if (m_server != nullptr) {
+        m_server->cancel_file();
     }
 }
 
@@ -258,13 +255,24 @@ Client::leave()
 }
 
 void
-Client::setClipboard(ClipboardID id, const IClipboard* clipboard)
+Client::setClipboard(ClipboardID id, const Clipboard* clipboard)
 {
      m_screen->setClipboard(id, clipboard);
     m_ownClipboard[id]  = false;
     m_sentClipboard[id] = false;
 }
 
+void Client::offer_clipboard(ClipboardID id, const IClipboard::FormatList& formats)
+{
+    m_ownClipboard[id]  = false;
+    m_sentClipboard[id] = false;
+
+    // fetch the data now if the screen can't wait for it
+    if (!m_screen->offer_clipboard(id, formats)) {
+        m_server->onQueryClipboard(id);
+    }
+}
+
 void
 Client::grabClipboard(ClipboardID id)
 {
@@ -394,19 +402,18 @@ Client::sendClipboard(ClipboardID id)
         // save new time
         m_timeClipboard[id] = clipboard.getTime();
 
-        // marshall the data
-        std::string data = clipboard.marshall();
-        if (data.size() >= m_maximumClipboardSize) {
+        if (clipboard.marshalled_size() >= m_maximumClipboardSize) {
             LOG_NOTE("Skipping clipboard transfer because the clipboard"
                 " contents exceeds the %zi MB size limit set by the server",
                 m_maximumClipboardSize);
             return;
         }
 
-        // save and send data if different or not yet sent
-        if (!m_sentClipboard[id] || data != m_dataClipboard[id]) {
+        // send data if different or not yet sent
+        ContentHash digest = clipboard.digest();
+        if (!m_sentClipboard[id] || digest != sent_digest_[id]) {
             m_sentClipboard[id] = true;
-            m_dataClipboard[id] = data;
+            sent_digest_[id]    = digest;
             m_server->onClipboardChanged(id, &clipboard);
         }
     }
@@ -426,14 +433,6 @@ Client::sendConnectionFailedEvent(const char* msg)
                         create_event_data<FailInfo>(info));
 }
 
-void Client::send_file_chunk(const FileChunk& chunk)
-{
-    LOG_DEBUG1("send file chunk");
-    assert(m_server != nullptr);
-
-    m_server->file_chunk_sending(chunk);
-}
-
 void
 Client::setupConnecting()
 {
@@ -481,6 +480,8 @@ Client::setupScreen()
                           [this](const auto& e){ handle_shape_changed(); });
     m_events->add_handler(EventType::CLIPBOARD_GRABBED, get_event_target(),
                           [this](const auto& e){ handle_clipboard_grabbed(e); });
+    m_events->add_handler(EventType::CLIPBOARD_DATA_REQUESTED, get_event_target(),
+                          [this](const auto& e){ handle_clipboard_data_requested(e); });
 }
 
 void
@@ -527,6 +528,7 @@ Client::cleanupScreen()
         }
         m_events->remove_handler(EventType::SCREEN_SHAPE_CHANGED, get_event_target());
         m_events->remove_handler(EventType::CLIPBOARD_GRABBED, get_event_target());
+        m_events->remove_handler(EventType::CLIPBOARD_DATA_REQUESTED, get_event_target());
         delete m_server;
         m_server = nullptr;
     }
@@ -632,6 +634,12 @@ void Client::handle_clipboard_grabbed(const Event& event)
     }
 }
 
+void Client::handle_clipboard_data_requested(const Event& event)
+{
+    const auto& info = event.get_data_as<IScreen::ClipboardInfo>();
+    m_server->onQueryClipboard(info.m_id);
+}
+
 void Client::handle_hello()
 {
     std::int16_t major, minor;
@@ -645,18 +653,23 @@ void Client::handle_hello()
     // check versions
     LOG_DEBUG1("got hello version %d.%d", major, minor);
     if (major < kProtocolMajorVersion ||
-        (major == kProtocolMajorVersion && minor < kProtocolMinorVersion)) {
+        (major == kProtocolMajorVersion && minor < kProtocolMinMinorVersion)) {
         sendConnectionFailedEvent(XIncompatibleClient(major, minor).what());
         cleanupTimer();
         cleanupConnection();
         return;
     }
 
-    // say hello back
-    LOG_DEBUG1("say hello version %d.%d", kProtocolMajorVersion, kProtocolMinorVersion);
+    // say hello back with the highest version both of us support.  the
+    // server picks the protocol from it.
+    std::int16_t helloMinor = kProtocolMinorVersion;
+    if (major == kProtocolMajorVersion && minor < helloMinor) {
+        helloMinor = minor;
+    }
+    LOG_DEBUG1("say hello version %d.%d", kProtocolMajorVersion, helloMinor);
     ProtocolUtil::writef(m_stream, kMsgHelloBack,
                             kProtocolMajorVersion,
-                            kProtocolMinorVersion, &m_name);
+                            helloMinor, &m_name);
 
     // now connected but waiting to complete handshake
     setupScreen();
@@ -689,11 +702,6 @@ void Client::handle_resume()
     }
 }
 
-void Client::handle_file_chunk_sending(const Event& event)
-{
-    send_file_chunk(event.get_data_as<FileChunk>());
-}
-
 void Client::handle_file_receive_completed(const Event& event)
 {
     (void) event;
@@ -704,9 +712,21 @@ void Client::handle_file_receive_completed(const Event& event)
 void
 Client::onFileReceiveCompleted()
 {
-    if (isReceivedFileSizeValid()) {
-        m_writeToDropDirThread = new Thread([this](){ write_to_drop_dir_thread(); });
+    if (!isReceivedFileSizeValid()) {
+        return;
     }
+
+    // the files arrive one after another in the order of the drag list
+    received_files_.push_back(file_receiver_.take_file());
+    if (received_files_.size() < m_dragFileList.size()) {
+        return;
+    }
+
+    std::vector<fs::path> received;
+    received.swap(received_files_);
+    m_writeToDropDirThread = new Thread([this, received]() {
+        write_to_drop_dir_thread(received);
+    });
 }
 
 void Client::handle_stop_retry()
@@ -714,7 +734,7 @@ void Client::handle_stop_retry()
     m_args.m_restartable = false;
 }
 
-void Client::write_to_drop_dir_thread()
+void Client::write_to_drop_dir_thread(const std::vector<fs::path>& received)
 {
     LOG_DEBUG("starting write to drop dir thread");
 
@@ -722,8 +742,7 @@ void Client::write_to_drop_dir_thread()
         inputleap::this_thread_sleep(.1f);
     }
 
-    DropHelper::writeToDir(m_screen->getDropTarget(), m_dragFileList,
-                    m_receivedFileData);
+    DropHelper::writeToDir(m_screen->getDropTarget(), m_dragFileList, received);
 }
 
 void Client::dragInfoReceived(std::uint32_t fileNum, std::string data)
@@ -735,6 +754,8 @@ void Client::dragInfoReceived(std::uint32_t fileNum, std::string data)
     }
 
     DragInformation::parseDragInfo(m_dragFileList, fileNum, data);
+    received_files_.clear();
+    file_receiver_.set_directory(DropHelper::receive_directory(m_screen));
 
     m_screen->startDraggingFiles(m_dragFileList);
 }
@@ -742,29 +763,16 @@ void Client::dragInfoReceived(std::uint32_t fileNum, std::string data)
 bool
 Client::isReceivedFileSizeValid()
 {
-    return m_expectedFileSize == m_receivedFileData.size();
+    return file_receiver_.is_complete();
 }
 
 void
 Client::sendFileToServer(const char* filename)
 {
-    if (m_sendFileThread != nullptr) {
-        StreamChunker::interruptFile();
-    }
-
-    m_sendFileThread = new Thread([this, filename]() { send_file_thread(filename); });
-}
-
-void Client::send_file_thread(const char* filename)
-{
-    try {
-        StreamChunker::sendFile(filename, m_events, this);
-    }
-    catch (std::runtime_error& error) {
-        LOG_ERR("failed sending file chunks: %s", error.what());
-    }
+    assert(m_server != nullptr);
 
-    m_sendFileThread = nullptr;
+    LOG_DEBUG("sending file to server, filename=%s", filename);
+    m_server->send_files({filename});
 }
 
 void Client::sendDragInfo(std::uint32_t fileCount, std::string& info, size_t size)
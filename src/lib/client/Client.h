@@ -24,12 +24,15 @@
 #include "inputleap/IClient.h"
 #include "inputleap/Clipboard.h"
 #include "inputleap/DragInformation.h"
+#include "inputleap/FileReceiver.h"
 #include "inputleap/INode.h"
 #include "inputleap/ClientArgs.h"
 #include "net/Fwd.h"
 #include "net/NetworkAddress.h"
 #include "base/EventTypes.h"
 
+#include <vector>
+
 namespace inputleap {
 
 class ServerProxy;
@@ -89,6 +92,13 @@ public:
     //! Send dragging file information back to server
     void sendDragInfo(std::uint32_t fileCount, std::string& info, size_t size);
 
+    //! Offer clipboard
+    /*!
+    The server has a new clipboard with the given formats.  Its data
+    is asked for once something on this screen wants it.
+    */
+    void offer_clipboard(ClipboardID, const IClipboard::FormatList& formats);
+
 
     //@}
     //! @name accessors
@@ -117,11 +127,8 @@ public:
     //! Return true if received file size is valid
     bool isReceivedFileSizeValid();
 
-    //! Return expected file size
-    size_t& getExpectedFileSize() { return m_expectedFileSize; }
-
-    //! Return received file data
-    std::string& getReceivedFileData() { return m_receivedFileData; }
+    //! Return the receiver of dragged files
+    FileReceiver& get_file_receiver() { return file_receiver_; }
 
     //! Return drag file list
     DragFileList getDragFileList() { return m_dragFileList; }
@@ -139,7 +146,7 @@ public:
     void enter(std::int32_t xAbs, std::int32_t yAbs, std::uint32_t seqNum, KeyModifierMask mask,
                bool forScreensaver) override;
     bool leave() override;
-    void setClipboard(ClipboardID, const IClipboard*) override;
+    void setClipboard(ClipboardID, const Clipboard*) override;
     void grabClipboard(ClipboardID) override;
     void setClipboardDirty(ClipboardID, bool) override;
     void keyDown(KeyID, KeyModifierMask, KeyButton) override;
@@ -159,9 +166,7 @@ private:
     void sendClipboard(ClipboardID);
     void send_event(EventType);
     void sendConnectionFailedEvent(const char* msg);
-    void send_file_chunk(const FileChunk& data);
-    void send_file_thread(const char* filename);
-    void write_to_drop_dir_thread();
+    void write_to_drop_dir_thread(const std::vector<fs::path>& received);
     void setupConnecting();
     void setupConnection();
     void setupScreen();
@@ -178,10 +183,10 @@ private:
     void handle_disconnected();
     void handle_shape_changed();
     void handle_clipboard_grabbed(const Event& event);
+    void handle_clipboard_data_requested(const Event& event);
     void handle_hello();
     void handle_suspend();
     void handle_resume();
-    void handle_file_chunk_sending(const Event& event);
     void handle_file_receive_completed(const Event&);
     void handle_stop_retry();
     void onFileReceiveCompleted();
@@ -205,13 +210,12 @@ private:
     bool m_ownClipboard[kClipboardEnd];
     bool m_sentClipboard[kClipboardEnd];
     IClipboard::Time m_timeClipboard[kClipboardEnd];
-    std::string m_dataClipboard[kClipboardEnd];
+    ContentHash sent_digest_[kClipboardEnd];
     IEventQueue* m_events;
-    std::size_t m_expectedFileSize;
-    std::string m_receivedFileData;
+    FileReceiver file_receiver_;
+    std::vector<fs::path> received_files_;
     DragFileList m_dragFileList;
     std::string m_dragFileExt;
-    Thread* m_sendFileThread;
     Thread* m_writeToDropDirThread;
     bool m_useSecureNetwork;
     ClientArgs m_args;
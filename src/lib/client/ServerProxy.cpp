@@ -16,12 +16,16 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY PROTOCOL
+
 #include "client/ServerProxy.h"
 
 #include "client/Client.h"
+#include "inputleap/ChunkCodec.h"
 #include "inputleap/FileChunk.h"
 #include "inputleap/ClipboardChunk.h"
-#include "inputleap/StreamChunker.h"
+#include "inputleap/ClipboardStreamer.h"
+#include "inputleap/FileStreamer.h"
 #include "inputleap/Clipboard.h"
 #include "inputleap/ProtocolUtil.h"
 #include "inputleap/option_types.h"
@@ -34,6 +38,7 @@
 #include "base/XBase.h"
 
 #include <memory>
+#include <vector>
 
 namespace inputleap {
 
@@ -63,8 +68,12 @@ ServerProxy::ServerProxy(Client* client, inputleap::IStream* stream, IEventQueue
     // handle data on stream
     m_events->add_handler(EventType::STREAM_INPUT_READY, m_stream->get_event_target(),
                           [this](const auto& e){ handle_data(); });
-    m_events->add_handler(EventType::CLIPBOARD_SENDING, this,
-                          [this](const auto& e){ handle_clipboard_sending_event(e); });
+    m_events->add_handler(EventType::STREAM_OUTPUT_FLUSHED, m_stream->get_event_target(),
+                          [this](const auto& e){ handle_output_flushed(); });
+    clipboard_streamer_ = std::make_unique<ClipboardStreamer>(m_stream,
+        [this](const ClipboardChunk& chunk) { chunk.send(m_stream); });
+    file_streamer_ = std::make_unique<FileStreamer>(m_events, m_stream,
+        [this](const FileChunk& chunk) { chunk.send(m_stream); });
 
     // send heartbeat
     setKeepAliveRate(kKeepAliveRate);
@@ -74,7 +83,7 @@ ServerProxy::~ServerProxy()
 {
     setKeepAliveRate(-1.0);
     m_events->remove_handler(EventType::STREAM_INPUT_READY, m_stream->get_event_target());
-    m_events->remove_handler(EventType::CLIPBOARD_SENDING, this);
+    m_events->remove_handler(EventType::STREAM_OUTPUT_FLUSHED, m_stream->get_event_target());
 }
 
 void
@@ -169,6 +178,12 @@ ServerProxy::EResult ServerProxy::parseHandshakeMessage(const std::uint8_t* code
         resetOptions();
     }
 
+    else if (memcmp(code, kMsgDCodecs, 4) == 0) {
+        if (!setCodecs()) {
+            return kDisconnect;
+        }
+    }
+
     else if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
         // echo keep alives and reset alarm
         ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
@@ -291,6 +306,10 @@ ServerProxy::EResult ServerProxy::parseMessage(const std::uint8_t* code)
         setClipboard();
     }
 
+    else if (memcmp(code, kMsgDClipboardFormats, 4) == 0) {
+        offerClipboard();
+    }
+
     else if (memcmp(code, kMsgCResetOptions, 4) == 0) {
         resetOptions();
     }
@@ -306,6 +325,12 @@ ServerProxy::EResult ServerProxy::parseMessage(const std::uint8_t* code)
         dragInfoReceived();
     }
 
+    else if (memcmp(code, kMsgDCodecs, 4) == 0) {
+        if (!setCodecs()) {
+            return kDisconnect;
+        }
+    }
+
     else if (memcmp(code, kMsgCClose, 4) == 0) {
         // server wants us to hangup
         LOG_DEBUG1("recv close");
@@ -361,10 +386,10 @@ ServerProxy::onGrabClipboard(ClipboardID id)
 void
 ServerProxy::onClipboardChanged(ClipboardID id, const IClipboard* clipboard)
 {
-    std::string data = IClipboard::marshall(clipboard);
+    auto data = std::make_shared<const std::string>(IClipboard::marshall(clipboard));
     LOG_DEBUG("sending clipboard %d seqnum=%d", id, m_seqNum);
 
-    StreamChunker::sendClipboard(data, data.size(), id, m_seqNum, m_events, this);
+    clipboard_streamer_->send(std::move(data), id, m_seqNum);
 }
 
 void
@@ -574,6 +599,60 @@ ServerProxy::setClipboard()
     }
 }
 
+void ServerProxy::offerClipboard()
+{
+    // parse
+    ClipboardID id;
+    std::uint32_t seqNum;
+    std::vector<std::uint32_t> pairs;
+    ProtocolUtil::readf(m_stream, kMsgDClipboardFormats + 4, &id, &seqNum, &pairs);
+    LOG_DEBUG("recv clipboard %d formats (%zu)", id, pairs.size() / 2);
+
+    // validate
+    if (id >= kClipboardEnd) {
+        return;
+    }
+
+    // skip formats we don't know
+    IClipboard::FormatList formats;
+    for (std::size_t i = 0; i + 1 < pairs.size(); i += 2) {
+        if (pairs[i] < IClipboard::kNumFormats) {
+            formats.push_back({static_cast<IClipboard::EFormat>(pairs[i]), pairs[i + 1]});
+        }
+    }
+
+    // forward
+    offer_seq_num_[id] = seqNum;
+    m_client->offer_clipboard(id, formats);
+}
+
+bool ServerProxy::setCodecs()
+{
+    // parse
+    std::vector<std::uint8_t> codecs;
+    if (!ProtocolUtil::readf(m_stream, kMsgDCodecs + 4, &codecs)) {
+        LOG_ERR("invalid codec message from server");
+        m_client->disconnect("invalid message from server");
+        return false;
+    }
+
+    ChunkCodec codec = choose_chunk_codec(codecs);
+    LOG_DEBUG("recv codecs (%zu), using codec %d", codecs.size(), static_cast<int>(codec));
+    clipboard_streamer_->set_codec(codec);
+    file_streamer_->set_codec(codec);
+
+    // tell the server what it may send us
+    std::vector<std::uint8_t> supported = supported_chunk_codecs();
+    ProtocolUtil::writef(m_stream, kMsgDCodecs, &supported);
+    return true;
+}
+
+void ServerProxy::onQueryClipboard(ClipboardID id)
+{
+    LOG_DEBUG("sending query for clipboard %d", id);
+    ProtocolUtil::writef(m_stream, kMsgQClipboard, id, offer_seq_num_[id]);
+}
+
 void
 ServerProxy::grabClipboard()
 {
@@ -864,10 +943,7 @@ ServerProxy::infoAcknowledgment()
 void
 ServerProxy::fileChunkReceived()
 {
-    int result = FileChunk::assemble(
-                    m_stream,
-                    m_client->getReceivedFileData(),
-                    m_client->getExpectedFileSize());
+    int result = m_client->get_file_receiver().receive(m_stream);
 
     if (result == kFinish) {
         m_events->add_event(EventType::FILE_RECEIVE_COMPLETED, m_client);
@@ -891,16 +967,20 @@ ServerProxy::dragInfoReceived()
     m_client->dragInfoReceived(fileNum, content);
 }
 
-void ServerProxy::handle_clipboard_sending_event(const Event& event)
+void ServerProxy::send_files(const std::vector<std::string>& filenames)
+{
+    file_streamer_->send(filenames);
+}
+
+void ServerProxy::cancel_file()
 {
-    const auto& chunk = event.get_data_as<ClipboardChunk>();
-    ProtocolUtil::writef(m_stream, kMsgDClipboard, chunk.id_, chunk.sequence_, chunk.mark_,
-                         &chunk.data_);
+    file_streamer_->cancel();
 }
 
-void ServerProxy::file_chunk_sending(const FileChunk& chunk)
+void ServerProxy::handle_output_flushed()
 {
-    ProtocolUtil::writef(m_stream, kMsgDFileTransfer, chunk.mark_, &chunk.data_);
+    clipboard_streamer_->pump();
+    file_streamer_->pump();
 }
 
 void ServerProxy::sendDragInfo(std::uint32_t fileCount, const char* info, size_t size)
@@ -25,6 +25,10 @@
 #include "base/Event.h"
 #include "base/EventTarget.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace inputleap {
 
 class Client;
@@ -52,10 +56,16 @@ public:
     bool onGrabClipboard(ClipboardID);
     void onClipboardChanged(ClipboardID, const IClipboard*);
 
+    // ask for the data of a clipboard the server offered
+    void onQueryClipboard(ClipboardID);
+
     //@}
 
-    // sending file chunk to server
-    void file_chunk_sending(const FileChunk& chunk);
+    // start sending files to the server, cancelling the ones being sent
+    void send_files(const std::vector<std::string>& filenames);
+
+    // stop sending the files being sent, if any
+    void cancel_file();
 
     // sending dragging information to server
     void sendDragInfo(std::uint32_t fileCount, const char* info, size_t size);
@@ -85,11 +95,13 @@ private:
     // event handlers
     void handle_data();
     void handle_keep_alive_alarm();
+    void handle_output_flushed();
 
     // message handlers
     void enter();
     void leave();
     void setClipboard();
+    void offerClipboard();
     void grabClipboard();
     void keyDown();
     void keyRepeat();
@@ -106,7 +118,7 @@ private:
     void infoAcknowledgment();
     void fileChunkReceived();
     void dragInfoReceived();
-    void handle_clipboard_sending_event(const Event&);
+    bool setCodecs();
 
 private:
     typedef EResult (ServerProxy::*MessageParser)(const std::uint8_t*);
@@ -116,6 +128,10 @@ private:
 
     std::uint32_t m_seqNum;
 
+    // sequence number of the last clipboard offer, sent back when
+    // asking for its data
+    std::uint32_t offer_seq_num_[kClipboardEnd] = {};
+
     bool m_compressMouse;
     bool m_compressMouseRelative;
     std::int32_t m_xMouse, m_yMouse;
@@ -130,6 +146,10 @@ private:
 
     MessageParser m_parser;
     IEventQueue* m_events;
+
+    // send our clipboards and files as the stream takes them
+    std::unique_ptr<ClipboardStreamer> clipboard_streamer_;
+    std::unique_ptr<FileStreamer> file_streamer_;
 };
 
 } // namespace inputleap
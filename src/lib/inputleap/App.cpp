@@ -31,6 +31,7 @@
 #include "ipc/Ipc.h"
 #include "base/EventQueue.h"
 #include "common/DataDirectories.h"
+#include "io/filesystem.h"
 
 #if SYSAPI_WIN32
 #include "base/IEventQueue.h"
@@ -142,6 +143,26 @@ App::setupFileLogging()
         CLOG->insert(m_fileLog);
         LOG_DEBUG1("logging to file (%s) enabled", argsBase().m_logFile);
     }
+
+    // the binary log is started by setupBinaryLogging().  resolve the path
+    // now because daemonizing changes the working directory.
+    if (argsBase().m_binaryLogFile != nullptr) {
+        m_binaryLogPath = fs::absolute(fs::u8path(argsBase().m_binaryLogFile)).u8string();
+    }
+}
+
+void
+App::setupBinaryLogging()
+{
+    if (m_binaryLogPath.empty()) {
+        return;
+    }
+
+    if (CLOG->set_binary_log(m_binaryLogPath.c_str())) {
+        LOG_DEBUG1("binary logging to file (%s) enabled", m_binaryLogPath.c_str());
+    } else {
+        LOG_WARN("failed to create binary log file (%s)", m_binaryLogPath.c_str());
+    }
 }
 
 void
@@ -169,6 +190,12 @@ App::initApp(int argc, const char** argv)
             argsBase().m_exename.c_str(), argsBase().m_logFilter, argsBase().m_exename.c_str());
         m_bye(kExitArgs);
     }
+    if (argsBase().m_logCategories != nullptr &&
+        !CLOG->set_category_filters(argsBase().m_logCategories)) {
+        LOG_PRINT("%s: unrecognized log categories `%s'" BYE,
+            argsBase().m_exename.c_str(), argsBase().m_logCategories, argsBase().m_exename.c_str());
+        m_bye(kExitArgs);
+    }
     loggingFilterWarning();
 
     if (argsBase().m_enableDragDrop) {
@@ -223,6 +250,14 @@ void App::handle_ipc_message(const Event& e)
         LOG_INFO("got ipc shutdown message");
         m_events->add_event(EventType::QUIT);
     }
+    else if (m.type() == kIpcLogFilter) {
+        const auto& filters = static_cast<const IpcLogFilterMessage&>(m).filters();
+        if (CLOG->set_category_filters(filters)) {
+            LOG_INFO("log category filters changed to %s", filters.c_str());
+        } else {
+            LOG_WARN("invalid log category filters from ipc: %s", filters.c_str());
+        }
+    }
 }
 
 void App::run_events_loop()
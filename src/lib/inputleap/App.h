@@ -27,6 +27,7 @@
 #include "net/SocketMultiplexer.h"
 #include "common/common.h"
 #include <memory>
+#include <string>
 
 #if SYSAPI_WIN32
 #include "inputleap/win32/AppUtilWindows.h"
@@ -76,6 +77,10 @@ public:
     // If --log was specified in args, then add a file logger.
     void setupFileLogging();
 
+    // If --binary-log was specified in args, then start the binary log.
+    // The writer owns a thread, so this must run after daemonization.
+    void setupBinaryLogging();
+
     // If messages will be hidden (to improve performance), warn user.
     void loggingFilterWarning();
 
@@ -115,6 +120,7 @@ private:
     ArgsBase* m_args;
     static App* s_instance;
     FileLogOutputter* m_fileLog;
+    std::string m_binaryLogPath;
     CreateTaskBarReceiverFunc m_createTaskBarReceiver;
     ARCH_APP_UTIL m_appUtil;
     IpcClient* m_ipcClient;
@@ -155,11 +161,20 @@ private:
     "  -d, --debug <level>      filter out log messages with priority below level.\n" \
     "                             level may be: FATAL, ERROR, WARNING, NOTE, INFO,\n" \
     "                             DEBUG, DEBUG1, DEBUG2.\n" \
+    "      --log-category <category>=<level>[,...]\n" \
+    "                           filter the messages of a category with its own\n" \
+    "                             level.  category may be: general, net,\n" \
+    "                             protocol, server, client, x11, keys,\n" \
+    "                             clipboard, ipc.  level may also be default.\n" \
     "  -n, --name <screen-name> use screen-name instead the hostname to identify\n" \
     "                             this screen in the configuration.\n" \
     "  -1, --no-restart         do not try to restart on failure.\n" \
     "      --restart            restart the server automatically if it fails. (*)\n" \
     "  -l  --log <file>         write log messages to file.\n" \
+    "      --async-log          write log messages from a background thread.\n" \
+    "      --binary-log <file>  record log messages to file without formatting\n" \
+    "                             them; DEBUG and more verbose messages only go\n" \
+    "                             there.  use input-leap-logdecode to read it.\n" \
     "      --no-tray            disable the system tray icon.\n" \
     "      --enable-drag-drop   enable file drag & drop.\n" \
     "      --enable-crypto      enable the crypto (ssl) plugin (default, deprecated).\n" \
@@ -17,7 +17,6 @@
 
 #include "inputleap/ArgParser.h"
 
-#include "inputleap/StreamChunker.h"
 #include "inputleap/App.h"
 #include "inputleap/ServerArgs.h"
 #include "inputleap/ClientArgs.h"
@@ -351,9 +350,18 @@ ArgParser::parseGenericArgs(Argv& argv)
         // change logging level
         argsBase().m_logFilter = optarg;
     }
+    else if (argv.shift("--log-category", nullptr, &optarg)) {
+        argsBase().m_logCategories = optarg;
+    }
     else if (argv.shift("-l", "--log", &optarg)) {
         argsBase().m_logFile = optarg;
     }
+    else if (argv.shift("--async-log")) {
+        argsBase().m_asyncLog = true;
+    }
+    else if (argv.shift("--binary-log", nullptr, &optarg)) {
+        argsBase().m_binaryLogFile = optarg;
+    }
     else if (argv.shift("-f", "--no-daemon")) {
         // not a daemon
         argsBase().m_daemon = false;
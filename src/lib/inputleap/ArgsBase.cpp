@@ -33,7 +33,10 @@ m_backend(false),
 m_restartable(true),
 m_noHooks(false),
 m_logFilter(nullptr),
+m_logCategories(nullptr),
 m_logFile(nullptr),
+m_asyncLog(false),
+m_binaryLogFile(nullptr),
 m_display(nullptr),
 m_disableTray(false),
 m_enableIpc(false),
@@ -34,7 +34,10 @@ public:
     bool m_noHooks;
     std::string m_exename;
     const char* m_logFilter;
+    const char* m_logCategories;
     const char* m_logFile;
+    bool m_asyncLog;
+    const char* m_binaryLogFile;
     const char* m_display;
     std::string m_name;
     bool m_disableTray;
@@ -0,0 +1,230 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/ChunkCodec.h"
+
+#include "config.h"
+#include "base/Stopwatch.h"
+#include "base/String.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace inputleap {
+
+const std::size_t ChunkCompressor::kMinChunkSize;
+const std::size_t ChunkCompressor::kMaxRatio16;
+const int ChunkCompressor::kMaxPoorChunks;
+
+namespace {
+
+// codec id and 4 byte size of the decompressed data
+const std::size_t kHeaderSize = 5;
+
+// chunks are 32 KiB;  anything much bigger is corrupt or hostile
+const std::uint32_t kMaxDecompressedSize = 1024 * 1024;
+
+bool starts_with(const std::uint8_t* data, std::size_t size, const char* magic,
+                 std::size_t magic_size, std::size_t offset = 0)
+{
+    return size >= offset + magic_size && std::memcmp(data + offset, magic, magic_size) == 0;
+}
+
+} // namespace
+
+std::vector<std::uint8_t> supported_chunk_codecs()
+{
+    std::vector<std::uint8_t> codecs;
+#if HAVE_ZLIB
+    codecs.push_back(static_cast<std::uint8_t>(ChunkCodec::kDeflate));
+#endif
+    return codecs;
+}
+
+ChunkCodec choose_chunk_codec(const std::vector<std::uint8_t>& peer_codecs)
+{
+    // our own preference decides
+    for (std::uint8_t codec : supported_chunk_codecs()) {
+        if (std::find(peer_codecs.begin(), peer_codecs.end(), codec) != peer_codecs.end()) {
+            return static_cast<ChunkCodec>(codec);
+        }
+    }
+    return ChunkCodec::kNone;
+}
+
+bool is_compressed_format(const std::uint8_t* data, std::size_t size)
+{
+    return starts_with(data, size, "\x89PNG\r\n\x1a\n", 8) ||
+           starts_with(data, size, "\xff\xd8\xff", 3) ||
+           starts_with(data, size, "GIF8", 4) ||
+           (starts_with(data, size, "RIFF", 4) && starts_with(data, size, "WEBP", 4, 8)) ||
+           starts_with(data, size, "PK\x03\x04", 4) ||
+           starts_with(data, size, "\x1f\x8b", 2) ||
+           starts_with(data, size, "\x28\xb5\x2f\xfd", 4) ||
+           starts_with(data, size, "\xfd" "7zXZ", 6) ||
+           starts_with(data, size, "7z\xbc\xaf\x27\x1c", 6) ||
+           starts_with(data, size, "BZh", 3) ||
+           starts_with(data, size, "Rar!", 4);
+}
+
+bool decompress_chunk(const std::uint8_t* payload, std::size_t size, std::string& out)
+{
+    if (size < kHeaderSize) {
+        return false;
+    }
+    std::uint32_t raw_size = (static_cast<std::uint32_t>(payload[1]) << 24) |
+                             (static_cast<std::uint32_t>(payload[2]) << 16) |
+                             (static_cast<std::uint32_t>(payload[3]) << 8) |
+                              static_cast<std::uint32_t>(payload[4]);
+    if (raw_size > kMaxDecompressedSize) {
+        return false;
+    }
+
+    switch (static_cast<ChunkCodec>(payload[0])) {
+#if HAVE_ZLIB
+    case ChunkCodec::kDeflate: {
+        std::size_t old_size = out.size();
+        out.resize(old_size + raw_size);
+        uLongf out_size = raw_size;
+        int result = uncompress(reinterpret_cast<Bytef*>(&out[old_size]), &out_size,
+                                payload + kHeaderSize, static_cast<uLong>(size - kHeaderSize));
+        if (result != Z_OK || out_size != raw_size) {
+            out.resize(old_size);
+            return false;
+        }
+        return true;
+    }
+#endif
+
+    default:
+        return false;
+    }
+}
+
+#if HAVE_ZLIB
+struct ChunkCompressor::Deflater {
+    Deflater()
+    {
+        // the fastest level;  it gets most of the gain on text and bitmaps
+        ok = deflateInit(&stream, Z_BEST_SPEED) == Z_OK;
+    }
+
+    ~Deflater()
+    {
+        if (ok) {
+            deflateEnd(&stream);
+        }
+    }
+
+    z_stream stream = {};
+    bool ok = false;
+};
+#else
+struct ChunkCompressor::Deflater {};
+#endif
+
+ChunkCompressor::ChunkCompressor(ChunkCodec codec) :
+    codec_(codec)
+{
+}
+
+ChunkCompressor::~ChunkCompressor() = default;
+
+void ChunkCompressor::reset(ChunkCodec codec)
+{
+    codec_ = codec;
+    gave_up_ = false;
+    poor_chunks_ = 0;
+    stats_ = Stats();
+}
+
+void ChunkCompressor::skip(std::size_t size)
+{
+    stats_.raw_size += size;
+    stats_.sent_size += size;
+}
+
+bool ChunkCompressor::compress(const std::uint8_t* data, std::size_t size, std::string& payload)
+{
+    stats_.raw_size += size;
+    stats_.sent_size += size;
+    if (codec() == ChunkCodec::kNone || size < kMinChunkSize || size > kMaxDecompressedSize) {
+        return false;
+    }
+
+    Stopwatch stopwatch;
+    bool compressed = false;
+
+#if HAVE_ZLIB
+    if (codec_ == ChunkCodec::kDeflate) {
+        if (!deflater_) {
+            deflater_ = std::make_unique<Deflater>();
+        }
+        z_stream& stream = deflater_->stream;
+        if (deflater_->ok && deflateReset(&stream) == Z_OK) {
+            // only worth sending if it fits in this
+            std::size_t limit = size * kMaxRatio16 / 16;
+            payload.resize(kHeaderSize + limit);
+            stream.next_in = const_cast<Bytef*>(data);
+            stream.avail_in = static_cast<uInt>(size);
+            stream.next_out = reinterpret_cast<Bytef*>(&payload[kHeaderSize]);
+            stream.avail_out = static_cast<uInt>(limit);
+            if (deflate(&stream, Z_FINISH) == Z_STREAM_END) {
+                payload.resize(kHeaderSize + stream.total_out);
+                compressed = true;
+            }
+        }
+    }
+#endif
+
+    stats_.seconds += stopwatch.getTime();
+
+    if (!compressed) {
+        if (++poor_chunks_ >= kMaxPoorChunks) {
+            gave_up_ = true;
+        }
+        return false;
+    }
+    poor_chunks_ = 0;
+
+    std::uint32_t raw_size = static_cast<std::uint32_t>(size);
+    payload[0] = static_cast<char>(codec_);
+    payload[1] = static_cast<char>(raw_size >> 24);
+    payload[2] = static_cast<char>(raw_size >> 16);
+    payload[3] = static_cast<char>(raw_size >> 8);
+    payload[4] = static_cast<char>(raw_size);
+    stats_.sent_size -= size - payload.size();
+    return true;
+}
+
+std::string ChunkCompressor::describe(const Stats& stats)
+{
+    double ratio = stats.raw_size > 0 ?
+                static_cast<double>(stats.sent_size) / stats.raw_size : 1.0;
+    double speed = stats.seconds > 0.0 ? stats.raw_size / stats.seconds / (1024 * 1024) : 0.0;
+
+    return string::sprintf("%llu bytes sent as %llu (%.0f%%), compressed at %.1f MB/s",
+                           static_cast<unsigned long long>(stats.raw_size),
+                           static_cast<unsigned long long>(stats.sent_size), ratio * 100.0,
+                           speed);
+}
+
+} // namespace inputleap
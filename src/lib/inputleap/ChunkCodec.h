@@ -0,0 +1,138 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inputleap {
+
+//! Codecs for compressed clipboard and file chunks
+/*!
+The ids are sent in kMsgDCodecs and in the first byte of every
+kDataCompressed chunk, so they must never change.
+*/
+enum class ChunkCodec : std::uint8_t {
+    kNone = 0,
+    kDeflate = 1
+};
+
+//! Returns the codecs this build can decode, most preferred first
+std::vector<std::uint8_t> supported_chunk_codecs();
+
+//! Returns the codec to compress with for a peer that decodes \p peer_codecs
+ChunkCodec choose_chunk_codec(const std::vector<std::uint8_t>& peer_codecs);
+
+//! Test if \p data starts like a file format that is already compressed
+/*!
+Recognizes PNG, JPEG, GIF, WebP and the common archive formats.
+*/
+bool is_compressed_format(const std::uint8_t* data, std::size_t size);
+
+//! Decompress a kDataCompressed chunk
+/*!
+Appends the data of the compressed chunk \p payload to \p out.  Returns
+false, leaving \p out as it was, if the chunk is corrupt or uses a codec
+this build doesn't have.
+*/
+bool decompress_chunk(const std::uint8_t* payload, std::size_t size, std::string& out);
+
+//! Adaptive chunk compressor
+/*!
+Compresses the chunks of one clipboard or file independently, so each
+chunk can be decoded on its own.  Chunks that are small or don't shrink
+enough are left alone, and after a few of those in a row the compressor
+gives up on the rest of the transfer, so data that is already compressed
+costs little CPU.  Keeps statistics to report the achieved ratio and
+throughput.
+*/
+class ChunkCompressor {
+public:
+    //! Chunks smaller than this are sent as they are
+    static const std::size_t kMinChunkSize = 512;
+
+    //! Compressed chunks must be at most this part of the original, in 1/16
+    static const std::size_t kMaxRatio16 = 15;
+
+    //! Give up after this many chunks in a row that didn't shrink enough
+    static const int kMaxPoorChunks = 4;
+
+    struct Stats {
+        //! Bytes given to compress() and skip()
+        std::uint64_t raw_size = 0;
+        //! Bytes to send for them, compressed or not
+        std::uint64_t sent_size = 0;
+        //! Time spent compressing in seconds
+        double seconds = 0.0;
+    };
+
+    explicit ChunkCompressor(ChunkCodec codec = ChunkCodec::kNone);
+    ChunkCompressor(const ChunkCompressor&) = delete;
+    ChunkCompressor& operator=(const ChunkCompressor&) = delete;
+    ~ChunkCompressor();
+
+    //! @name manipulators
+    //@{
+
+    //! Start a new transfer, compressing with \p codec
+    void reset(ChunkCodec codec);
+
+    //! Send the rest of the transfer uncompressed
+    void give_up() { gave_up_ = true; }
+
+    //! Count a chunk that is sent as it is without trying to compress it
+    void skip(std::size_t size);
+
+    //! Compress a chunk
+    /*!
+    Stores the kDataCompressed payload for \p data in \p payload and
+    returns true, or returns false if the chunk should be sent as it is.
+    */
+    bool compress(const std::uint8_t* data, std::size_t size, std::string& payload);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Returns the codec, or \c kNone if the compressor gave up
+    ChunkCodec codec() const { return gave_up_ ? ChunkCodec::kNone : codec_; }
+
+    //! Returns the statistics since the last reset()
+    const Stats& stats() const { return stats_; }
+
+    //@}
+
+    //! Returns a summary of \p stats for the log
+    static std::string describe(const Stats& stats);
+
+private:
+    struct Deflater;
+
+    ChunkCodec codec_;
+    bool gave_up_ = false;
+    int poor_chunks_ = 0;
+    Stats stats_;
+
+    // kept between chunks and transfers to avoid reallocating its state
+    std::unique_ptr<Deflater> deflater_;
+};
+
+} // namespace inputleap
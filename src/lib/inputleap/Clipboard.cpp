@@ -21,6 +21,16 @@
 
 namespace inputleap {
 
+namespace {
+
+const std::shared_ptr<const std::string>& empty_data()
+{
+    static const auto empty = std::make_shared<const std::string>();
+    return empty;
+}
+
+} // namespace
+
 Clipboard::Clipboard() :
     m_open(false),
     m_owner(false)
@@ -42,9 +52,11 @@ Clipboard::clear()
 
     // clear all data
     for (std::int32_t index = 0; index < kNumFormats; ++index) {
-        m_data[index]  = "";
+        m_data[index]  = empty_data();
         m_added[index] = false;
+        hashes_[index] = ContentHash();
     }
+    marshalled_.reset();
 
     // save time
     m_timeOwned = m_time;
@@ -57,12 +69,20 @@ Clipboard::clear()
 
 void
 Clipboard::add(EFormat format, const std::string& data)
+{
+    add_shared(format, std::make_shared<const std::string>(data));
+}
+
+void Clipboard::add_shared(EFormat format, std::shared_ptr<const std::string> data)
 {
     assert(m_open);
     assert(m_owner);
+    assert(data != nullptr);
 
-    m_data[format]  = data;
+    hashes_[format] = content_hash(*data);
+    m_data[format]  = std::move(data);
     m_added[format] = true;
+    marshalled_.reset();
 }
 
 bool
@@ -98,6 +118,12 @@ Clipboard::has(EFormat format) const
 }
 
 std::string Clipboard::get(EFormat format) const
+{
+    assert(m_open);
+    return *m_data[format];
+}
+
+std::shared_ptr<const std::string> Clipboard::get_shared(EFormat format) const
 {
     assert(m_open);
     return m_data[format];
@@ -114,4 +140,57 @@ std::string Clipboard::marshall() const
     return IClipboard::marshall(this);
 }
 
+std::shared_ptr<const std::string> Clipboard::marshalled() const
+{
+    assert(!m_open);
+    if (!marshalled_) {
+        marshalled_ = std::make_shared<const std::string>(marshall());
+    }
+    return marshalled_;
+}
+
+std::size_t Clipboard::marshalled_size() const
+{
+    // see IClipboard::marshall() for the format
+    std::size_t size = 4;
+    for (std::int32_t index = 0; index < kNumFormats; ++index) {
+        if (m_added[index]) {
+            size += 4 + 4 + m_data[index]->size();
+        }
+    }
+    return size;
+}
+
+IClipboard::FormatList Clipboard::formats() const
+{
+    FormatList formats;
+    for (std::int32_t index = 0; index < kNumFormats; ++index) {
+        if (m_added[index]) {
+            formats.push_back({static_cast<EFormat>(index),
+                               static_cast<std::uint32_t>(m_data[index]->size())});
+        }
+    }
+    return formats;
+}
+
+ContentHash Clipboard::get_hash(EFormat format) const
+{
+    return hashes_[format];
+}
+
+ContentHash Clipboard::digest() const
+{
+    // the digest is only ever compared on this host so the byte order
+    // of the words doesn't matter
+    std::uint64_t words[1 + 2 * kNumFormats] = {};
+    for (std::int32_t index = 0; index < kNumFormats; ++index) {
+        if (m_added[index]) {
+            words[0] |= std::uint64_t(1) << index;
+            words[1 + 2 * index] = hashes_[index].low;
+            words[2 + 2 * index] = hashes_[index].high;
+        }
+    }
+    return content_hash(words, sizeof(words));
+}
+
 } // namespace inputleap
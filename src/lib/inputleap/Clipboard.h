@@ -19,6 +19,9 @@
 #pragma once
 
 #include "inputleap/IClipboard.h"
+#include "base/ContentHash.h"
+
+#include <memory>
 
 namespace inputleap {
 
@@ -52,16 +55,57 @@ public:
     */
     std::string marshall() const;
 
+    //! Get shared marshalled clipboard data
+    /*!
+    Like marshall() but the buffer is built only once until the data
+    changes and it is shared rather than copied, e.g. by every client
+    the clipboard is sent to.  Must not be called while the clipboard
+    is open.
+    */
+    std::shared_ptr<const std::string> marshalled() const;
+
+    //! Get size of marshalled data
+    /*!
+    Return the size of the buffer marshall() would return without
+    building it.
+    */
+    std::size_t marshalled_size() const;
+
+    //! Get formats
+    /*!
+    Return the formats this clipboard has data for and the size of
+    that data.  Doesn't need the clipboard to be open.
+    */
+    FormatList formats() const;
+
+    //! Get hash of format data
+    /*!
+    Return the hash of the data in the given format, computed when the
+    data was added.  Formats without data hash like the empty string.
+    Unlike get() this doesn't need the clipboard to be open.
+    */
+    ContentHash get_hash(EFormat) const;
+
+    //! Get hash of all data
+    /*!
+    Return a hash over the formats present and their data.  Two
+    clipboards with the same digest hold the same data, so comparing
+    digests replaces comparing the marshalled data.
+    */
+    ContentHash digest() const;
+
     //@}
 
     // IClipboard overrides
     bool clear() override;
     void add(EFormat, const std::string& data) override;
+    void add_shared(EFormat, std::shared_ptr<const std::string> data) override;
     bool open(Time) const override;
     void close() const override;
     Time getTime() const override;
     bool has(EFormat) const override;
     std::string get(EFormat) const override;
+    std::shared_ptr<const std::string> get_shared(EFormat) const override;
 
 private:
     mutable bool m_open;
@@ -69,7 +113,9 @@ private:
     bool m_owner;
     Time m_timeOwned;
     bool m_added[kNumFormats];
-    std::string m_data[kNumFormats];
+    std::shared_ptr<const std::string> m_data[kNumFormats];   // never null
+    ContentHash hashes_[kNumFormats];
+    mutable std::shared_ptr<const std::string> marshalled_;
 };
 
 } // namespace inputleap
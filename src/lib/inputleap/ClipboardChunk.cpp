@@ -15,19 +15,26 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY CLIPBOARD
+
 #include "inputleap/ClipboardChunk.h"
 
+#include "inputleap/ChunkCodec.h"
 #include "inputleap/ProtocolUtil.h"
 #include "inputleap/protocol_types.h"
 #include "io/IStream.h"
 #include "base/Log.h"
 #include "base/String.h"
+#include <cassert>
 #include <cstring>
 
 namespace inputleap {
 
 size_t ClipboardChunk::s_expectedSize = 0;
 
+// kMsgDClipboard with the data passed as size and pointer
+static const char* const kMsgDClipboardView = "DCLP%1i%4i%1i%S";
+
 ClipboardChunk ClipboardChunk::start(ClipboardID id, std::uint32_t sequence,
                                      const std::size_t& size)
 {
@@ -40,13 +47,29 @@ ClipboardChunk ClipboardChunk::start(ClipboardID id, std::uint32_t sequence,
 }
 
 ClipboardChunk ClipboardChunk::data(ClipboardID id, std::uint32_t sequence,
-                                    const std::string& data)
+                                    std::shared_ptr<const std::string> buffer,
+                                    std::size_t offset, std::size_t size)
 {
+    assert(offset + size <= buffer->size());
+
     ClipboardChunk chunk;
     chunk.id_ = id;
     chunk.sequence_ = sequence;
     chunk.mark_ = kDataChunk;
-    chunk.data_ = data;
+    chunk.buffer_ = std::move(buffer);
+    chunk.offset_ = offset;
+    chunk.size_ = size;
+    return chunk;
+}
+
+ClipboardChunk ClipboardChunk::compressed(ClipboardID id, std::uint32_t sequence,
+                                          std::string payload)
+{
+    ClipboardChunk chunk;
+    chunk.id_ = id;
+    chunk.sequence_ = sequence;
+    chunk.mark_ = kDataCompressed;
+    chunk.data_ = std::move(payload);
     return chunk;
 }
 
@@ -59,6 +82,28 @@ ClipboardChunk ClipboardChunk::end(ClipboardID id, std::uint32_t sequence)
     return chunk;
 }
 
+const std::uint8_t* ClipboardChunk::payload() const
+{
+    if (buffer_) {
+        return reinterpret_cast<const std::uint8_t*>(buffer_->data() + offset_);
+    }
+    return reinterpret_cast<const std::uint8_t*>(data_.data());
+}
+
+std::uint32_t ClipboardChunk::payload_size() const
+{
+    if (buffer_) {
+        return static_cast<std::uint32_t>(size_);
+    }
+    return static_cast<std::uint32_t>(data_.size());
+}
+
+void ClipboardChunk::send(inputleap::IStream* stream) const
+{
+    ProtocolUtil::writef(stream, kMsgDClipboardView, id_, sequence_, mark_,
+                         payload_size(), payload());
+}
+
 int ClipboardChunk::assemble(inputleap::IStream* stream, std::string& dataCached,
                              ClipboardID& id, std::uint32_t& sequence)
 {
@@ -79,6 +124,14 @@ int ClipboardChunk::assemble(inputleap::IStream* stream, std::string& dataCached
         dataCached.append(data);
         return kNotFinish;
     }
+    else if (mark == kDataCompressed) {
+        if (!decompress_chunk(reinterpret_cast<const std::uint8_t*>(data.data()), data.size(),
+                              dataCached)) {
+            LOG_ERR("corrupted compressed clipboard data");
+            return kError;
+        }
+        return kNotFinish;
+    }
     else if (mark == kDataEnd) {
         // validate
         if (id >= kClipboardEnd) {
@@ -20,6 +20,7 @@
 #include "inputleap/clipboard_types.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #define CLIPBOARD_CHUNK_META_SIZE 7
@@ -32,19 +33,36 @@ class ClipboardChunk {
 public:
 
     static ClipboardChunk start(ClipboardID id, std::uint32_t sequence, const std::size_t& size);
-    static ClipboardChunk data(ClipboardID id, std::uint32_t sequence, const std::string& data);
+    static ClipboardChunk data(ClipboardID id, std::uint32_t sequence,
+                               std::shared_ptr<const std::string> buffer,
+                               std::size_t offset, std::size_t size);
+    static ClipboardChunk compressed(ClipboardID id, std::uint32_t sequence,
+                                     std::string payload);
     static ClipboardChunk end(ClipboardID id, std::uint32_t sequence);
 
     static int assemble(inputleap::IStream* stream, std::string& dataCached, ClipboardID& id,
                         std::uint32_t& sequence);
 
+    // write the chunk as a kMsgDClipboard message
+    void send(inputleap::IStream* stream) const;
+
     static size_t getExpectedSize() { return s_expectedSize; }
 
+    // the bytes to send in the message
+    const std::uint8_t* payload() const;
+    std::uint32_t payload_size() const;
+
     std::uint8_t id_ = 0;
     std::uint32_t sequence_ = 0;
     std::uint8_t mark_ = 0;
     std::string data_;
 
+    // data chunks refer to their part of the marshalled clipboard,
+    // which is shared by all chunks and all receivers
+    std::shared_ptr<const std::string> buffer_;
+    std::size_t offset_ = 0;
+    std::size_t size_ = 0;
+
 private:
     static size_t        s_expectedSize;
 };
@@ -0,0 +1,171 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define INPUTLEAP_LOG_CATEGORY CLIPBOARD
+
+#include "inputleap/ClipboardStreamer.h"
+
+#include "inputleap/IClipboard.h"
+#include "io/IStream.h"
+#include "base/Log.h"
+
+#include <algorithm>
+
+namespace inputleap {
+
+const std::size_t ClipboardStreamer::kChunkSize;
+const std::uint32_t ClipboardStreamer::kMaxPendingOutput;
+
+ClipboardStreamer::ClipboardStreamer(IStream* stream, ChunkWriter writer) :
+    stream_(stream),
+    writer_(std::move(writer))
+{
+}
+
+void ClipboardStreamer::send(std::shared_ptr<const std::string> data, ClipboardID id,
+                             std::uint32_t sequence)
+{
+    cancel(id);
+    transfers_.push_back(Transfer{std::move(data), id, sequence, Stage::kStart, 0});
+    pump();
+}
+
+void ClipboardStreamer::cancel(ClipboardID id)
+{
+    auto i = std::find_if(transfers_.begin(), transfers_.end(),
+                          [id](const Transfer& t) { return t.id == id; });
+    if (i != transfers_.end()) {
+        LOG_DEBUG("cancelled sending clipboard %d after %zd of %zd bytes",
+                  id, i->sent, i->data->size());
+        transfers_.erase(i);
+    }
+}
+
+ClipboardStreamer::Progress ClipboardStreamer::progress(ClipboardID id) const
+{
+    Progress progress;
+    for (const auto& transfer : transfers_) {
+        if (transfer.id == id) {
+            progress.sent = transfer.sent;
+            progress.size = transfer.data->size();
+        }
+    }
+    return progress;
+}
+
+void ClipboardStreamer::pump()
+{
+    while (!transfers_.empty() && stream_->getOutputSize() < kMaxPendingOutput) {
+        Transfer& transfer = transfers_.front();
+        const std::size_t size = transfer.data->size();
+
+        switch (transfer.stage) {
+        case Stage::kStart:
+            writer_(ClipboardChunk::start(transfer.id, transfer.sequence, size));
+            transfer.stage = Stage::kData;
+            compressor_.reset(codec_);
+            skipped_.clear();
+            if (codec_ != ChunkCodec::kNone) {
+                skipped_ = find_compressed_formats(*transfer.data);
+            }
+            break;
+
+        case Stage::kData: {
+            // an empty clipboard still gets one empty chunk
+            const std::size_t chunk_size = std::min(kChunkSize, size - transfer.sent);
+            send_data(transfer, chunk_size);
+            transfer.sent += chunk_size;
+            if (transfer.sent == size) {
+                transfer.stage = Stage::kEnd;
+            }
+            break;
+        }
+
+        case Stage::kEnd:
+            writer_(ClipboardChunk::end(transfer.id, transfer.sequence));
+            LOG_DEBUG("sent clipboard size=%zd", size);
+            if (codec_ != ChunkCodec::kNone) {
+                LOG_DEBUG("clipboard %d: %s", transfer.id, ChunkCompressor::describe(compressor_.stats()).c_str());
+            }
+            transfers_.pop_front();
+            break;
+        }
+    }
+}
+
+void ClipboardStreamer::send_data(Transfer& transfer, std::size_t size)
+{
+    const std::size_t begin = transfer.sent;
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(transfer.data->data()) + begin;
+
+    // leave chunks that are mostly PNG, JPEG or WebP alone
+    std::size_t skipped = 0;
+    for (const auto& range : skipped_) {
+        std::size_t first = std::max(begin, range.first);
+        std::size_t last = std::min(begin + size, range.second);
+        if (first < last) {
+            skipped += last - first;
+        }
+    }
+
+    if (compressor_.codec() != ChunkCodec::kNone && skipped * 2 < size) {
+        std::string payload;
+        if (compressor_.compress(data, size, payload)) {
+            writer_(ClipboardChunk::compressed(transfer.id, transfer.sequence,
+                                               std::move(payload)));
+            return;
+        }
+    } else {
+        compressor_.skip(size);
+    }
+
+    writer_(ClipboardChunk::data(transfer.id, transfer.sequence, transfer.data, begin, size));
+}
+
+std::vector<ClipboardStreamer::Range>
+ClipboardStreamer::find_compressed_formats(const std::string& data)
+{
+    // see IClipboard::marshall() for the layout
+    auto read_uint32 = [&data](std::size_t offset) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data()) + offset;
+        return (static_cast<std::uint32_t>(p[0]) << 24) | (static_cast<std::uint32_t>(p[1]) << 16) |
+               (static_cast<std::uint32_t>(p[2]) << 8) | static_cast<std::uint32_t>(p[3]);
+    };
+
+    std::vector<Range> ranges;
+    if (data.size() < 4) {
+        return ranges;
+    }
+    std::uint32_t count = read_uint32(0);
+    std::size_t offset = 4;
+    for (std::uint32_t i = 0; i < count && offset + 8 <= data.size(); ++i) {
+        std::uint32_t format = read_uint32(offset);
+        std::size_t size = read_uint32(offset + 4);
+        offset += 8;
+        if (size > data.size() - offset) {
+            break;
+        }
+        if (format == IClipboard::kPNG || format == IClipboard::kJpeg ||
+                format == IClipboard::kWebp) {
+            ranges.emplace_back(offset, offset + size);
+        }
+        offset += size;
+    }
+    return ranges;
+}
+
+} // namespace inputleap
@@ -0,0 +1,146 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "inputleap/ChunkCodec.h"
+#include "inputleap/ClipboardChunk.h"
+#include "inputleap/clipboard_types.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace inputleap {
+
+class IStream;
+
+//! Flow controlled clipboard sender
+/*!
+Sends marshalled clipboards over a stream as kMsgDClipboard chunks.
+Chunks are made one at a time, only while fewer than
+\c kMaxPendingOutput bytes wait in the stream's output buffer.  The
+owner calls pump() when the stream reports \c STREAM_OUTPUT_FLUSHED to
+resume sending.  So a clipboard of any size needs at most a few chunks
+of memory beyond the shared clipboard buffer itself.
+
+Once a codec is set, chunks are compressed when that pays off.  Image
+formats that are compressed already are sent as they are.
+
+Clipboards are sent one after another because the receiver assembles
+one at a time.  Sending a clipboard replaces the one with the same id
+that is waiting or being sent.
+*/
+class ClipboardStreamer {
+public:
+    //! Writes a chunk to the stream
+    using ChunkWriter = std::function<void(const ClipboardChunk&)>;
+
+    //! How much of a clipboard was sent
+    struct Progress {
+        std::size_t sent = 0;
+        std::size_t size = 0;
+    };
+
+    static const std::size_t kChunkSize = 32 * 1024;
+    static const std::uint32_t kMaxPendingOutput = 64 * 1024;
+
+    //! Send to \p stream via \p writer
+    ClipboardStreamer(IStream* stream, ChunkWriter writer);
+    ClipboardStreamer(const ClipboardStreamer&) = delete;
+    ClipboardStreamer& operator=(const ClipboardStreamer&) = delete;
+
+    //! @name manipulators
+    //@{
+
+    //! Queue a clipboard
+    /*!
+    Queues the marshalled clipboard \p data for sending and sends as
+    much of it as the stream takes right away.
+    */
+    void send(std::shared_ptr<const std::string> data, ClipboardID id,
+              std::uint32_t sequence);
+
+    //! Compress with \p codec
+    /*!
+    Set after the peer told which codecs it can decompress.  Applies
+    from the next clipboard on.
+    */
+    void set_codec(ChunkCodec codec) { codec_ = codec; }
+
+    //! Cancel sending a clipboard
+    /*!
+    Drops clipboard \p id if it's waiting or being sent.  A partly
+    sent clipboard is discarded by the receiver when the next one
+    starts.
+    */
+    void cancel(ClipboardID id);
+
+    //! Send more chunks
+    /*!
+    Writes chunks while the stream has room.  Call this whenever the
+    stream's output buffer drains.
+    */
+    void pump();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Test if any clipboard is waiting or being sent
+    bool is_sending() const { return !transfers_.empty(); }
+
+    //! Get progress
+    /*!
+    Returns how much of clipboard \p id was sent, or zeros if it's
+    not waiting or being sent.
+    */
+    Progress progress(ClipboardID id) const;
+
+    //@}
+
+private:
+    enum class Stage { kStart, kData, kEnd };
+
+    struct Transfer {
+        std::shared_ptr<const std::string> data;
+        ClipboardID id;
+        std::uint32_t sequence;
+        Stage stage;
+        std::size_t sent;
+    };
+
+    // the data of compressed image formats in a marshalled clipboard
+    using Range = std::pair<std::size_t, std::size_t>;
+    static std::vector<Range> find_compressed_formats(const std::string& data);
+
+    void send_data(Transfer& transfer, std::size_t size);
+
+    IStream* stream_;
+    ChunkWriter writer_;
+    std::deque<Transfer> transfers_;
+
+    ChunkCodec codec_ = ChunkCodec::kNone;
+    ChunkCompressor compressor_;
+    std::vector<Range> skipped_;
+};
+
+} // namespace inputleap
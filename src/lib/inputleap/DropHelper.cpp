@@ -17,42 +17,88 @@
 
 #include "inputleap/DropHelper.h"
 
+#include "inputleap/Screen.h"
 #include "base/Log.h"
 #include "io/filesystem.h"
 
-#include <fstream>
+#include <algorithm>
 
 namespace inputleap {
 
-void
-DropHelper::writeToDir(const std::string& destination, DragFileList& fileList, std::string& data)
+namespace {
+
+bool move_file(const fs::path& received, const fs::path& dropTarget, std::error_code& error)
 {
-    LOG_DEBUG("dropping file, files=%zi target=%s", fileList.size(), destination.c_str());
+    // usually received in the drop directory already
+    fs::rename(received, dropTarget, error);
+    if (error) {
+        // the received file is on another file system.  copy it next
+        // to the target first so the target still appears in one step.
+        fs::path partial = dropTarget;
+        partial += ".part";
+        error.clear();
+        fs::copy_file(received, partial, fs::copy_options::overwrite_existing, error);
+        if (!error) {
+            fs::rename(partial, dropTarget, error);
+        }
+        if (error) {
+            std::error_code ignored;
+            fs::remove(partial, ignored);
+        }
+    }
+    return !error;
+}
 
-    if (!destination.empty() && fileList.size() > 0) {
-        std::fstream file;
-        std::string dropTarget = destination;
-#ifdef SYSAPI_WIN32
-        dropTarget.append("\\");
+} // namespace
+
+fs::path DropHelper::receive_directory(Screen* screen)
+{
+#if defined(__APPLE__)
+    // the drop target is only known once the fake drag has been dropped
+    (void) screen;
 #else
-        dropTarget.append("/");
+    const std::string& destination = screen->getDropTarget();
+    std::error_code error;
+    if (!destination.empty() && fs::is_directory(fs::u8path(destination), error)) {
+        return fs::u8path(destination);
+    }
 #endif
-        dropTarget.append(fileList.at(0).getFilename());
-        open_utf8_path(file, dropTarget, std::ios::out | std::ios::binary);
-        if (!file.is_open()) {
-            LOG_ERR("drop file failed: can not open %s", dropTarget.c_str());
-        }
+    return fs::temp_directory_path();
+}
 
-        file.write(data.c_str(), data.size());
-        file.close();
+void
+DropHelper::writeToDir(const std::string& destination, DragFileList& fileList,
+                       const std::vector<fs::path>& received)
+{
+    LOG_DEBUG("dropping files, files=%zi received=%zi target=%s", fileList.size(),
+              received.size(), destination.c_str());
 
-        LOG_INFO("dropped file \"%s\" in \"%s\"", fileList.at(0).getFilename().c_str(), destination.c_str());
+    if (!destination.empty() && fileList.size() > 0) {
+        std::size_t count = std::min(fileList.size(), received.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::string& filename = fileList.at(i).getFilename();
+            fs::path dropTarget = fs::u8path(destination) / fs::u8path(filename);
+
+            std::error_code error;
+            if (move_file(received[i], dropTarget, error)) {
+                LOG_INFO("dropped file \"%s\" in \"%s\"", filename.c_str(), destination.c_str());
+            } else {
+                LOG_ERR("drop file failed: can not write %s: %s", dropTarget.u8string().c_str(),
+                        error.message().c_str());
+            }
+        }
 
         fileList.clear();
     }
     else {
         LOG_ERR("drop file failed: drop target is empty");
     }
+
+    // whatever wasn't moved
+    for (const auto& path : received) {
+        std::error_code ignored;
+        fs::remove(path, ignored);
+    }
 }
 
 } // namespace inputleap
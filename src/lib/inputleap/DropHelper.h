@@ -18,14 +18,27 @@
 #pragma once
 
 #include "inputleap/DragInformation.h"
+#include "io/filesystem.h"
 #include <string>
+#include <vector>
 
 namespace inputleap {
 
+class Screen;
+
 class DropHelper {
 public:
-    static void writeToDir(const std::string& destination,
-                           DragFileList& fileList, std::string& data);
+    // the directory to receive dropped files into.  that's the drop
+    // target of screen when it's known before the files arrive, so they
+    // only need to be renamed into place, and a temporary directory
+    // otherwise.
+    static fs::path receive_directory(Screen* screen);
+
+    // moves the received files to the destination directory, each
+    // named after the file of fileList at the same position.  every
+    // file appears there complete or not at all.
+    static void writeToDir(const std::string& destination, DragFileList& fileList,
+                           const std::vector<fs::path>& received);
 };
 
 } // namespace inputleap
@@ -20,13 +20,11 @@
 #include "inputleap/ProtocolUtil.h"
 #include "inputleap/protocol_types.h"
 #include "io/IStream.h"
-#include "base/Stopwatch.h"
-#include "base/String.h"
-#include "base/Log.h"
 
 namespace inputleap {
 
-static const std::uint16_t kIntervalThreshold = 1;
+// kMsgDFileTransfer with the data passed as size and pointer
+static const char* const kMsgDFileTransferView = "DFTR%1i%S";
 
 FileChunk FileChunk::start(std::size_t size)
 {
@@ -36,11 +34,19 @@ FileChunk FileChunk::start(std::size_t size)
     return chunk;
 }
 
-FileChunk FileChunk::data(std::uint8_t* data, size_t dataSize)
+FileChunk FileChunk::data(const std::uint8_t* data, size_t dataSize)
 {
     FileChunk chunk;
     chunk.mark_ = kDataChunk;
-    chunk.data_ = std::string(reinterpret_cast<char*>(data), dataSize);
+    chunk.view_ = data;
+    chunk.view_size_ = dataSize;
+    return chunk;
+}
+
+FileChunk FileChunk::compressed(const std::uint8_t* payload, size_t size)
+{
+    FileChunk chunk = data(payload, size);
+    chunk.mark_ = kDataCompressed;
     return chunk;
 }
 
@@ -51,71 +57,25 @@ FileChunk FileChunk::end()
     return chunk;
 }
 
-int FileChunk::assemble(inputleap::IStream* stream, std::string& dataReceived, size_t& expectedSize)
+void FileChunk::send(inputleap::IStream* stream) const
 {
-    // parse
-    std::uint8_t mark = 0;
-    std::string content;
-    static size_t receivedDataSize;
-    static double elapsedTime;
-    static Stopwatch stopwatch;
+    ProtocolUtil::writef(stream, kMsgDFileTransferView, mark_, payload_size(), payload());
+}
 
-    if (!ProtocolUtil::readf(stream, kMsgDFileTransfer + 4, &mark, &content)) {
-        return kError;
+const std::uint8_t* FileChunk::payload() const
+{
+    if (view_ != nullptr) {
+        return view_;
     }
+    return reinterpret_cast<const std::uint8_t*>(data_.data());
+}
 
-    switch (mark) {
-    case kDataStart:
-        dataReceived.clear();
-        expectedSize = inputleap::string::stringToSizeType(content);
-        receivedDataSize = 0;
-        elapsedTime = 0;
-        stopwatch.reset();
-
-        if (CLOG->getFilter() >= kDEBUG2) {
-            LOG_DEBUG2("recv file size=%s", content.c_str());
-            stopwatch.start();
-        }
-        return kStart;
-
-    case kDataChunk:
-        dataReceived.append(content);
-        if (CLOG->getFilter() >= kDEBUG2) {
-                LOG_DEBUG2("recv file chunk size=%zi", content.size());
-                double interval = stopwatch.getTime();
-                receivedDataSize += content.size();
-                LOG_DEBUG2("recv file interval=%f s", interval);
-                if (interval >= kIntervalThreshold) {
-                    double averageSpeed = receivedDataSize / interval / 1000;
-                    LOG_DEBUG2("recv file average speed=%f kb/s", averageSpeed);
-
-                    receivedDataSize = 0;
-                    elapsedTime += interval;
-                    stopwatch.reset();
-                }
-            }
-        return kNotFinish;
-
-    case kDataEnd:
-        if (expectedSize != dataReceived.size()) {
-            LOG_ERR("corrupted clipboard data, expected size=%zd actual size=%zd", expectedSize, dataReceived.size());
-            return kError;
-        }
-
-        if (CLOG->getFilter() >= kDEBUG2) {
-            LOG_DEBUG2("file transfer finished");
-            elapsedTime += stopwatch.getTime();
-            double averageSpeed = expectedSize / elapsedTime / 1000;
-            LOG_DEBUG2("file transfer finished: total time consumed=%f s", elapsedTime);
-            LOG_DEBUG2("file transfer finished: total data received=%zi kb", expectedSize / 1000);
-            LOG_DEBUG2("file transfer finished: total average speed=%f kb/s", averageSpeed);
-        }
-        return kFinish;
-        default:
-            break;
+std::uint32_t FileChunk::payload_size() const
+{
+    if (view_ != nullptr) {
+        return static_cast<std::uint32_t>(view_size_);
     }
-
-    return kError;
+    return static_cast<std::uint32_t>(data_.size());
 }
 
 } // namespace inputleap
@@ -29,12 +29,25 @@ class IStream;
 class FileChunk {
 public:
     static FileChunk start(std::size_t size);
-    static FileChunk data(std::uint8_t* data, size_t dataSize);
+    static FileChunk data(const std::uint8_t* data, size_t dataSize);
+    // a kDataCompressed chunk;  refers to the payload like data()
+    static FileChunk compressed(const std::uint8_t* payload, size_t size);
     static FileChunk end();
-    static int assemble(inputleap::IStream* stream, std::string& dataCached, size_t& expectedSize);
+
+    // write the chunk as a kMsgDFileTransfer message
+    void send(inputleap::IStream* stream) const;
+
+    // the bytes to send in the message
+    const std::uint8_t* payload() const;
+    std::uint32_t payload_size() const;
 
     std::uint8_t mark_ = 0;
     std::string data_;
+
+    // data chunks refer to the sender's buffer instead of copying it,
+    // so they must be sent before the buffer is reused
+    const std::uint8_t* view_ = nullptr;
+    std::size_t view_size_ = 0;
 };
 
 } // namespace inputleap
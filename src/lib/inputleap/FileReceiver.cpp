@@ -0,0 +1,199 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/FileReceiver.h"
+
+#include "config.h"
+#include "inputleap/ChunkCodec.h"
+#include "inputleap/ProtocolUtil.h"
+#include "inputleap/protocol_types.h"
+#include "io/IStream.h"
+#include "base/String.h"
+#include "base/Log.h"
+
+#include <atomic>
+#include <cerrno>
+
+#if HAVE_POSIX_FALLOCATE
+#include <fcntl.h>
+#endif
+
+namespace inputleap {
+
+FileReceiver::FileReceiver(const fs::path& directory) :
+    directory_(directory)
+{
+}
+
+FileReceiver::~FileReceiver()
+{
+    close_and_remove();
+}
+
+int FileReceiver::receive(IStream* stream)
+{
+    std::uint8_t mark = 0;
+    if (!ProtocolUtil::readf(stream, kMsgDFileTransfer + 4, &mark, &content_)) {
+        return kError;
+    }
+
+    switch (mark) {
+    case kDataStart:
+        close_and_remove();
+        expected_size_ = string::stringToSizeType(content_);
+        received_size_ = 0;
+        complete_ = false;
+        stopwatch_.reset();
+        LOG_DEBUG2("recv file size=%s", content_.c_str());
+        return open(expected_size_) ? kStart : kError;
+
+    case kDataChunk:
+        if (file_ == nullptr) {
+            // the start failed or never came
+            return kError;
+        }
+        if (!write(content_)) {
+            return kError;
+        }
+        LOG_DEBUG2("recv file chunk size=%zi", content_.size());
+        return kNotFinish;
+
+    case kDataCompressed:
+        if (file_ == nullptr) {
+            return kError;
+        }
+        inflated_.clear();
+        if (!decompress_chunk(reinterpret_cast<const std::uint8_t*>(content_.data()),
+                              content_.size(), inflated_)) {
+            LOG_ERR("corrupted compressed file data");
+            close_and_remove();
+            return kError;
+        }
+        if (!write(inflated_)) {
+            return kError;
+        }
+        LOG_DEBUG2("recv compressed file chunk size=%zi", content_.size());
+        return kNotFinish;
+
+    case kDataEnd: {
+        if (file_ == nullptr) {
+            return kError;
+        }
+        bool closed = std::fclose(file_) == 0;
+        file_ = nullptr;
+        if (!closed) {
+            LOG_ERR("failed to write received file %s", path_.u8string().c_str());
+            close_and_remove();
+            return kError;
+        }
+        if (received_size_ != expected_size_) {
+            LOG_WARN("file transfer incomplete, expected size=%llu actual size=%llu",
+                     static_cast<unsigned long long>(expected_size_),
+                     static_cast<unsigned long long>(received_size_));
+            close_and_remove();
+            return kError;
+        }
+
+        complete_ = true;
+        double elapsed = stopwatch_.getTime();
+        LOG_DEBUG("received file: %llu bytes in %.2f s (%.1f MB/s)",
+                  static_cast<unsigned long long>(received_size_), elapsed,
+                  elapsed > 0.0 ? received_size_ / elapsed / (1024 * 1024) : 0.0);
+        return kFinish;
+    }
+
+    default:
+        break;
+    }
+
+    return kError;
+}
+
+bool FileReceiver::write(const std::string& data)
+{
+    // don't let the sender fill the disk past what it announced
+    if (data.size() > expected_size_ - received_size_) {
+        LOG_WARN("file transfer exceeds expected size=%llu",
+                 static_cast<unsigned long long>(expected_size_));
+        close_and_remove();
+        return false;
+    }
+    if (std::fwrite(data.data(), 1, data.size(), file_) != data.size()) {
+        LOG_ERR("failed to write received file %s", path_.u8string().c_str());
+        close_and_remove();
+        return false;
+    }
+    received_size_ += data.size();
+    return true;
+}
+
+fs::path FileReceiver::take_file()
+{
+    fs::path path;
+    if (complete_) {
+        path.swap(path_);
+        complete_ = false;
+    }
+    return path;
+}
+
+bool FileReceiver::open(std::uint64_t size)
+{
+    // a name nobody else uses;  "x" fails if the file exists
+    static std::atomic<unsigned> counter{0};
+    for (int attempt = 0; attempt < 100 && file_ == nullptr; ++attempt) {
+        path_ = directory_ / fs::u8path("inputleap-drop-" + std::to_string(++counter) + ".part");
+        file_ = fopen_utf8_path(path_, "wbx");
+    }
+    if (file_ == nullptr) {
+        LOG_ERR("failed to create a file to receive into in %s", directory_.u8string().c_str());
+        path_.clear();
+        return false;
+    }
+
+#if HAVE_POSIX_FALLOCATE
+    if (size > 0) {
+        // other errors just mean the file system can't preallocate
+        if (posix_fallocate(fileno(file_), 0, static_cast<off_t>(size)) == ENOSPC) {
+            LOG_ERR("not enough space to receive a file of %llu bytes",
+                    static_cast<unsigned long long>(size));
+            close_and_remove();
+            return false;
+        }
+    }
+#else
+    (void) size;
+#endif
+
+    return true;
+}
+
+void FileReceiver::close_and_remove()
+{
+    if (file_ != nullptr) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    if (!path_.empty()) {
+        std::error_code error;
+        fs::remove(path_, error);
+        path_.clear();
+    }
+    complete_ = false;
+}
+
+} // namespace inputleap
@@ -0,0 +1,112 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "io/filesystem.h"
+#include "base/Stopwatch.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace inputleap {
+
+class IStream;
+
+//! Receives a dragged file to disk
+/*!
+Writes the chunks of a kMsgDFileTransfer transfer to a temporary file
+as they arrive, so receiving a file needs the same small amount of
+memory whatever its size.  The file is preallocated where the platform
+supports it, so a full disk fails the transfer at the start instead of
+half way.  The completed file is handed over with take_file();  a
+file that's not taken is deleted.
+
+Receive into the drop directory when it's known before the transfer,
+so the finished file only has to be renamed there.
+*/
+class FileReceiver {
+public:
+    //! Receive into temporary files in \p directory
+    explicit FileReceiver(const fs::path& directory = fs::temp_directory_path());
+    FileReceiver(const FileReceiver&) = delete;
+    FileReceiver& operator=(const FileReceiver&) = delete;
+    ~FileReceiver();
+
+    //! @name manipulators
+    //@{
+
+    //! Set the directory to receive into
+    /*!
+    Files started after this call are written in \p directory.
+    */
+    void set_directory(const fs::path& directory) { directory_ = directory; }
+
+    //! Read a chunk
+    /*!
+    Reads the body of a kMsgDFileTransfer message from \p stream and
+    writes it out.  Returns \c kStart, \c kNotFinish or \c kFinish
+    (see protocol_types.h), or \c kError if the message is bad, the
+    file can't be written or it doesn't have the announced size.  A
+    chunk that would go past the announced size fails the transfer at
+    once.
+    */
+    int receive(IStream* stream);
+
+    //! Take the received file
+    /*!
+    Returns the path of the completely received file and leaves it to
+    the caller, or an empty path if no file was received since the
+    last call.
+    */
+    fs::path take_file();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Returns the size announced by the sender
+    std::uint64_t expected_size() const { return expected_size_; }
+
+    //! Returns the number of bytes received so far
+    std::uint64_t received_size() const { return received_size_; }
+
+    //! Test if the last transfer is complete and has the announced size
+    bool is_complete() const { return complete_; }
+
+    //@}
+
+private:
+    bool open(std::uint64_t size);
+    bool write(const std::string& data);
+    void close_and_remove();
+
+    fs::path directory_;
+    fs::path path_;
+    std::FILE* file_ = nullptr;
+    std::uint64_t expected_size_ = 0;
+    std::uint64_t received_size_ = 0;
+    bool complete_ = false;
+
+    // reused for every chunk
+    std::string content_;
+    std::string inflated_;
+    Stopwatch stopwatch_;
+};
+
+} // namespace inputleap
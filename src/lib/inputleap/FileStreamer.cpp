@@ -0,0 +1,350 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/FileStreamer.h"
+
+#include "io/IStream.h"
+#include "io/filesystem.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+
+namespace inputleap {
+
+const std::size_t FileStreamer::kChunkSize;
+const std::size_t FileStreamer::kReadAheadChunks;
+const std::size_t FileStreamer::kPipelineDepth;
+const std::uint32_t FileStreamer::kMaxPendingOutput;
+
+struct FileStreamer::Transfer {
+    ~Transfer()
+    {
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    std::string filename;
+    std::uint64_t size = 0;
+    Stage stage = Stage::kStart;
+    std::uint64_t sent = 0;
+    bool opened = false;
+    std::FILE* file = nullptr;
+    std::vector<Buffer> buffers;
+
+    // only touched by the read job
+    std::uint64_t read = 0;
+    ChunkCompressor compressor;
+
+    // guards the buffer queues and the flags shared with the read job
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::deque<Buffer*> free;
+    std::deque<Buffer*> filled;
+    bool reading = false;
+    bool read_done = false;
+    bool stopped = false;
+    bool waiting = false;
+};
+
+FileStreamer::FileStreamer(IEventQueue* events, IStream* stream, ChunkWriter writer) :
+    events_(events),
+    stream_(stream),
+    writer_(std::move(writer)),
+    readers_(kPipelineDepth)
+{
+    // a read job posts this when it fills a buffer the sender waits for
+    events_->add_handler(EventType::FILE_CHUNK_SENDING, this,
+                         [this](const auto& e){ pump(); });
+}
+
+FileStreamer::~FileStreamer()
+{
+    for (auto& transfer : transfers_) {
+        stop(*transfer);
+    }
+    events_->remove_handler(EventType::FILE_CHUNK_SENDING, this);
+}
+
+bool FileStreamer::send(const std::vector<std::string>& filenames)
+{
+    cancel();
+
+    for (const auto& filename : filenames) {
+        std::error_code error;
+        std::uint64_t size = fs::file_size(fs::u8path(filename), error);
+        if (error) {
+            LOG_ERR("failed to open file to send: %s", filename.c_str());
+            continue;
+        }
+
+        auto transfer = std::make_shared<Transfer>();
+        transfer->filename = filename;
+        transfer->size = size;
+        transfers_.push_back(transfer);
+        progress_.size += size;
+        ++progress_.file_count;
+    }
+
+    LOG_DEBUG("sending %zu files, size=%llu", progress_.file_count,
+              static_cast<unsigned long long>(progress_.size));
+    stopwatch_.reset();
+    compression_ = ChunkCompressor::Stats();
+    fill_pipeline();
+    bool sending = !transfers_.empty();
+    pump();
+    return sending;
+}
+
+void FileStreamer::cancel()
+{
+    if (transfers_.empty()) {
+        progress_ = Progress();
+        return;
+    }
+
+    bool announced = transfers_.front()->stage != Stage::kStart;
+    for (auto& transfer : transfers_) {
+        stop(*transfer);
+    }
+    transfers_.clear();
+    if (announced) {
+        writer_(FileChunk::end());
+    }
+
+    LOG_DEBUG("file transmission interrupted after %zu of %zu files, %llu of %llu bytes",
+              progress_.files_sent, progress_.file_count,
+              static_cast<unsigned long long>(progress_.sent),
+              static_cast<unsigned long long>(progress_.size));
+    progress_ = Progress();
+}
+
+void FileStreamer::pump()
+{
+    while (!transfers_.empty() && stream_->getOutputSize() < kMaxPendingOutput) {
+        std::shared_ptr<Transfer> transfer = transfers_.front();
+
+        switch (transfer->stage) {
+        case Stage::kStart:
+            writer_(FileChunk::start(transfer->size));
+            transfer->stage = transfer->size > 0 ? Stage::kData : Stage::kEnd;
+            break;
+
+        case Stage::kData: {
+            Buffer* buffer = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(transfer->mutex);
+                if (!transfer->filled.empty()) {
+                    buffer = transfer->filled.front();
+                    transfer->filled.pop_front();
+                } else if (!transfer->read_done) {
+                    // the read job posts an event when it has more
+                    transfer->waiting = true;
+                    return;
+                }
+            }
+
+            if (buffer == nullptr) {
+                LOG_WARN("file %s was truncated while sending", transfer->filename.c_str());
+                transfer->stage = Stage::kEnd;
+                break;
+            }
+
+            if (buffer->compressed) {
+                writer_(FileChunk::compressed(
+                            reinterpret_cast<const std::uint8_t*>(buffer->packed.data()),
+                            buffer->packed.size()));
+            } else {
+                writer_(FileChunk::data(buffer->data.data(), buffer->size));
+            }
+            transfer->sent += buffer->size;
+            progress_.sent += buffer->size;
+
+            {
+                std::lock_guard<std::mutex> lock(transfer->mutex);
+                transfer->free.push_back(buffer);
+            }
+            schedule_read(transfer);
+
+            if (transfer->sent == transfer->size) {
+                transfer->stage = Stage::kEnd;
+            }
+            break;
+        }
+
+        case Stage::kEnd:
+            writer_(FileChunk::end());
+            LOG_DEBUG("sent file %s, size=%llu", transfer->filename.c_str(),
+                      static_cast<unsigned long long>(transfer->sent));
+            stop(*transfer);
+            transfers_.pop_front();
+            ++progress_.files_sent;
+            compression_.raw_size += transfer->compressor.stats().raw_size;
+            compression_.sent_size += transfer->compressor.stats().sent_size;
+            compression_.seconds += transfer->compressor.stats().seconds;
+
+            if (transfers_.empty()) {
+                double elapsed = stopwatch_.getTime();
+                LOG_INFO("sent %zu files: %llu bytes in %.2f s (%.1f MB/s)",
+                         progress_.files_sent, static_cast<unsigned long long>(progress_.sent),
+                         elapsed,
+                         elapsed > 0.0 ? progress_.sent / elapsed / (1024 * 1024) : 0.0);
+                if (codec_ != ChunkCodec::kNone) {
+                    LOG_INFO("compressed files: %s",
+                             ChunkCompressor::describe(compression_).c_str());
+                }
+                progress_ = Progress();
+            } else {
+                fill_pipeline();
+            }
+            break;
+        }
+    }
+}
+
+FileStreamer::Progress FileStreamer::progress() const
+{
+    return progress_;
+}
+
+void FileStreamer::fill_pipeline()
+{
+    std::size_t i = 0;
+    while (i < transfers_.size() && i < kPipelineDepth) {
+        auto transfer = transfers_[i];
+        if (transfer->opened) {
+            ++i;
+        } else if (open(*transfer)) {
+            schedule_read(transfer);
+            ++i;
+        } else {
+            progress_.size -= transfer->size;
+            --progress_.file_count;
+            transfers_.erase(transfers_.begin() + i);
+        }
+    }
+}
+
+bool FileStreamer::open(Transfer& transfer)
+{
+    transfer.file = fopen_utf8_path(fs::u8path(transfer.filename), "rb");
+    if (transfer.file == nullptr) {
+        LOG_ERR("failed to open file to send: %s", transfer.filename.c_str());
+        return false;
+    }
+    transfer.opened = true;
+
+    transfer.buffers.resize(kReadAheadChunks);
+    for (auto& buffer : transfer.buffers) {
+        if (!spare_buffers_.empty()) {
+            buffer = std::move(spare_buffers_.back());
+            spare_buffers_.pop_back();
+        } else {
+            buffer.data.resize(kChunkSize);
+        }
+        transfer.free.push_back(&buffer);
+    }
+    transfer.read_done = transfer.size == 0;
+    transfer.compressor.reset(codec_);
+    return true;
+}
+
+void FileStreamer::schedule_read(const std::shared_ptr<Transfer>& transfer)
+{
+    {
+        std::lock_guard<std::mutex> lock(transfer->mutex);
+        if (transfer->reading || transfer->read_done || transfer->stopped ||
+                transfer->free.empty()) {
+            return;
+        }
+        transfer->reading = true;
+    }
+    readers_.run([this, transfer]() { read(transfer); });
+}
+
+void FileStreamer::read(const std::shared_ptr<Transfer>& transfer)
+{
+    for (;;) {
+        Buffer* buffer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(transfer->mutex);
+            if (transfer->stopped || transfer->free.empty()) {
+                // more is read when the sender frees a buffer
+                transfer->reading = false;
+                transfer->idle.notify_all();
+                return;
+            }
+            buffer = transfer->free.front();
+            transfer->free.pop_front();
+        }
+
+        // read sequentially;  the file isn't touched by anything else
+        std::size_t wanted = static_cast<std::size_t>(
+                    std::min<std::uint64_t>(transfer->size - transfer->read, buffer->data.size()));
+        buffer->size = std::fread(buffer->data.data(), 1, wanted, transfer->file);
+        if (transfer->read == 0 && is_compressed_format(buffer->data.data(), buffer->size)) {
+            transfer->compressor.give_up();
+        }
+        transfer->read += buffer->size;
+        buffer->compressed = transfer->compressor.compress(buffer->data.data(), buffer->size,
+                                                           buffer->packed);
+        bool done = buffer->size < wanted || transfer->read == transfer->size;
+
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(transfer->mutex);
+            if (buffer->size > 0) {
+                transfer->filled.push_back(buffer);
+            } else {
+                transfer->free.push_back(buffer);
+            }
+            transfer->read_done = done;
+            notify = transfer->waiting;
+            transfer->waiting = false;
+        }
+        if (notify) {
+            events_->add_event(EventType::FILE_CHUNK_SENDING, this);
+        }
+
+        if (done) {
+            std::lock_guard<std::mutex> lock(transfer->mutex);
+            transfer->reading = false;
+            transfer->idle.notify_all();
+            return;
+        }
+    }
+}
+
+void FileStreamer::stop(Transfer& transfer)
+{
+    {
+        std::unique_lock<std::mutex> lock(transfer.mutex);
+        transfer.stopped = true;
+        transfer.idle.wait(lock, [&transfer]() { return !transfer.reading; });
+    }
+
+    for (auto& buffer : transfer.buffers) {
+        spare_buffers_.push_back(std::move(buffer));
+    }
+    transfer.buffers.clear();
+}
+
+} // namespace inputleap
@@ -0,0 +1,180 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "inputleap/ChunkCodec.h"
+#include "inputleap/FileChunk.h"
+#include "mt/WorkerPool.h"
+#include "base/EventTarget.h"
+#include "base/Fwd.h"
+#include "base/Stopwatch.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inputleap {
+
+class IStream;
+
+//! Flow controlled file sender
+/*!
+Sends files over a stream as kMsgDFileTransfer transfers, one after
+another.  Files are read sequentially on a small pool of reused worker
+threads, up to \c kReadAheadChunks chunks ahead, into buffers that are
+allocated once and reused for every chunk and every file.  The next
+\c kPipelineDepth - 1 files are opened and read ahead while the current
+one is sent, so disk reads overlap socket writes across files too.
+
+Chunks are written only while fewer than \c kMaxPendingOutput bytes
+wait in the stream's output buffer.  The owner calls pump() when the
+stream reports \c STREAM_OUTPUT_FLUSHED to resume sending.  So files of
+any size need a fixed amount of memory and never flood the event
+queue.
+
+Once a codec is set, the readers also compress the chunks when that
+pays off.  Files that start like an image or archive format are sent as
+they are.
+
+Sending files cancels the files being sent.
+*/
+class FileStreamer : public EventTarget {
+public:
+    //! Writes a chunk to the stream
+    /*!
+    Data chunks refer to the streamer's buffers, which are reused as
+    soon as the writer returns.
+    */
+    using ChunkWriter = std::function<void(const FileChunk&)>;
+
+    //! How much of the files was sent
+    struct Progress {
+        std::size_t files_sent = 0;
+        std::size_t file_count = 0;
+        std::uint64_t sent = 0;
+        std::uint64_t size = 0;
+    };
+
+    static const std::size_t kChunkSize = 32 * 1024;
+    static const std::size_t kReadAheadChunks = 4;
+    static const std::size_t kPipelineDepth = 2;
+    static const std::uint32_t kMaxPendingOutput = 64 * 1024;
+
+    //! Send to \p stream via \p writer
+    FileStreamer(IEventQueue* events, IStream* stream, ChunkWriter writer);
+    FileStreamer(const FileStreamer&) = delete;
+    FileStreamer& operator=(const FileStreamer&) = delete;
+    ~FileStreamer();
+
+    //! @name manipulators
+    //@{
+
+    //! Send files
+    /*!
+    Cancels the files being sent, if any, and starts sending
+    \p filenames in order.  Files that can't be opened are skipped.
+    Returns false if none can be opened.
+    */
+    bool send(const std::vector<std::string>& filenames);
+
+    //! Compress with \p codec
+    /*!
+    Set after the peer told which codecs it can decompress.  Applies
+    from the next files on.
+    */
+    void set_codec(ChunkCodec codec) { codec_ = codec; }
+
+    //! Cancel sending
+    /*!
+    Stops sending the current file and drops the queued ones.  If the
+    receiver was told about the current file it's sent the end of the
+    transfer so it discards what it got.
+    */
+    void cancel();
+
+    //! Send more chunks
+    /*!
+    Writes chunks while the stream has room and the readers have data.
+    Call this whenever the stream's output buffer drains.
+    */
+    void pump();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Test if files are being sent
+    bool is_sending() const { return !transfers_.empty(); }
+
+    //! Get progress
+    /*!
+    Returns how many of the files and bytes being sent were sent, or
+    zeros if no files are being sent.
+    */
+    Progress progress() const;
+
+    //@}
+
+private:
+    enum class Stage { kStart, kData, kEnd };
+
+    struct Buffer {
+        std::vector<std::uint8_t> data;
+        std::size_t size = 0;
+
+        // the kDataCompressed payload when the chunk is compressed
+        std::string packed;
+        bool compressed = false;
+    };
+
+    struct Transfer;
+
+    // open the files at the front of the queue and start reading them
+    void fill_pipeline();
+    bool open(Transfer& transfer);
+
+    // queue a read job if the transfer has free buffers
+    void schedule_read(const std::shared_ptr<Transfer>& transfer);
+
+    // read job
+    void read(const std::shared_ptr<Transfer>& transfer);
+
+    // stop reading a transfer and take back its buffers
+    void stop(Transfer& transfer);
+
+    IEventQueue* events_;
+    IStream* stream_;
+    ChunkWriter writer_;
+
+    std::deque<std::shared_ptr<Transfer>> transfers_;
+    Progress progress_;
+    Stopwatch stopwatch_;
+
+    ChunkCodec codec_ = ChunkCodec::kNone;
+    ChunkCompressor::Stats compression_;
+
+    // buffers of finished transfers, reused by the next ones
+    std::vector<Buffer> spare_buffers_;
+
+    WorkerPool readers_;
+};
+
+} // namespace inputleap
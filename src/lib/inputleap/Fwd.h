@@ -45,12 +45,18 @@ class Clipboard;
 // ClipboardChunk
 class ClipboardChunk;
 
+// ClipboardStreamer.h
+class ClipboardStreamer;
+
 // DragInformation.h
 class DragInformation;
 
 // FileChunk.h
 class FileChunk;
 
+// FileStreamer.h
+class FileStreamer;
+
 // IApp.h
 class IApp;
 
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "inputleap/clipboard_types.h"
+#include "inputleap/Fwd.h"
 #include "inputleap/IScreen.h"
 #include "inputleap/key_types.h"
 #include "inputleap/mouse_types.h"
@@ -59,10 +60,10 @@ public:
     /*!
     Update the client's clipboard.  This implies that the client's
     clipboard is now up to date.  If the client's clipboard was
-    already known to be up to date then this may do nothing.  \c data
-    has marshalled clipboard data.
+    already known to be up to date then this may do nothing.  The
+    client may keep a reference to the clipboard's marshalled() data.
     */
-    virtual void setClipboard(ClipboardID, const IClipboard*) = 0;
+    virtual void setClipboard(ClipboardID, const Clipboard*) = 0;
 
     //! Grab clipboard
     /*!
@@ -22,6 +22,16 @@
 
 namespace inputleap {
 
+void IClipboard::add_shared(EFormat format, std::shared_ptr<const std::string> data)
+{
+    add(format, *data);
+}
+
+std::shared_ptr<const std::string> IClipboard::get_shared(EFormat format) const
+{
+    return std::make_shared<const std::string>(get(format));
+}
+
 void IClipboard::unmarshall(IClipboard* clipboard, const std::string& data, Time time)
 {
     assert(clipboard != nullptr);
@@ -51,7 +61,8 @@ void IClipboard::unmarshall(IClipboard* clipboard, const std::string& data, Time
             // or server supports more clipboard formats than the other
             // then one of them will get a format >= kNumFormats here.
             if (format <IClipboard::kNumFormats) {
-                clipboard->add(format, std::string(index, size));
+                clipboard->add_shared(format,
+                                      std::make_shared<const std::string>(index, size));
             }
             index += size;
         }
@@ -74,7 +85,7 @@ std::string IClipboard::marshall(const IClipboard* clipboard)
 
     std::string data;
 
-    std::vector<std::string> formatData;
+    std::vector<std::shared_ptr<const std::string>> formatData;
     formatData.resize(IClipboard::kNumFormats);
     // FIXME -- use current time
     if (clipboard->open(0)) {
@@ -86,8 +97,8 @@ std::string IClipboard::marshall(const IClipboard* clipboard)
             if (clipboard->has(static_cast<IClipboard::EFormat>(format))) {
                 ++numFormats;
                 formatData[format] =
-                    clipboard->get(static_cast<IClipboard::EFormat>(format));
-                size += 4 + 4 + static_cast<std::uint32_t>(formatData[format].size());
+                    clipboard->get_shared(static_cast<IClipboard::EFormat>(format));
+                size += 4 + 4 + static_cast<std::uint32_t>(formatData[format]->size());
             }
         }
 
@@ -97,10 +108,10 @@ std::string IClipboard::marshall(const IClipboard* clipboard)
         // marshall the data
         writeUInt32(&data, numFormats);
         for (std::uint32_t format = 0; format != IClipboard::kNumFormats; ++format) {
-            if (clipboard->has(static_cast<IClipboard::EFormat>(format))) {
+            if (formatData[format]) {
                 writeUInt32(&data, format);
-                writeUInt32(&data, static_cast<std::uint32_t>(formatData[format].size()));
-                data += formatData[format];
+                writeUInt32(&data, static_cast<std::uint32_t>(formatData[format]->size()));
+                data += *formatData[format];
             }
         }
         clipboard->close();
@@ -132,7 +143,7 @@ IClipboard::copy(IClipboard* dst, const IClipboard* src, Time time)
                                 format != IClipboard::kNumFormats; ++format) {
                     IClipboard::EFormat eFormat = static_cast<IClipboard::EFormat>(format);
                     if (src->has(eFormat)) {
-                        dst->add(eFormat, src->get(eFormat));
+                        dst->add_shared(eFormat, src->get_shared(eFormat));
                     }
                 }
                 success = true;
@@ -19,7 +19,9 @@
 #pragma once
 
 #include "base/EventTypes.h"
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace inputleap {
 
@@ -69,6 +71,17 @@ public:
         kNumFormats        //!< The number of clipboard formats
     };
 
+    //! Format and size of clipboard data
+    /*!
+    Describes the data of one format without the data itself, e.g. to
+    offer a clipboard to another screen before transferring it.
+    */
+    struct FormatInfo {
+        EFormat format;
+        std::uint32_t size;
+    };
+    typedef std::vector<FormatInfo> FormatList;
+
     //! @name manipulators
     //@{
 
@@ -88,6 +101,13 @@ public:
     */
     virtual void add(EFormat, const std::string& data) = 0;
 
+    //! Add shared data
+    /*!
+    Like add() but hands over an immutable buffer that the clipboard
+    may keep instead of copying it.  The default copies it via add().
+    */
+    virtual void add_shared(EFormat, std::shared_ptr<const std::string> data);
+
     //@}
     //! @name accessors
     //@{
@@ -134,6 +154,14 @@ public:
     */
     virtual std::string get(EFormat) const = 0;
 
+    //! Get shared data
+    /*!
+    Like get() but returns an immutable buffer that may be shared with
+    the clipboard instead of a copy.  Never returns null.  The default
+    copies the result of get().
+    */
+    virtual std::shared_ptr<const std::string> get_shared(EFormat) const;
+
     //! Marshall clipboard data
     /*!
     Merge \p clipboard's data into a single buffer that can be later
@@ -20,6 +20,7 @@
 
 #include "inputleap/DragInformation.h"
 #include "inputleap/clipboard_types.h"
+#include "inputleap/IClipboard.h"
 #include "inputleap/IScreen.h"
 #include "inputleap/IPrimaryScreen.h"
 #include "inputleap/ISecondaryScreen.h"
@@ -84,6 +85,17 @@ public:
     */
     virtual bool setClipboard(ClipboardID id, const IClipboard*) = 0;
 
+    //! Offer clipboard
+    /*!
+    Take ownership of the system clipboard indicated by \c id and
+    advertise \c formats without having their data yet.  When something
+    asks for the data the screen sends a \c CLIPBOARD_DATA_REQUESTED
+    event and answers once setClipboard() provides it.  Returns false
+    if the screen can't do that; the caller must then fetch the data
+    and call setClipboard().
+    */
+    virtual bool offer_clipboard(ClipboardID id, const IClipboard::FormatList& formats) = 0;
+
     //! Check clipboard owner
     /*!
     Check ownership of all clipboards and post grab events for any that
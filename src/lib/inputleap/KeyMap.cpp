@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY KEYS
+
 #include "inputleap/KeyMap.h"
 #include "inputleap/key_types.h"
 #include "base/Log.h"
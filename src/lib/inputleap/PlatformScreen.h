@@ -59,6 +59,7 @@ public:
     void clearDraggingFilename() override { }
 
     // IPlatformScreen overrides
+    bool offer_clipboard(ClipboardID, const IClipboard::FormatList&) override { return false; }
 
     void fakeDraggingFiles(DragFileList fileList)  override
         { (void) fileList; throw std::runtime_error("fakeDraggingFiles not implemented"); }
@@ -61,6 +61,15 @@ bool PlatformScreenLoggingWrapper::setClipboard(ClipboardID id, const IClipboard
     return result;
 }
 
+bool PlatformScreenLoggingWrapper::offer_clipboard(ClipboardID id,
+                                                   const IClipboard::FormatList& formats)
+{
+    bool result = screen_->offer_clipboard(id, formats);
+    LOG_DEBUG1("PlatformScreen::offer_clipboard() id=%d formats=%zu => %d",
+         id, formats.size(), result);
+    return result;
+}
+
 void PlatformScreenLoggingWrapper::checkClipboards()
 {
     LOG_DEBUG1("PlatformScreen::checkClipboards()");
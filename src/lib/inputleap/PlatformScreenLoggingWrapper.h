@@ -33,6 +33,7 @@ public:
     bool canLeave() override;
     void leave() override;
     bool setClipboard(ClipboardID id, const IClipboard* clipboard) override;
+    bool offer_clipboard(ClipboardID id, const IClipboard::FormatList& formats) override;
     void checkClipboards() override;
     void openScreensaver(bool notify) override;
     void closeScreensaver() override;
@@ -161,6 +161,11 @@ Screen::setClipboard(ClipboardID id, const IClipboard* clipboard)
     m_screen->setClipboard(id, clipboard);
 }
 
+bool Screen::offer_clipboard(ClipboardID id, const IClipboard::FormatList& formats)
+{
+    return m_screen->offer_clipboard(id, formats);
+}
+
 void
 Screen::grabClipboard(ClipboardID id)
 {
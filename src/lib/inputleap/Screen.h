@@ -99,6 +99,14 @@ public:
     */
     void setClipboard(ClipboardID, const IClipboard*);
 
+    //! Offer clipboard
+    /*!
+    Offers the system clipboard \c id with the given formats without
+    their data.  Returns false if the screen needs the data right away.
+    See IPlatformScreen::offer_clipboard().
+    */
+    bool offer_clipboard(ClipboardID, const IClipboard::FormatList& formats);
+
     //! Grab clipboard
     /*!
     Grabs (i.e. take ownership of) the system clipboard.
@@ -707,6 +707,13 @@ void ServerApp::handle_screen_switched(const Event& e)
 int
 ServerApp::mainLoop()
 {
+    // like the socket multiplexer below, the log writer threads must be
+    // created after daemonization.
+    if (argsBase().m_asyncLog) {
+        CLOG->set_async(true);
+    }
+    setupBinaryLogging();
+
     // create socket multiplexer.  this must happen after daemonization
     // on unix because threads evaporate across a fork().
     setSocketMultiplexer(std::make_unique<SocketMultiplexer>());
@@ -69,6 +69,7 @@ static const OptionID    kOptionRelativeMouseMoves        = OPTION_CODE("MDLT");
 static const OptionID    kOptionWin32KeepForeground        = OPTION_CODE("_KFW");
 static const OptionID    kOptionClipboardSharing            = OPTION_CODE("CLPS");
 static const OptionID    kOptionClipboardSharingSize        = OPTION_CODE("CLSZ");
+static const OptionID    kOptionClipboardSelectionRate      = OPTION_CODE("CLSR");
 //@}
 
 //! @name Screen switch corner enumeration
@@ -33,9 +33,14 @@ namespace inputleap {
 // 1.4:  adds crypto support
 // 1.5:  adds file transfer and removes home brew crypto
 // 1.6:  adds clipboard streaming
+// 1.7:  adds on-demand clipboard transfer to secondary screens
+// 1.8:  adds compressed clipboard and file chunks
 // NOTE: with new version, InputLeap minor version should increment
 static const std::int16_t kProtocolMajorVersion = 1;
-static const std::int16_t kProtocolMinorVersion = 6;
+static const std::int16_t kProtocolMinorVersion = 8;
+
+// oldest protocol version this version can talk to
+static const std::int16_t kProtocolMinMinorVersion = 6;
 
 // default contact port number
 static const std::uint16_t kDefaultPort = 24800;
@@ -84,7 +89,11 @@ enum EDirectionMask {
 enum EDataTransfer {
     kDataStart = 1,
     kDataChunk = 2,
-    kDataEnd = 3
+    kDataEnd = 3,
+    // a data chunk compressed with a codec from kMsgDCodecs.  the data
+    // is the codec id (1 byte), the size of the decompressed data
+    // (4 bytes) and the compressed data.
+    kDataCompressed = 4
 };
 
 // Data received constants
@@ -249,6 +258,14 @@ extern const char*        kMsgDMouseWheel1_0;
 // identifier.
 extern const char*        kMsgDClipboard;
 
+// clipboard formats:  primary -> secondary
+// sent instead of kMsgDClipboard to 1.7 and later clients.  $1 =
+// clipboard identifier, $2 = sequence number (always 0), $3 = list of
+// format/size pairs, one for each format the clipboard has.  the
+// secondary should take ownership of the clipboard, advertise these
+// formats and send kMsgQClipboard once something wants the data.
+extern const char*        kMsgDClipboardFormats;
+
 // client data:  secondary -> primary
 // $1 = coordinate of leftmost pixel on secondary screen,
 // $2 = coordinate of topmost pixel on secondary screen,
@@ -277,6 +294,14 @@ extern const char*        kMsgDSetOptions;
 // 2 means the file transfer is finished.
 extern const char*        kMsgDFileTransfer;
 
+// codecs:  primary <-> secondary
+// $1 = list of codec ids the sender can decompress (see ChunkCodec.h),
+// most preferred first.  the primary sends this to 1.8 and later
+// clients after kMsgQInfo and the secondary replies with its own list.
+// either side may then send kDataCompressed chunks in kMsgDClipboard
+// and kMsgDFileTransfer with a codec the other side listed.
+extern const char*        kMsgDCodecs;
+
 // drag information:  primary <-> secondary
 // transfer drag information. The first 2 bytes are used for storing
 // the number of dragging objects. Then the following string consists
@@ -291,6 +316,12 @@ extern const char*        kMsgDDragInfo;
 // client should reply with a kMsgDInfo.
 extern const char*        kMsgQInfo;
 
+// query clipboard data:  secondary -> primary
+// $1 = clipboard identifier, $2 = sequence number from the
+// kMsgDClipboardFormats being answered.  the primary replies with
+// kMsgDClipboard for the current contents of the clipboard.
+extern const char*        kMsgQClipboard;
+
 
 //
 // error codes
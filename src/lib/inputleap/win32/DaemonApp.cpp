@@ -335,6 +335,20 @@ void DaemonApp::handle_ipc_message(const Event& e)
             break;
         }
 
+        case kIpcLogFilter: {
+            const auto& lfm = static_cast<const IpcLogFilterMessage&>(m);
+            const std::string filters = lfm.filters();
+            if (!CLOG->set_category_filters(filters)) {
+                LOG_WARN("invalid log category filters from gui: %s", filters.c_str());
+                break;
+            }
+            LOG_INFO("log category filters changed to %s", filters.c_str());
+
+            // the node is told too, so its log lines are filtered at the source
+            m_ipcServer->send(lfm, kIpcClientNode);
+            break;
+        }
+
         case kIpcHello:
             const auto& hm = static_cast<const IpcHelloMessage&>(m);
             std::string type;
@@ -113,6 +113,15 @@ public:
     */
     virtual std::uint32_t getSize() const = 0;
 
+    //! Get bytes waiting to be written
+    /*!
+    Returns the number of bytes written to the stream that haven't
+    been sent yet.  Streams that send a \c STREAM_OUTPUT_FLUSHED event
+    once this drops to zero can be used for flow control.  Streams
+    that don't buffer output always return zero.
+    */
+    virtual std::uint32_t getOutputSize() const = 0;
+
     //@}
 };
 
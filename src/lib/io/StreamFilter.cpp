@@ -86,6 +86,11 @@ std::uint32_t StreamFilter::getSize() const
     return getStream()->getSize();
 }
 
+std::uint32_t StreamFilter::getOutputSize() const
+{
+    return getStream()->getOutputSize();
+}
+
 void
 StreamFilter::filterEvent(const Event& event)
 {
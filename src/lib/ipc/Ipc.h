@@ -26,6 +26,7 @@ enum EIpcMessage {
     kIpcLogLine,
     kIpcCommand,
     kIpcShutdown,
+    kIpcLogFilter,
 };
 
 enum EIpcClientType {
@@ -50,3 +51,8 @@ extern const char*        kIpcMsgCommand;
 // shutdown: daemon -> node
 // the daemon tells input-leaps/c to shut down gracefully.
 extern const char*        kIpcMsgShutdown;
+
+// log filter: gui -> daemon, daemon -> node
+// $1 = log category filters, in the format of --log-category.  the daemon
+// applies them to its own log and passes them on to input-leaps/c.
+extern const char*        kIpcMsgLogFilter;
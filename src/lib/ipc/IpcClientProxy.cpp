@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY IPC
+
 #include "ipc/IpcClientProxy.h"
 
 #include "ipc/Ipc.h"
@@ -90,6 +92,9 @@ void IpcClientProxy::handle_data()
         else if (memcmp(code, kIpcMsgCommand, 4) == 0) {
             event_data = create_event_data<IpcCommandMessage>(parseCommand());
         }
+        else if (memcmp(code, kIpcMsgLogFilter, 4) == 0) {
+            event_data = create_event_data<IpcLogFilterMessage>(parseLogFilter());
+        }
         else {
             LOG_ERR("invalid ipc message");
             disconnect();
@@ -125,6 +130,13 @@ IpcClientProxy::send(const IpcMessage& message)
         ProtocolUtil::writef(stream_.get(), kIpcMsgShutdown);
         break;
 
+    case kIpcLogFilter: {
+        const auto& lfm = static_cast<const IpcLogFilterMessage&>(message);
+        const std::string filters = lfm.filters();
+        ProtocolUtil::writef(stream_.get(), kIpcMsgLogFilter, &filters);
+        break;
+    }
+
     default:
         LOG_ERR("ipc message not supported: %d", message.type());
         break;
@@ -152,6 +164,13 @@ IpcCommandMessage IpcClientProxy::parseCommand()
     return IpcCommandMessage(command, elevate != 0);
 }
 
+IpcLogFilterMessage IpcClientProxy::parseLogFilter()
+{
+    std::string filters;
+    ProtocolUtil::readf(stream_.get(), kIpcMsgLogFilter + 4, &filters);
+    return IpcLogFilterMessage(filters);
+}
+
 void
 IpcClientProxy::disconnect()
 {
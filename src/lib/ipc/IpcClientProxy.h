@@ -32,6 +32,7 @@ namespace inputleap {
 class IpcMessage;
 class IpcCommandMessage;
 class IpcHelloMessage;
+class IpcLogFilterMessage;
 class IStream;
 
 class IpcClientProxy : public EventTarget {
@@ -48,6 +49,7 @@ private:
     void handle_write_error();
     IpcHelloMessage parseHello();
     IpcCommandMessage parseCommand();
+    IpcLogFilterMessage parseLogFilter();
     void disconnect();
 
 private:
@@ -59,6 +59,16 @@ IpcLogLineMessage::~IpcLogLineMessage()
 {
 }
 
+IpcLogFilterMessage::IpcLogFilterMessage(const std::string& filters) :
+    IpcMessage(kIpcLogFilter),
+    m_filters(filters)
+{
+}
+
+IpcLogFilterMessage::~IpcLogFilterMessage()
+{
+}
+
 IpcCommandMessage::IpcCommandMessage(const std::string& command, bool elevate) :
     IpcMessage(kIpcCommand),
     m_command(command),
@@ -70,6 +70,18 @@ private:
     std::string m_logLine;
 };
 
+class IpcLogFilterMessage : public IpcMessage {
+public:
+    IpcLogFilterMessage(const std::string& filters);
+    virtual ~IpcLogFilterMessage();
+
+    //! Gets the log category filters, in the format of --log-category.
+    std::string filters() const { return m_filters; }
+
+private:
+    std::string m_filters;
+};
+
 class IpcCommandMessage : public IpcMessage {
 public:
     IpcCommandMessage(const std::string& command, bool elevate);
@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY IPC
+
 #include "ipc/IpcServer.h"
 
 #include "ipc/Ipc.h"
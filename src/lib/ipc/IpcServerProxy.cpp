@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY IPC
+
 #include "ipc/IpcServerProxy.h"
 
 #include "ipc/IpcMessage.h"
@@ -57,6 +59,9 @@ void IpcServerProxy::handle_data()
         else if (memcmp(code, kIpcMsgShutdown, 4) == 0) {
             event_data = create_event_data<IpcShutdownMessage>(IpcShutdownMessage{});
         }
+        else if (memcmp(code, kIpcMsgLogFilter, 4) == 0) {
+            event_data = create_event_data<IpcLogFilterMessage>(parseLogFilter());
+        }
         else {
             LOG_ERR("invalid ipc message");
             disconnect();
@@ -89,6 +94,13 @@ IpcServerProxy::send(const IpcMessage& message)
         break;
     }
 
+    case kIpcLogFilter: {
+        const auto& lfm = static_cast<const IpcLogFilterMessage&>(message);
+        const std::string filters = lfm.filters();
+        ProtocolUtil::writef(&m_stream, kIpcMsgLogFilter, &filters);
+        break;
+    }
+
     default:
         LOG_ERR("ipc message not supported: %d", message.type());
         break;
@@ -104,6 +116,13 @@ IpcLogLineMessage IpcServerProxy::parseLogLine()
     return IpcLogLineMessage(logLine);
 }
 
+IpcLogFilterMessage IpcServerProxy::parseLogFilter()
+{
+    std::string filters;
+    ProtocolUtil::readf(&m_stream, kIpcMsgLogFilter + 4, &filters);
+    return IpcLogFilterMessage(filters);
+}
+
 void
 IpcServerProxy::disconnect()
 {
@@ -0,0 +1,84 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mt/WorkerPool.h"
+
+#include "mt/Thread.h"
+
+#include <cassert>
+
+namespace inputleap {
+
+WorkerPool::WorkerPool(std::size_t max_threads) :
+    max_threads_(max_threads)
+{
+    assert(max_threads_ > 0);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    jobs_cv_.notify_all();
+
+    // no thread is started once stop_ is set
+    for (auto& thread : threads_) {
+        thread->wait();
+    }
+}
+
+void WorkerPool::run(std::function<void()> job)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+    if (idle_ < jobs_.size() && threads_.size() < max_threads_) {
+        threads_.push_back(std::make_unique<Thread>([this]() { work(); }));
+    } else {
+        jobs_cv_.notify_one();
+    }
+}
+
+std::size_t WorkerPool::get_thread_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return threads_.size();
+}
+
+void WorkerPool::work()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        ++idle_;
+        jobs_cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+        --idle_;
+
+        // finish the queued jobs before stopping
+        if (jobs_.empty()) {
+            return;
+        }
+        auto job = std::move(jobs_.front());
+        jobs_.pop_front();
+
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+} // namespace inputleap
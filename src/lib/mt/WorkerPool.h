@@ -0,0 +1,79 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace inputleap {
+
+class Thread;
+
+//! Bounded pool of worker threads
+/*!
+Runs jobs on at most a fixed number of threads.  Threads are started
+when a job finds no idle thread and are reused for later jobs, so
+running a job doesn't normally create a thread.  Jobs run in the order
+they were queued, several at once when there are several threads.
+
+Jobs should not block for long;  a blocked job holds its thread.
+*/
+class WorkerPool {
+public:
+    //! Run jobs on up to \p max_threads threads
+    explicit WorkerPool(std::size_t max_threads);
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    //! Waits for the queued and running jobs, then stops the threads
+    ~WorkerPool();
+
+    //! @name manipulators
+    //@{
+
+    //! Queue \p job to run on a worker thread
+    void run(std::function<void()> job);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Returns the number of threads started so far
+    std::size_t get_thread_count() const;
+
+    //@}
+
+private:
+    void work();
+
+    const std::size_t max_threads_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable jobs_cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::vector<std::unique_ptr<Thread>> threads_;
+    std::size_t idle_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace inputleap
@@ -15,6 +15,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY NET
+
 #include "SecureSocket.h"
 #include "SecureUtils.h"
 
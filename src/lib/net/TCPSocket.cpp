@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY NET
+
 #include "net/TCPSocket.h"
 
 #include "net/NetworkAddress.h"
@@ -262,6 +264,12 @@ std::uint32_t TCPSocket::getSize() const
     return m_inputBuffer.getSize();
 }
 
+std::uint32_t TCPSocket::getOutputSize() const
+{
+    std::lock_guard<std::mutex> lock(tcp_mutex_);
+    return m_outputBuffer.getSize();
+}
+
 void
 TCPSocket::connect(const NetworkAddress& addr)
 {
@@ -212,6 +212,14 @@ public:
     virtual unsigned char do_XkbKeyGroupInfo(XkbDescPtr m_xkb,
                                              KeyCode keycode) = 0;
     virtual int XNextEvent(Display* display, XEvent* event_return) = 0;
+    virtual int XPutBackEvent(Display* display, XEvent* event) = 0;
+    virtual int XEventsQueued(Display* display, int mode) = 0;
+    virtual int XConnectionNumber(Display* display) = 0;
+    virtual int XConvertSelection(Display* display, Atom selection, Atom target,
+                                  Atom property, Window requestor, Time time) = 0;
+    virtual int XChangeProperty(Display* display, Window w, Atom property, Atom type,
+                                int format, int mode, _Xconst unsigned char* data,
+                                int nelements) = 0;
 };
 
 } // namespace inputleap
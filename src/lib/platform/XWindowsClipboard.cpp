@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY CLIPBOARD
+
 #include "platform/XWindowsClipboard.h"
 
 #include "platform/XWindowsClipboardTextConverter.h"
@@ -31,15 +33,20 @@
 #include "mt/Thread.h"
 #include "arch/Arch.h"
 #include "base/Log.h"
-#include "base/Time.h"
 #include "base/Stopwatch.h"
+#include "base/String.h"
 
 #include <X11/Xatom.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <vector>
 
+#include <poll.h>
+
 namespace inputleap {
 
 XWindowsClipboard::XWindowsClipboard(IXWindowsImpl* impl, Display* display,
@@ -129,6 +136,9 @@ XWindowsClipboard::lost(Time time)
         m_timeLost = time;
         clearCache();
     }
+
+    // the promised data will never come
+    answerDeferredRequests(true);
 }
 
 void
@@ -141,19 +151,18 @@ XWindowsClipboard::addRequest(Window owner, Window requestor,
     if (owner == m_window) {
         LOG_DEBUG1("request for clipboard %ld, target %s by 0x%08lx (property=%s)", m_selection, XWindowsUtil::atomToString(m_display, target).c_str(), requestor, XWindowsUtil::atomToString(m_display, property).c_str());
         if (wasOwnedAtTime(time)) {
-            if (target == m_atomMultiple) {
-                // add a multiple request.  property may not be None
-                // according to ICCCM.
-                if (property != None) {
-                    success = insertMultipleReply(requestor, time, property);
+            if (needsPromisedData(target)) {
+                // answer once the data has arrived
+                LOG_DEBUG1("waiting for promised data");
+                deferred_requests_.push_back({requestor, target, time, property});
+                if (!fetching_) {
+                    // one fetch serves all the requests that wait meanwhile
+                    fetching_ = true;
+                    data_requested_ = true;
                 }
+                return;
             }
-            else {
-                addSimpleRequest(requestor, target, time, property);
-
-                // addSimpleRequest() will have already handled failure
-                success = true;
-            }
+            success = answerRequest(requestor, target, time, property);
         }
         else {
             LOG_DEBUG1("failed, not owned at time %ld", time);
@@ -170,6 +179,76 @@ XWindowsClipboard::addRequest(Window owner, Window requestor,
     pushReplies();
 }
 
+bool XWindowsClipboard::answerRequest(Window requestor, Atom target, ::Time time,
+                                      Atom property)
+{
+    if (target == m_atomMultiple) {
+        // add a multiple request.  property may not be None
+        // according to ICCCM.
+        if (property != None) {
+            return insertMultipleReply(requestor, time, property);
+        }
+        return false;
+    }
+
+    addSimpleRequest(requestor, target, time, property);
+
+    // addSimpleRequest() will have already handled failure
+    return true;
+}
+
+bool XWindowsClipboard::needsPromisedData(Atom target) const
+{
+    if (target == m_atomTargets || target == m_atomTimestamp) {
+        return false;
+    }
+
+    // a MULTIPLE request waits for all the data
+    if (target == m_atomMultiple) {
+        for (std::int32_t index = 0; index < kNumFormats; ++index) {
+            if (promised_[index] && !m_added[index]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    IXWindowsClipboardConverter* converter = getConverter(target);
+    if (converter == nullptr) {
+        return false;
+    }
+    IClipboard::EFormat format = converter->getFormat();
+    return promised_[format] && !m_added[format];
+}
+
+void XWindowsClipboard::answerDeferredRequests(bool fail)
+{
+    if (deferred_requests_.empty()) {
+        return;
+    }
+
+    std::vector<DeferredRequest> requests;
+    requests.swap(deferred_requests_);
+    for (const auto& request : requests) {
+        if (!fail && needsPromisedData(request.target)) {
+            // still waiting
+            deferred_requests_.push_back(request);
+            continue;
+        }
+        if (fail || !answerRequest(request.requestor, request.target,
+                                   request.time, request.property)) {
+            LOG_DEBUG1("failed deferred request for target %s by 0x%08lx", XWindowsUtil::atomToString(m_display, request.target).c_str(), request.requestor);
+            insertReply(new Reply(request.requestor, request.target, request.time));
+        }
+    }
+    if (deferred_requests_.empty()) {
+        fetching_ = false;
+    }
+
+    // send notifications that are pending
+    pushReplies();
+}
+
 bool
 XWindowsClipboard::addSimpleRequest(Window requestor,
                 Atom target, ::Time time, Atom property)
@@ -197,7 +276,7 @@ XWindowsClipboard::addSimpleRequest(Window requestor,
             IClipboard::EFormat clipboardFormat = converter->getFormat();
             if (m_added[clipboardFormat]) {
                 try {
-                    data   = converter->fromIClipboard(m_data[clipboardFormat]);
+                    data   = converter->fromIClipboard(*m_data[clipboardFormat]);
                     format = converter->getDataSize();
                     type   = converter->getAtom();
                 }
@@ -314,14 +393,35 @@ XWindowsClipboard::clear()
     return true;
 }
 
+void XWindowsClipboard::promise(EFormat format)
+{
+    assert(m_open);
+    assert(m_owner);
+
+    LOG_DEBUG("promise clipboard %d format: %d", m_id, format);
+    promised_[format] = true;
+}
+
+bool XWindowsClipboard::pop_data_request()
+{
+    bool requested = data_requested_;
+    data_requested_ = false;
+    return requested;
+}
+
 void XWindowsClipboard::add(EFormat format, const std::string& data)
+{
+    add_shared(format, std::make_shared<const std::string>(data));
+}
+
+void XWindowsClipboard::add_shared(EFormat format, std::shared_ptr<const std::string> data)
 {
     assert(m_open);
     assert(m_owner);
 
-    LOG_DEBUG("add %zd bytes to clipboard %d format: %d", data.size(), m_id, format);
+    LOG_DEBUG("add %zd bytes to clipboard %d format: %d", data->size(), m_id, format);
 
-    m_data[format]  = data;
+    m_data[format]  = std::move(data);
     m_added[format] = true;
 
     // FIXME -- set motif clipboard item?
@@ -379,6 +479,9 @@ XWindowsClipboard::close() const
 
     m_motif = false;
     m_open  = false;
+
+    // answer requests for data that has arrived
+    const_cast<XWindowsClipboard*>(this)->answerDeferredRequests(false);
 }
 
 IClipboard::Time
@@ -402,6 +505,17 @@ std::string XWindowsClipboard::get(EFormat format) const
     assert(m_open);
 
     fillCache();
+    return m_added[format] ? *m_data[format] : std::string();
+}
+
+std::shared_ptr<const std::string> XWindowsClipboard::get_shared(EFormat format) const
+{
+    assert(m_open);
+
+    fillCache();
+    if (!m_added[format]) {
+        return std::make_shared<const std::string>();
+    }
     return m_data[format];
 }
 
@@ -480,9 +594,12 @@ XWindowsClipboard::doClearCache()
     m_checkCache = false;
     m_cached     = false;
     for (std::int32_t index = 0; index < kNumFormats; ++index) {
-        m_data[index]  = "";
-        m_added[index] = false;
+        m_data[index].reset();
+        m_added[index]    = false;
+        promised_[index]  = false;
     }
+    data_requested_ = false;
+    fetching_ = false;
 }
 
 void
@@ -515,79 +632,168 @@ XWindowsClipboard::icccmFillCache()
     LOG_DEBUG("ICCCM fill clipboard %d", m_id);
 
     // see if we can get the list of available formats from the selection.
-    // if not then use a default list of formats.  note that some clipboard
-    // owners are broken and report TARGETS as the type of the TARGETS data
-    // instead of the correct type ATOM;  allow either.
+    // note that some clipboard owners are broken and report TARGETS as
+    // the type of the TARGETS data instead of the correct type ATOM;
+    // allow either.
     const Atom atomTargets = m_atomTargets;
     Atom target;
     std::string data;
-    if (!icccmGetSelection(atomTargets, &target, &data) ||
-        (target != m_atomAtom && target != m_atomTargets)) {
+    const bool hasTargets = icccmGetSelection(atomTargets, &target, &data) &&
+                            (target == m_atomAtom || target == m_atomTargets);
+    if (!hasTargets) {
         LOG_DEBUG1("selection doesn't support TARGETS");
         data = "";
-        XWindowsUtil::appendAtomData(data, XA_STRING);
     }
 
     XWindowsUtil::convertAtomProperty(data);
     const Atom* targets = reinterpret_cast<const Atom*>(data.data()); // TODO: Safe?
     const std::uint32_t numTargets = data.size() / sizeof(Atom);
     LOG_DEBUG("  available targets: %s", XWindowsUtil::atomsToString(m_display, targets, numTargets).c_str());
+    auto isAvailable = [targets, numTargets](Atom atom) {
+        return std::find(targets, targets + numTargets, atom) != targets + numTargets;
+    };
 
-    // try each converter in order (because they're in order of
-    // preference).
+    // ask only for the targets the owner lists, or for every target
+    // we know if it doesn't list them
+    std::vector<IXWindowsClipboardConverter*> candidates;
     for (auto index = m_converters.begin(); index != m_converters.end(); ++index) {
         IXWindowsClipboardConverter* converter = *index;
-
-        // skip already handled targets
-        if (m_added[converter->getFormat()]) {
-            continue;
+        if (converter->getAtom() != None && (!hasTargets || isAvailable(converter->getAtom()))) {
+            candidates.push_back(converter);
         }
-
-        // see if atom is in target list
-        // XXX -- just ask for the converter's target to see if it's
-        // available rather than checking TARGETS.  i've seen clipboard
-        // owners that don't report all the targets they support.
-        target = converter->getAtom();
-        if (target == None) {
-            continue;
+    }
+    const bool multiple = hasTargets && isAvailable(m_atomMultiple);
+
+    // fetch the most preferred candidate of each format at once.  only
+    // formats that couldn't be converted try their next candidate.
+    while (!candidates.empty()) {
+        std::vector<IXWindowsClipboardConverter*> batch;
+        std::vector<CICCCMGetClipboard::Conversion> conversions;
+        bool inBatch[kNumFormats] = {};
+        for (auto index = candidates.begin(); index != candidates.end(); ) {
+            IClipboard::EFormat format = (*index)->getFormat();
+            if (m_added[format]) {
+                index = candidates.erase(index);
+            }
+            else if (!inBatch[format]) {
+                inBatch[format] = true;
+                batch.push_back(*index);
+                conversions.push_back(CICCCMGetClipboard::Conversion((*index)->getAtom(), None));
+                index = candidates.erase(index);
+            }
+            else {
+                ++index;
+            }
+        }
+        if (batch.empty()) {
+            break;
         }
 
-        // get the data
-        Atom actualTarget;
-        IClipboard::EFormat format = converter->getFormat();
-        std::string targetData;
-        if (!icccmGetSelection(target, &actualTarget, &targetData)) {
-            LOG_DEBUG1("  no data for target %s", XWindowsUtil::atomToString(m_display, target).c_str());
-            m_added[format] = false;
-            continue;
+        icccmGetSelections(conversions, multiple);
+
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            IXWindowsClipboardConverter* converter = batch[i];
+            const CICCCMGetClipboard::Conversion& conversion = conversions[i];
+            IClipboard::EFormat format = converter->getFormat();
+            target = conversion.m_target;
+            Atom actualTarget = conversion.m_actualTarget;
+            const std::string& targetData = conversion.m_data;
+
+            // get the data
+            if (conversion.m_failed || actualTarget == None) {
+                LOG_DEBUG1("  no data for target %s", XWindowsUtil::atomToString(m_display, target).c_str());
+                m_added[format] = false;
+                continue;
+            }
+
+            if (actualTarget != target) {
+                LOG_DEBUG1("  target %s not same as actual target %s",
+                    XWindowsUtil::atomToString(m_display, target).c_str(),
+                    XWindowsUtil::atomToString(m_display, actualTarget).c_str());
+                m_added[format] = false;
+                continue;
+            }
+
+            if (targetData.empty()) {
+                m_added[format] = false;
+                LOG_DEBUG1("  no targetdata for target %s (actual target %s)",
+                    XWindowsUtil::atomToString(m_display, target).c_str(),
+                    XWindowsUtil::atomToString(m_display, actualTarget).c_str());
+                 continue;
+            }
+
+            // convert once and keep the result without copying it
+            auto data = std::make_shared<const std::string>(converter->toIClipboard(targetData));
+            if (!data->empty()) {
+                // add to clipboard and note we've done it
+                m_data[format]  = std::move(data);
+                m_added[format] = true;
+                LOG_DEBUG("  added format %d for target %s (%zu %s)", format, XWindowsUtil::atomToString(m_display, target).c_str(), targetData.size(), targetData.size() == 1 ? "byte" : "bytes");
+            } else {
+                LOG_DEBUG1("  no clipboard data for target %s", XWindowsUtil::atomToString(m_display, target).c_str());
+                m_added[format] = false;
+            }
         }
+    }
+}
 
-        if (actualTarget != target) {
-            LOG_DEBUG1("  target %s not same as actual target %s",
-                XWindowsUtil::atomToString(m_display, target).c_str(),
-                XWindowsUtil::atomToString(m_display, actualTarget).c_str());
-            m_added[format] = false;
+void
+XWindowsClipboard::icccmGetSelections(
+                std::vector<CICCCMGetClipboard::Conversion>& conversions, bool multiple)
+{
+    // every conversion in flight needs a property of its own
+    for (std::size_t i = 0; i < conversions.size(); ++i) {
+        conversions[i].m_property = getConversionProperty(i);
+    }
+
+    // MULTIPLE only pays off for more than one target
+    multiple = multiple && conversions.size() > 1;
+    CICCCMGetClipboard getter(m_impl, m_window, m_time, m_atomData);
+    const bool okay = getter.readTargets(m_display, m_selection, conversions, multiple);
+    if (getter.m_error) LOG_WARN("ICCCM violation by clipboard owner");
+    if (!okay) {
+        LOG_DEBUG1("can't get data for %zu selection targets", conversions.size());
+        return;
+    }
+    if (!multiple) {
+        return;
+    }
+
+    // owners that can't convert MULTIPLE or botch some of its targets
+    // get asked for those separately
+    std::vector<CICCCMGetClipboard::Conversion> retries;
+    for (const auto& conversion : conversions) {
+        if (conversion.m_failed) {
+            retries.push_back(CICCCMGetClipboard::Conversion(conversion.m_target, None));
+        }
+    }
+    if (retries.empty()) {
+        return;
+    }
+    LOG_DEBUG1("retrying %zu selection targets without MULTIPLE", retries.size());
+    icccmGetSelections(retries, false);
+    for (auto& conversion : conversions) {
+        if (!conversion.m_failed) {
             continue;
         }
-
-        if (targetData.empty()) {
-            m_added[format] = false;
-            LOG_DEBUG1("  no targetdata for target %s (actual target %s)",
-                XWindowsUtil::atomToString(m_display, target).c_str(),
-                XWindowsUtil::atomToString(m_display, actualTarget).c_str());
-             continue;
+        for (auto& retry : retries) {
+            if (retry.m_target == conversion.m_target) {
+                conversion = std::move(retry);
+                break;
+            }
         }
+    }
+}
 
-        if (!converter->toIClipboard(targetData).empty()) {
-            // add to clipboard and note we've done it
-            m_data[format]  = converter->toIClipboard(targetData);
-            m_added[format] = true;
-            LOG_DEBUG("  added format %d for target %s (%zu %s)", format, XWindowsUtil::atomToString(m_display, target).c_str(), targetData.size(), targetData.size() == 1 ? "byte" : "bytes");
-        } else {
-            LOG_DEBUG1("  no clipboard data for target %s", XWindowsUtil::atomToString(m_display, target).c_str());
-            m_added[format] = false;
-        }
+Atom
+XWindowsClipboard::getConversionProperty(std::size_t index)
+{
+    while (conversion_properties_.size() <= index) {
+        std::string name = inputleap::string::sprintf("CLIP_TEMPORARY_%zu",
+                                                      conversion_properties_.size() + 1);
+        conversion_properties_.push_back(m_impl->XInternAtom(m_display, name.c_str(), False));
     }
+    return conversion_properties_[index];
 }
 
 bool
@@ -598,7 +804,7 @@ XWindowsClipboard::icccmGetSelection(Atom target,
     assert(data != nullptr);
 
     // request data conversion
-    CICCCMGetClipboard getter(m_window, m_time, m_atomData);
+    CICCCMGetClipboard getter(m_impl, m_window, m_time, m_atomData);
     if (!getter.readClipboard(m_display, m_selection,
                                 target, actualTarget, data)) {
         LOG_DEBUG1("can't get data for selection target %s", XWindowsUtil::atomToString(m_display, target).c_str());
@@ -838,9 +1044,11 @@ XWindowsClipboard::motifFillCache()
             continue;
         }
 
-        if (!converter->toIClipboard(targetData).empty()) {
+        // convert once and keep the result without copying it
+        auto data = std::make_shared<const std::string>(converter->toIClipboard(targetData));
+        if (!data->empty()) {
             // add to clipboard and note we've done it
-            m_data[format]  = converter->toIClipboard(targetData);
+            m_data[format]  = std::move(data);
             m_added[format] = true;
             LOG_DEBUG("  added format %d for target %s (%zu %s)", format, XWindowsUtil::atomToString(m_display, target).c_str(), targetData.size(), targetData.size() == 1 ? "byte" : "bytes");
         } else {
@@ -1268,8 +1476,8 @@ Atom XWindowsClipboard::getTargetsData(std::string& data, int* format) const
     for (auto index = m_converters.begin(); index != m_converters.end(); ++index) {
         IXWindowsClipboardConverter* converter = *index;
 
-        // skip formats we don't have
-        if (m_added[converter->getFormat()]) {
+        // skip formats we don't have or expect
+        if (m_added[converter->getFormat()] || promised_[converter->getFormat()]) {
             XWindowsUtil::appendAtomData(data, converter->getAtom());
         }
     }
@@ -1293,17 +1501,29 @@ Atom XWindowsClipboard::getTimestampData(std::string& data, int* format) const
 // XWindowsClipboard::CICCCMGetClipboard
 //
 
-XWindowsClipboard::CICCCMGetClipboard::CICCCMGetClipboard(
+const double XWindowsClipboard::CICCCMGetClipboard::kTimeout = 0.25;
+
+XWindowsClipboard::CICCCMGetClipboard::Conversion::Conversion(Atom target, Atom property) :
+    m_target(target),
+    m_property(property),
+    m_actualTarget(None),
+    m_incr(false),
+    m_done(false),
+    m_failed(false),
+    m_reading(false)
+{
+    // do nothing
+}
+
+XWindowsClipboard::CICCCMGetClipboard::CICCCMGetClipboard(IXWindowsImpl* impl,
                 Window requestor, Time time, Atom property) :
+    m_impl(impl),
     m_requestor(requestor),
     m_time(time),
     m_property(property),
-    m_incr(false),
     m_failed(false),
-    m_done(false),
-    m_reading(false),
-    m_data(nullptr),
-    m_actualTarget(nullptr),
+    m_multiple(false),
+    m_conversions(nullptr),
     m_error(false)
 {
     // do nothing
@@ -1321,90 +1541,156 @@ XWindowsClipboard::CICCCMGetClipboard::readClipboard(Display* display,
     assert(actualTarget != nullptr);
     assert(data != nullptr);
 
-    LOG_DEBUG1("request selection=%s, target=%s, window=%lx", XWindowsUtil::atomToString(display, selection).c_str(), XWindowsUtil::atomToString(display, target).c_str(), m_requestor);
+    std::vector<Conversion> conversions(1, Conversion(target, m_property));
+    const bool okay = readTargets(display, selection, conversions, false);
+    *actualTarget = conversions[0].m_actualTarget;
+    *data         = std::move(conversions[0].m_data);
+    return okay && !conversions[0].m_failed;
+}
 
-    m_atomNone = XInternAtom(display, "NONE", False);
-    m_atomIncr = XInternAtom(display, "INCR", False);
+bool
+XWindowsClipboard::CICCCMGetClipboard::readTargets(Display* display,
+                Atom selection, std::vector<Conversion>& conversions, bool multiple)
+{
+    for (const auto& conversion : conversions) {
+        LOG_DEBUG1("request selection=%s, target=%s, window=%lx", XWindowsUtil::atomToString(display, selection).c_str(), XWindowsUtil::atomToString(display, conversion.m_target).c_str(), m_requestor);
+    }
 
-    // save output pointers
-    m_actualTarget = actualTarget;
-    m_data         = data;
+    m_atomNone     = m_impl->XInternAtom(display, "NONE", False);
+    m_atomIncr     = m_impl->XInternAtom(display, "INCR", False);
+    m_atomMultiple = m_impl->XInternAtom(display, "MULTIPLE", False);
+    m_atomAtomPair = m_impl->XInternAtom(display, "ATOM_PAIR", False);
 
-    // assume failure
-    *m_actualTarget = None;
-    *m_data         = "";
+    m_conversions = &conversions;
+    m_multiple    = multiple;
+    m_failed      = false;
 
-    // delete target property
-    XDeleteProperty(display, m_requestor, m_property);
+    // delete target properties
+    for (const auto& conversion : conversions) {
+        m_impl->XDeleteProperty(display, m_requestor, conversion.m_property);
+    }
 
     // select window for property changes
     XWindowAttributes attr;
-    XGetWindowAttributes(display, m_requestor, &attr);
-    XSelectInput(display, m_requestor,
+    m_impl->XGetWindowAttributes(display, m_requestor, &attr);
+    m_impl->XSelectInput(display, m_requestor,
                                 attr.your_event_mask | PropertyChangeMask);
 
-    // request data conversion
-    XConvertSelection(display, selection, target,
+    // request data conversion.  all requests are sent before waiting so
+    // the owner's replies overlap.
+    if (m_multiple) {
+        std::string pairs;
+        for (const auto& conversion : conversions) {
+            XWindowsUtil::appendAtomData(pairs, conversion.m_target);
+            XWindowsUtil::appendAtomData(pairs, conversion.m_property);
+        }
+        m_impl->XChangeProperty(display, m_requestor, m_property, m_atomAtomPair, 32,
+                                PropModeReplace,
+                                reinterpret_cast<const unsigned char*>(pairs.data()),
+                                static_cast<int>(2 * conversions.size()));
+        m_impl->XConvertSelection(display, selection, m_atomMultiple,
                                 m_property, m_requestor, m_time);
+    }
+    else {
+        for (const auto& conversion : conversions) {
+            m_impl->XConvertSelection(display, selection, conversion.m_target,
+                                conversion.m_property, m_requestor, m_time);
+        }
+    }
 
     // synchronize with server before we start following timeout countdown
-    XSync(display, False);
+    m_impl->XSync(display, False);
 
-    // Xlib inexplicably omits the ability to wait for an event with
-    // a timeout.  (it's inexplicable because there's no portable way
-    // to do it.)  we'll poll until we have what we're looking for or
-    // a timeout expires.  we use a timeout so we don't get locked up
-    // by badly behaved selection owners.
+    // handle events until we have what we're looking for or the owner
+    // stops making progress.  the timeout keeps badly behaved selection
+    // owners from locking us up.
     XEvent xevent;
     std::vector<XEvent> events;
     Stopwatch timeout(false);    // timer not stopped, not triggered
-    static const double s_timeout = 0.25;    // FIXME -- is this too short?
-    bool noWait = false;
-    while (!m_done && !m_failed) {
-        // fail if timeout has expired
-        if (timeout.getTime() >= s_timeout) {
+    while (!m_failed && !isFinished()) {
+        // XPending() reads what the server sent without blocking.  events
+        // it read but didn't count are caught by XEventsQueued().
+        if (m_impl->XPending(display) > 0 ||
+            m_impl->XEventsQueued(display, QueuedAlready) > 0) {
+            m_impl->XNextEvent(display, &xevent);
+            if (!processEvent(display, &xevent)) {
+                // not processed so save it
+                events.push_back(xevent);
+            }
+            else {
+                // reset timer since we've made some progress
+                timeout.reset();
+            }
+            continue;
+        }
+
+        // fail if timeout has expired, otherwise sleep until the
+        // server sends something
+        const double remaining = kTimeout - timeout.getTime();
+        if (remaining <= 0.0 || !waitForEvents(display, remaining)) {
             m_failed = true;
-            break;
         }
+    }
 
-        // process events if any otherwise sleep
-        if (noWait || XPending(display) > 0) {
-            while (!m_done && !m_failed && (noWait || XPending(display) > 0)) {
-                XNextEvent(display, &xevent);
-                if (!processEvent(display, &xevent)) {
-                    // not processed so save it
-                    events.push_back(xevent);
-                }
-                else {
-                    // reset timer since we've made some progress
-                    timeout.reset();
-
-                    // don't sleep anymore, just block waiting for events.
-                    // we're assuming here that the clipboard owner will
-                    // complete the protocol correctly.  if we continue to
-                    // sleep we'll get very bad performance.
-                    noWait = true;
-                }
+    // whatever didn't finish won't
+    if (m_failed) {
+        for (auto& conversion : conversions) {
+            if (!conversion.m_done) {
+                conversion.m_failed = true;
             }
         }
-        else {
-            inputleap::this_thread_sleep(0.01);
-        }
     }
 
     // put unprocessed events back
     for (std::uint32_t i = events.size(); i > 0; --i) {
-        XPutBackEvent(display, &events[i - 1]);
+        m_impl->XPutBackEvent(display, &events[i - 1]);
     }
 
     // restore mask
-    XSelectInput(display, m_requestor, attr.your_event_mask);
+    m_impl->XSelectInput(display, m_requestor, attr.your_event_mask);
 
     // return success or failure
     LOG_DEBUG1("request %s after %fs", m_failed ? "failed" : "succeeded", timeout.getTime());
+    m_conversions = nullptr;
     return !m_failed;
 }
 
+bool
+XWindowsClipboard::CICCCMGetClipboard::isFinished() const
+{
+    for (const auto& conversion : *m_conversions) {
+        if (!conversion.m_done && !conversion.m_failed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+XWindowsClipboard::CICCCMGetClipboard::waitForEvents(Display* display, double timeout)
+{
+    struct pollfd pfd;
+    pfd.fd     = m_impl->XConnectionNumber(display);
+    pfd.events = POLLIN;
+
+    Stopwatch elapsed(false);
+    for (;;) {
+        const double remaining = timeout - elapsed.getTime();
+        if (remaining <= 0.0) {
+            return false;
+        }
+
+        // round up so we never wake up just before the deadline
+        const int result = poll(&pfd, 1, static_cast<int>(std::ceil(1000.0 * remaining)));
+        if (result > 0) {
+            return true;
+        }
+        if (result < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+}
+
 bool
 XWindowsClipboard::CICCCMGetClipboard::processEvent(
                 Display* display, XEvent* xevent)
@@ -1421,18 +1707,34 @@ XWindowsClipboard::CICCCMGetClipboard::processEvent(
         return false;
 
     case SelectionNotify:
-        if (xevent->xselection.requestor == m_requestor) {
-            // done if we can't convert
+        if (xevent->xselection.requestor != m_requestor) {
+            // not interested
+            return false;
+        }
+        if (m_multiple) {
+            return processMultipleNotify(display, xevent->xselection);
+        }
+
+        for (auto& conversion : *m_conversions) {
+            if (conversion.m_done || conversion.m_failed || conversion.m_reading) {
+                continue;
+            }
+
+            // done if we can't convert.  a lone request takes any refusal.
             if (xevent->xselection.property == None ||
                 xevent->xselection.property == m_atomNone) {
-                m_done = true;
-                return true;
+                if (xevent->xselection.target == conversion.m_target ||
+                    m_conversions->size() == 1) {
+                    conversion.m_done = true;
+                    return true;
+                }
             }
 
             // proceed if conversion successful
-            else if (xevent->xselection.property == m_property) {
-                m_reading = true;
-                break;
+            else if (xevent->xselection.property == conversion.m_property) {
+                conversion.m_reading = true;
+                readProperty(display, conversion);
+                return true;
             }
         }
 
@@ -1440,15 +1742,29 @@ XWindowsClipboard::CICCCMGetClipboard::processEvent(
         return false;
 
     case PropertyNotify:
+        if (xevent->xproperty.window != m_requestor ||
+            xevent->xproperty.state  != PropertyNewValue) {
+            // not interested
+            return false;
+        }
+
+        // the list of targets we stored for MULTIPLE
+        if (m_multiple && xevent->xproperty.atom == m_property) {
+            return true;
+        }
+
         // proceed if conversion successful and we're receiving more data
-        if (xevent->xproperty.window == m_requestor &&
-            xevent->xproperty.atom   == m_property &&
-            xevent->xproperty.state  == PropertyNewValue) {
-            if (!m_reading) {
-                // we haven't gotten the SelectionNotify yet
-                return true;
+        for (auto& conversion : *m_conversions) {
+            if (conversion.m_done || conversion.m_failed ||
+                xevent->xproperty.atom != conversion.m_property) {
+                continue;
             }
-            break;
+            if (conversion.m_reading) {
+                readProperty(display, conversion);
+            }
+
+            // otherwise we haven't gotten the SelectionNotify yet
+            return true;
         }
 
         // otherwise not interested
@@ -1458,71 +1774,132 @@ XWindowsClipboard::CICCCMGetClipboard::processEvent(
         // not interested
         return false;
     }
+}
+
+bool
+XWindowsClipboard::CICCCMGetClipboard::processMultipleNotify(
+                Display* display, const XSelectionEvent& xselection)
+{
+    // only the first reply counts
+    for (const auto& conversion : *m_conversions) {
+        if (conversion.m_reading || conversion.m_done || conversion.m_failed) {
+            return false;
+        }
+    }
+
+    // the owner can't do MULTIPLE at all.  fail every conversion so the
+    // caller can ask for the targets separately.
+    if (xselection.property == None || xselection.property == m_atomNone) {
+        for (auto& conversion : *m_conversions) {
+            conversion.m_failed = true;
+        }
+        return true;
+    }
+
+    if (xselection.property != m_property) {
+        // not interested
+        return false;
+    }
+
+    // the owner replaced the property of each target it couldn't
+    // convert with None
+    std::string pairs;
+    Atom type;
+    std::int32_t format;
+    const std::size_t numConversions = m_conversions->size();
+    if (!XWindowsUtil::getWindowProperty(display, m_requestor, m_property,
+                                         &pairs, &type, &format, True) ||
+        type != m_atomAtomPair || format != 32 ||
+        pairs.size() < 2 * numConversions * sizeof(Atom)) {
+        LOG_DEBUG1("  bad MULTIPLE reply");
+        for (auto& conversion : *m_conversions) {
+            conversion.m_failed = true;
+        }
+        m_error = true;
+        return true;
+    }
+
+    const Atom* atoms = reinterpret_cast<const Atom*>(pairs.data());
+    for (std::size_t i = 0; i < numConversions; ++i) {
+        Conversion& conversion = (*m_conversions)[i];
+        if (atoms[2 * i + 1] != conversion.m_property) {
+            conversion.m_done = true;
+        }
+        else {
+            conversion.m_reading = true;
+            readProperty(display, conversion);
+        }
+    }
+    return true;
+}
 
+void
+XWindowsClipboard::CICCCMGetClipboard::readProperty(
+                Display* display, Conversion& conversion)
+{
     // get the data from the property
     Atom target;
-    const std::string::size_type oldSize = m_data->size();
+    std::string& data = conversion.m_data;
+    const std::string::size_type oldSize = data.size();
     if (!XWindowsUtil::getWindowProperty(display, m_requestor,
-                                         m_property, m_data, &target, nullptr, True)) {
+                                         conversion.m_property, &data, &target, nullptr, True)) {
         // unable to read property
-        m_failed = true;
-        return true;
+        conversion.m_failed = true;
+        return;
     }
 
     // note if incremental.  if we're already incremental then the
     // selection owner is busted.  if the INCR property has no size
     // then the selection owner is busted.
     if (target == m_atomIncr) {
-        if (m_incr) {
-            m_failed = true;
-            m_error  = true;
+        if (conversion.m_incr) {
+            conversion.m_failed = true;
+            m_error             = true;
         }
-        else if (m_data->size() == oldSize) {
-            m_failed = true;
-            m_error  = true;
+        else if (data.size() == oldSize) {
+            conversion.m_failed = true;
+            m_error             = true;
         }
         else {
-            m_incr   = true;
+            conversion.m_incr = true;
 
             // discard INCR data
-            *m_data = "";
+            data = "";
         }
     }
 
     // handle incremental chunks
-    else if (m_incr) {
+    else if (conversion.m_incr) {
         // if first incremental chunk then save target
         if (oldSize == 0) {
             LOG_DEBUG1("  INCR first chunk, target %s", XWindowsUtil::atomToString(display, target).c_str());
-            *m_actualTarget = target;
+            conversion.m_actualTarget = target;
         }
 
         // secondary chunks must have the same target
         else {
-            if (target != *m_actualTarget) {
+            if (target != conversion.m_actualTarget) {
                 LOG_WARN("  INCR target mismatch");
-                m_failed = true;
-                m_error  = true;
+                conversion.m_failed = true;
+                m_error             = true;
             }
         }
 
         // note if this is the final chunk
-        if (m_data->size() == oldSize) {
-            LOG_DEBUG1("  INCR final chunk: %zd bytes total", m_data->size());
-            m_done = true;
+        if (data.size() == oldSize) {
+            LOG_DEBUG1("  INCR final chunk: %zd bytes total", data.size());
+            conversion.m_done = true;
         }
     }
 
     // not incremental;  save the target.
     else {
         LOG_DEBUG1("  target %s", XWindowsUtil::atomToString(display, target).c_str());
-        *m_actualTarget = target;
-        m_done          = true;
+        conversion.m_actualTarget = target;
+        conversion.m_done         = true;
     }
 
-    // this event has been processed
-    if (!m_incr) LOG_DEBUG1("  got data, %zd bytes", m_data->size());
-    return true;
+    if (!conversion.m_incr) LOG_DEBUG1("  got data, %zd bytes", data.size());
 }
 
 
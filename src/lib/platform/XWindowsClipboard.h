@@ -74,6 +74,23 @@ public:
     */
     bool destroyRequest(Window requestor);
 
+    //! Promise data
+    /*!
+    Advertise data in the given format without having it yet.  May
+    only be called after a successful clear().  Requests that need
+    promised data wait until add() provides it and the clipboard is
+    closed, or fail when the clipboard is lost.
+    */
+    void promise(EFormat);
+
+    //! Check for a request waiting for data
+    /*!
+    Returns true once after the first request started waiting for
+    promised data; the data should be fetched then.  Requests that come
+    in while the data is being fetched don't ask for it again.
+    */
+    bool pop_data_request();
+
     //! Get window
     /*!
     Returns the clipboard's window (passed the c'tor).
@@ -90,11 +107,13 @@ public:
     // IClipboard overrides
     bool clear() override;
     void add(EFormat, const std::string& data) override;
+    void add_shared(EFormat, std::shared_ptr<const std::string> data) override;
     bool open(Time) const override;
     void close() const override;
     Time getTime() const override;
     bool has(EFormat) const override;
     std::string get(EFormat) const override;
+    std::shared_ptr<const std::string> get_shared(EFormat) const override;
 
 private:
     // remove all converters from our list
@@ -119,6 +138,17 @@ private:
                             Window requestor, Atom target,
                             ::Time time, Atom property);
 
+    // add a request, MULTIPLE or not, for a time the selection was
+    // owned.  returns false if the reply is still to be inserted.
+    bool answerRequest(Window requestor, Atom target,
+                            ::Time time, Atom property);
+
+    // true if the request needs data that was promised but not added
+    bool needsPromisedData(Atom target) const;
+
+    // answer or fail the requests that waited for promised data
+    void answerDeferredRequests(bool fail);
+
     // if not already checked then see if the cache is stale and, if so,
     // clear it.  this has the side effect of updating m_timeOwned.
     void checkCache() const;
@@ -132,6 +162,9 @@ private:
     void fillCache() const;
     void doFillCache();
 
+    // reaches CICCCMGetClipboard to drive it against a mocked display
+    friend class XWindowsClipboardTests;
+
     //
     // helper classes
     //
@@ -139,7 +172,36 @@ private:
     // read an ICCCM conforming selection
     class CICCCMGetClipboard {
     public:
-        CICCCMGetClipboard(Window requestor, Time time, Atom property);
+        // seconds to wait for the selection owner to make progress
+        static const double kTimeout;
+
+        // a target to convert the selection to
+        class Conversion {
+        public:
+            Conversion(Atom target, Atom property);
+
+        public:
+            Atom m_target;
+
+            // the property the owner stores the data in
+            Atom m_property;
+
+            // the actual type of the data.  if this is None then the
+            // selection owner cannot convert to the requested type.
+            Atom m_actualTarget;
+
+            // the converted selection data
+            std::string m_data;
+
+            bool m_incr;
+            bool m_done;
+            bool m_failed;
+
+            // true iff the owner stored the data
+            bool m_reading;
+        };
+
+        CICCCMGetClipboard(IXWindowsImpl* impl, Window requestor, Time time, Atom property);
         ~CICCCMGetClipboard();
 
         // convert the given selection to the given type.  returns
@@ -149,30 +211,44 @@ private:
                             Atom selection, Atom target,
                             Atom* actualTarget, std::string* data);
 
+        // convert the given selection to every target in conversions
+        // at once, each into its own property.  if multiple is true
+        // then they're requested with a single MULTIPLE conversion
+        // that lists the targets in the property passed to the c'tor.
+        // returns false iff the selection owner stopped responding;
+        // conversions that didn't finish are marked failed.
+        bool readTargets(Display* display, Atom selection,
+                            std::vector<Conversion>& conversions, bool multiple);
+
     private:
         bool processEvent(Display* display, XEvent* event);
+        bool processMultipleNotify(Display* display, const XSelectionEvent& event);
+
+        // read the data the owner stored for a conversion
+        void readProperty(Display* display, Conversion& conversion);
+
+        // true iff every conversion is done or failed
+        bool isFinished() const;
+
+        // block until the X connection is readable or \p timeout seconds
+        // pass.  returns false on timeout.
+        bool waitForEvents(Display* display, double timeout);
 
     private:
+        IXWindowsImpl* m_impl;
         Window m_requestor;
         Time m_time;
         Atom m_property;
-        bool m_incr;
         bool m_failed;
-        bool m_done;
+        bool m_multiple;
 
         // atoms needed for the protocol
         Atom m_atomNone;        // NONE, not None
         Atom m_atomIncr;
+        Atom m_atomMultiple;
+        Atom m_atomAtomPair;
 
-        // true iff we've received the selection notify
-        bool m_reading;
-
-        // the converted selection data
-        std::string* m_data;
-
-        // the actual type of the data.  if this is None then the
-        // selection owner cannot convert to the requested type.
-        Atom* m_actualTarget;
+        std::vector<Conversion>* m_conversions;
 
     public:
         // true iff the selection owner didn't follow ICCCM conventions
@@ -254,6 +330,9 @@ private:
     // ICCCM interoperability methods
     void icccmFillCache();
     bool icccmGetSelection(Atom target, Atom* actualTarget, std::string* data) const;
+    void icccmGetSelections(std::vector<CICCCMGetClipboard::Conversion>& conversions,
+                            bool multiple);
+    Atom getConversionProperty(std::size_t index);
     Time icccmGetTime() const;
 
     // motif interoperability methods
@@ -303,7 +382,21 @@ private:
     bool m_cached;
     Time m_cacheTime;
     bool m_added[kNumFormats];
-    std::string m_data[kNumFormats];
+    std::shared_ptr<const std::string> m_data[kNumFormats];   // null if not added
+
+    // formats advertised before their data arrives, the requests
+    // waiting for it, whether a fetch is under way and whether the
+    // data should be fetched
+    struct DeferredRequest {
+        Window requestor;
+        Atom target;
+        ::Time time;
+        Atom property;
+    };
+    bool promised_[kNumFormats];
+    std::vector<DeferredRequest> deferred_requests_;
+    bool fetching_ = false;
+    bool data_requested_ = false;
 
     // conversion request replies
     ReplyMap m_replies;
@@ -325,6 +418,9 @@ private:
     Atom m_atomMotifClipHeader;
     Atom m_atomMotifClipAccess;
     Atom m_atomGDKSelection;
+
+    // properties for conversions that are in flight at the same time
+    std::vector<Atom> conversion_properties_;
 };
 
 //! Clipboard format converter interface
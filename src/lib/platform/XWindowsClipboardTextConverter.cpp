@@ -72,10 +72,10 @@ std::string XWindowsClipboardTextConverter::toIClipboard(const std::string& data
     // UTF-8 representation, see if the data appears to be UTF-8.  if
     // so then use it as is.
     if (errors && Unicode::isUTF8(data)) {
-        return data;
+        utf8 = data;
     }
 
-    return utf8;
+    return Unicode::to_utf8_text(utf8, Unicode::TextEncoding::UTF8, Unicode::Newline::LF);
 }
 
 } // namespace inputleap
@@ -54,7 +54,7 @@ XWindowsClipboardUCS2Converter::getDataSize() const
 
 std::string XWindowsClipboardUCS2Converter::fromIClipboard(const std::string& data) const
 {
-    return Unicode::UTF8ToUCS2(data);
+    return Unicode::from_utf8_text(data, Unicode::TextEncoding::UCS2, Unicode::Newline::LF);
 }
 
 std::string XWindowsClipboardUCS2Converter::toIClipboard(const std::string& data) const
@@ -63,7 +63,7 @@ std::string XWindowsClipboardUCS2Converter::toIClipboard(const std::string& data
         return {};
     }
 
-    return Unicode::UCS2ToUTF8(data);
+    return Unicode::to_utf8_text(data, Unicode::TextEncoding::UCS2, Unicode::Newline::LF);
 }
 
 } // namespace inputleap
@@ -18,6 +18,8 @@
 
 #include "platform/XWindowsClipboardUTF8Converter.h"
 
+#include "base/Unicode.h"
+
 namespace inputleap {
 
 XWindowsClipboardUTF8Converter::XWindowsClipboardUTF8Converter(
@@ -52,7 +54,7 @@ XWindowsClipboardUTF8Converter::getDataSize() const
 
 std::string XWindowsClipboardUTF8Converter::fromIClipboard(const std::string& data) const
 {
-    return data;
+    return Unicode::from_utf8_text(data, Unicode::TextEncoding::UTF8, Unicode::Newline::LF);
 }
 
 std::string XWindowsClipboardUTF8Converter::toIClipboard(const std::string& data) const
@@ -61,7 +63,8 @@ std::string XWindowsClipboardUTF8Converter::toIClipboard(const std::string& data
         return {};
     }
 
-    return data;
+    // some applications put DOS or old Mac OS line endings on the clipboard
+    return Unicode::to_utf8_text(data, Unicode::TextEncoding::UTF8, Unicode::Newline::LF);
 }
 
 } // namespace inputleap
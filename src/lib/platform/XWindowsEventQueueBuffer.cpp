@@ -21,10 +21,17 @@
 #include "mt/Thread.h"
 #include "base/Event.h"
 #include "base/IEventQueue.h"
+#include "base/Stopwatch.h"
 
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
 #include <fcntl.h>
 #include <unistd.h>
 #include <poll.h>
+#if HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
 
 namespace inputleap {
 
@@ -40,29 +47,65 @@ XWindowsEventQueueBuffer::XWindowsEventQueueBuffer(IXWindowsImpl* impl,
     assert(m_window  != None);
 
     m_userEvent = m_impl->XInternAtom(m_display, "INPUTLEAP_USER_EVENT", False);
-    // set up for pipe hack
-    int result = pipe2(m_pipefd, O_NONBLOCK);
+
+    // set up the descriptor addEvent() wakes waitForEvent() with
+#if HAVE_SYS_EVENTFD_H
+    m_wakeReadFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    assert(m_wakeReadFd >= 0);
+    m_wakeWriteFd = m_wakeReadFd;
+#else
+    int pipefd[2];
+    int result = pipe2(pipefd, O_NONBLOCK | O_CLOEXEC);
     assert(result == 0);
+    m_wakeReadFd = pipefd[0];
+    m_wakeWriteFd = pipefd[1];
+#endif
 }
 
 XWindowsEventQueueBuffer::~XWindowsEventQueueBuffer()
 {
-    // release pipe hack resources
-    close(m_pipefd[0]);
-    close(m_pipefd[1]);
+    close(m_wakeReadFd);
+    if (m_wakeWriteFd != m_wakeReadFd) {
+        close(m_wakeWriteFd);
+    }
 }
 
 int XWindowsEventQueueBuffer::getPendingCountLocked()
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    // work around a bug in old libx11 which causes the first XPending not to read events under
+    // reads whatever the server has sent without blocking, so events that
+    // are already in Xlib's queue are found even if the socket is drained.
+    int count = m_impl->XEventsQueued(m_display, QueuedAfterReading);
+    if (count != 0) {
+        return count;
+    }
+    // work around a bug in old libx11 which causes the first read not to process events under
     // certain conditions. The issue happens when libx11 has not yet received replies for all
-    // flushed events. In that case, internally XPending will not try to process received events
-    // as the reply for the last event was not found. As a result, XPending will return the number
-    // of pending events without regard to the events it has just read.
+    // flushed events. In that case, internally XEventsQueued will not try to process received
+    // events as the reply for the last event was not found. As a result, it will return the
+    // number of pending events without regard to the events it has just read.
     // https://gitlab.freedesktop.org/xorg/lib/libx11/-/merge_requests/1 fixes this on libx11 side.
-    m_impl->XPending(m_display);
-    return m_impl->XPending(m_display);
+    return m_impl->XEventsQueued(m_display, QueuedAlready);
+}
+
+void XWindowsEventQueueBuffer::wake()
+{
+#if HAVE_SYS_EVENTFD_H
+    std::uint64_t one = 1;
+    ssize_t result = write(m_wakeWriteFd, &one, sizeof(one));
+#else
+    ssize_t result = write(m_wakeWriteFd, "!", 1);
+#endif
+    // a failure means the counter or pipe is full, so the waiter wakes anyway
+    (void) result;
+}
+
+void XWindowsEventQueueBuffer::drainWakeups()
+{
+    char buf[16];
+    while (read(m_wakeReadFd, buf, sizeof(buf)) > 0) {
+        // an eventfd is drained by one read, a pipe may need several
+    }
 }
 
 void
@@ -70,14 +113,8 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
 {
     Thread::testCancel();
 
-    // clear out the pipe in preparation for waiting.
-
-    char buf[16];
-    ssize_t read_response = read(m_pipefd[0], buf, 15);
-    if (read_response < 0)
-    {
-        // todo: handle read response
-    }
+    // clear out wake-ups in preparation for waiting.
+    drainWakeups();
 
     {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -87,46 +124,47 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
         // push out pending events
         flush();
     }
-    // calling flush may have queued up a new event.
-    if (!XWindowsEventQueueBuffer::isEmpty()) {
-        Thread::testCancel();
-        return;
-    }
 
-    // use poll() to wait for a message from the X server or for timeout.
-    // this is a good deal more efficient than polling and sleeping.
+    // sleep until the X server sends something, addEvent() wakes us or
+    // the timeout expires.  the socket alone isn't enough:  flushing, on
+    // this thread or in addEvent(), can read events into Xlib's queue and
+    // leave the socket drained, so the queue is checked without blocking
+    // before every sleep and addEvent() always signals the wake-up
+    // descriptor.
     struct pollfd pfds[2];
-    pfds[0].fd     = ConnectionNumber(m_display);
+    pfds[0].fd     = m_impl->XConnectionNumber(m_display);
     pfds[0].events = POLLIN;
-    pfds[1].fd     = m_pipefd[0];
+    pfds[1].fd     = m_wakeReadFd;
     pfds[1].events = POLLIN;
-    int timeout    = (dtimeout < 0.0) ? -1 :
-                        static_cast<int>(1000.0 * dtimeout);
-    int remaining  =  timeout;
-    int retval     =  0;
-    // It's possible that the X server has queued events locally
-    // in xlib's event buffer and not pushed on to the fd. Hence we
-    // can't simply monitor the fd as we may never be woken up.
-    // ie addEvent calls flush, XFlush may not send via the fd hence
-    // there is an event waiting to be sent but we must exit the poll
-    // before it can.
-    // Instead we poll for a brief period of time (so if events
-    // queued locally in the xlib buffer can be processed)
-    // and continue doing this until timeout is reached.
-    // The human eye can notice 60hz (ansi) which is 16ms, however
-    // we want to give the cpu a chance s owe up this to 25ms
-#define TIMEOUT_DELAY 25
-
-    while (((dtimeout < 0.0) || (remaining > 0)) && getPendingCountLocked() == 0 && retval == 0) {
-        retval = poll(pfds, 2, TIMEOUT_DELAY); //16ms = 60hz, but we make it > to play nicely with the cpu
-        if (pfds[1].revents & POLLIN) {
-            read_response = read(m_pipefd[0], buf, 15);
-            if (read_response < 0)
-            {
-                // todo: handle read response
+
+    Stopwatch timer(false);
+    for (;;) {
+        if (getPendingCountLocked() != 0) {
+            break;
+        }
+
+        int timeout = -1;
+        if (dtimeout >= 0.0) {
+            double remaining = dtimeout - timer.getTime();
+            if (remaining <= 0.0) {
+                break;
             }
+            // round up so we never wake just before the deadline
+            timeout = static_cast<int>(std::ceil(1000.0 * remaining));
+        }
+
+        int result = poll(pfds, 2, timeout);
+        if (result < 0 && errno != EINTR) {
+            break;
+        }
+        if (result > 0 && (pfds[1].revents & POLLIN) != 0) {
+            // a user event was posted;  it's in the queue by now
+            drainWakeups();
+        }
+        if (result > 0 && (pfds[0].revents & (POLLERR | POLLHUP)) != 0) {
+            // let getEvent() report the broken connection
+            break;
         }
-        remaining-=TIMEOUT_DELAY;
     }
 
     {
@@ -181,15 +219,11 @@ bool XWindowsEventQueueBuffer::addEvent(std::uint32_t dataID)
     // too.
     if (m_waiting) {
         flush();
-        // Send a character through the round-trip pipe to wake a thread
-        // that is waiting for a ConnectionNumber() socket to be readable.
-        // The flush call can read incoming data from the socket and put
-        // it in Xlib's input buffer.  That sneaks it past the other thread.
-        ssize_t write_response = write(m_pipefd[1], "!", 1);
-        if (write_response < 0)
-        {
-            // todo: handle write response
-        }
+        // Wake the thread that is waiting for a ConnectionNumber() socket
+        // to be readable.  The flush call can read incoming data from the
+        // socket and put it in Xlib's input buffer.  That sneaks it past
+        // the other thread.
+        wake();
     }
 
     return true;
@@ -49,6 +49,12 @@ private:
 
     int getPendingCountLocked();
 
+    // wake the thread in waitForEvent()
+    void wake();
+
+    // consume the wake-ups sent so far
+    void drainWakeups();
+
 private:
     typedef std::vector<XEvent> EventList;
     IXWindowsImpl* m_impl;
@@ -60,7 +66,10 @@ private:
     XEvent m_event;
     EventList m_postedEvents;
     bool m_waiting;
-    int m_pipefd[2];
+
+    // an eventfd, or the ends of a pipe where there's none
+    int m_wakeReadFd;
+    int m_wakeWriteFd;
     IEventQueue* m_events;
 };
 
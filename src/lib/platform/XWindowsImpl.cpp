@@ -631,4 +631,32 @@ int XWindowsImpl::XNextEvent(Display* display, XEvent* event_return)
     return ::XNextEvent(display, event_return);
 }
 
+int XWindowsImpl::XPutBackEvent(Display* display, XEvent* event)
+{
+    return ::XPutBackEvent(display, event);
+}
+
+int XWindowsImpl::XEventsQueued(Display* display, int mode)
+{
+    return ::XEventsQueued(display, mode);
+}
+
+int XWindowsImpl::XConnectionNumber(Display* display)
+{
+    return ::XConnectionNumber(display);
+}
+
+int XWindowsImpl::XConvertSelection(Display* display, Atom selection, Atom target,
+                                    Atom property, Window requestor, Time time)
+{
+    return ::XConvertSelection(display, selection, target, property, requestor, time);
+}
+
+int XWindowsImpl::XChangeProperty(Display* display, Window w, Atom property, Atom type,
+                                  int format, int mode, _Xconst unsigned char* data,
+                                  int nelements)
+{
+    return ::XChangeProperty(display, w, property, type, format, mode, data, nelements);
+}
+
 } // namespace inputleap
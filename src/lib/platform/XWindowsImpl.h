@@ -146,6 +146,13 @@ public:
                                     int eGroup) override;
     unsigned char do_XkbKeyGroupInfo(XkbDescPtr m_xkb, KeyCode keycode) override;
     int XNextEvent(Display* display, XEvent* event_return) override;
+    int XPutBackEvent(Display* display, XEvent* event) override;
+    int XEventsQueued(Display* display, int mode) override;
+    int XConnectionNumber(Display* display) override;
+    int XConvertSelection(Display* display, Atom selection, Atom target, Atom property,
+                          Window requestor, Time time) override;
+    int XChangeProperty(Display* display, Window w, Atom property, Atom type, int format,
+                        int mode, _Xconst unsigned char* data, int nelements) override;
 };
 
 } // namespace inputleap
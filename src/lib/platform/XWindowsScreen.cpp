@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY X11
+
 #include "platform/XWindowsScreen.h"
 
 #include "platform/XKBUtil.h"
@@ -378,6 +380,26 @@ XWindowsScreen::setClipboard(ClipboardID id, const IClipboard* clipboard)
 	}
 }
 
+bool XWindowsScreen::offer_clipboard(ClipboardID id, const IClipboard::FormatList& formats)
+{
+    if (m_clipboard[id] == nullptr) {
+        return false;
+    }
+
+    // take ownership and advertise the formats.  the data is fetched
+    // when somebody asks for it.
+    Time timestamp = XWindowsUtil::getCurrentTime(m_display, m_clipboard[id]->getWindow());
+    if (!m_clipboard[id]->open(timestamp)) {
+        return false;
+    }
+    m_clipboard[id]->clear();
+    for (const auto& format : formats) {
+        m_clipboard[id]->promise(format.format);
+    }
+    m_clipboard[id]->close();
+    return true;
+}
+
 void
 XWindowsScreen::checkClipboards()
 {
@@ -1280,6 +1302,9 @@ XWindowsScreen::handle_system_event(const Event& event)
 								xevent->xselectionrequest.target,
 								xevent->xselectionrequest.time,
 								xevent->xselectionrequest.property);
+				if (m_clipboard[id]->pop_data_request()) {
+					sendClipboardEvent(EventType::CLIPBOARD_DATA_REQUESTED, id);
+				}
 				return;
 			}
 		}
@@ -78,6 +78,7 @@ public:
     bool canLeave() override;
     void leave() override;
     bool setClipboard(ClipboardID, const IClipboard*) override;
+    bool offer_clipboard(ClipboardID, const IClipboard::FormatList&) override;
     void checkClipboards() override;
     void openScreensaver(bool notify) override;
     void closeScreensaver() override;
@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY X11
+
 #include "platform/XWindowsScreenSaver.h"
 
 #include "platform/XWindowsUtil.h"
@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY X11
+
 #include "platform/XWindowsUtil.h"
 
 #include "mt/Thread.h"
@@ -76,7 +78,9 @@ bool XWindowsUtil::getWindowProperty(Display* display, Window window, Atom prope
             break;
 
         case 32:
-            numBytes = 4 * numItems;
+            // Xlib returns 32 bit items as longs, which are 64 bits wide
+            // on 64 bit systems.  callers read them as Atom or Time.
+            numBytes = sizeof(long) * numItems;
             offset  += numItems;
             break;
         }
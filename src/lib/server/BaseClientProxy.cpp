@@ -45,6 +45,17 @@ void BaseClientProxy::getJumpCursorPos(std::int32_t& x, std::int32_t& y) const
     y = m_y;
 }
 
+ScreenId BaseClientProxy::get_id() const
+{
+    // the name comes from the peer, so it's only looked up, never interned.
+    // the configuration's names are interned when the server adopts it,
+    // which may be after the primary client was created.
+    if (!id_.is_valid()) {
+        id_ = ScreenId::find(m_name);
+    }
+    return id_;
+}
+
 std::string BaseClientProxy::getName() const
 {
     return m_name;
@@ -18,10 +18,14 @@
 
 #pragma once
 
+#include "server/ScreenId.h"
 #include "base/EventTarget.h"
 #include "inputleap/Fwd.h"
 #include "inputleap/IClient.h"
 
+#include <string>
+#include <vector>
+
 namespace inputleap {
 
 class IClientConnection;
@@ -61,16 +65,34 @@ public:
     */
     virtual bool isPrimary() const { return false; }
 
+    //! Get the id of the client's name
+    /*!
+    This is the name the client gave, which may be an alias.  Returns an
+    invalid id if the name is not in the configuration.
+    */
+    ScreenId get_id() const;
+
     //@}
 
     // IClient overrides
     virtual void sendDragInfo(std::uint32_t fileCount, const char* info, size_t size) = 0;
-    virtual void file_chunk_sending(const FileChunk& chunk) = 0;
+
+    //! Send files
+    /*!
+    Starts sending \p filenames one after another, cancelling the files
+    being sent if any.
+    */
+    virtual void send_files(const std::vector<std::string>& filenames) = 0;
+
+    //! Cancel sending the files being sent, if any
+    virtual void cancel_file() = 0;
+
     std::string getName() const override;
     virtual IClientConnection& get_conn() const = 0;
 
 private:
     std::string m_name;
+    mutable ScreenId id_;
     std::int32_t m_x, m_y;
 };
 
@@ -129,13 +129,12 @@ void ClientConnectionByStream::send_close_1_6(const char* msg)
 
 void ClientConnectionByStream::send_clipboard_chunk_1_6(const ClipboardChunk& chunk)
 {
-    ProtocolUtil::writef(stream_.get(), kMsgDClipboard, chunk.id_, chunk.sequence_, chunk.mark_,
-                         &chunk.data_);
+    chunk.send(stream_.get());
 }
 
 void ClientConnectionByStream::send_file_chunk_1_6(const FileChunk& chunk)
 {
-    ProtocolUtil::writef(stream_.get(), kMsgDFileTransfer, chunk.mark_, &chunk.data_);
+    chunk.send(stream_.get());
 }
 
 void ClientConnectionByStream::send_grab_clipboard(ClipboardID id)
@@ -143,6 +142,23 @@ void ClientConnectionByStream::send_grab_clipboard(ClipboardID id)
     ProtocolUtil::writef(stream_.get(), kMsgCClipboard, id, 0);
 }
 
+void ClientConnectionByStream::send_clipboard_formats_1_7(ClipboardID id,
+                                                          const IClipboard::FormatList& formats)
+{
+    std::vector<std::uint32_t> pairs;
+    pairs.reserve(formats.size() * 2);
+    for (const auto& info : formats) {
+        pairs.push_back(info.format);
+        pairs.push_back(info.size);
+    }
+    ProtocolUtil::writef(stream_.get(), kMsgDClipboardFormats, id, 0, &pairs);
+}
+
+void ClientConnectionByStream::send_codecs_1_8(const std::vector<std::uint8_t>& codecs)
+{
+    ProtocolUtil::writef(stream_.get(), kMsgDCodecs, &codecs);
+}
+
 void ClientConnectionByStream::flush()
 {
     stream_->flush();
@@ -57,6 +57,9 @@ public:
     void send_clipboard_chunk_1_6(const ClipboardChunk& chunk) override;
     void send_file_chunk_1_6(const FileChunk& chunk) override;
     void send_grab_clipboard(ClipboardID id) override;
+    void send_clipboard_formats_1_7(ClipboardID id,
+                                    const IClipboard::FormatList& formats) override;
+    void send_codecs_1_8(const std::vector<std::uint8_t>& codecs) override;
 
     void flush() override;
     void close() override;
@@ -14,6 +14,8 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#define INPUTLEAP_LOG_CATEGORY SERVER
+
 #include "ClientConnectionLoggingWrapper.h"
 #include "base/Log.h"
 #include "inputleap/ClipboardChunk.h"
@@ -168,7 +170,7 @@ void ClientConnectionLoggingWrapper::send_clipboard_chunk_1_6(const ClipboardChu
         break;
 
     case kDataChunk:
-        LOG_DEBUG2("sending clipboard chunk data: size=%zi", chunk.data_.size());
+        LOG_DEBUG2("sending clipboard chunk data: size=%u", chunk.payload_size());
         break;
 
     case kDataEnd:
@@ -188,7 +190,7 @@ void ClientConnectionLoggingWrapper::send_file_chunk_1_6(const FileChunk& chunk)
         break;
 
     case kDataChunk:
-        LOG_DEBUG2("sending file chunk: size=%zi", chunk.data_.size());
+        LOG_DEBUG2("sending file chunk: size=%u", chunk.payload_size());
         break;
 
     case kDataEnd:
@@ -206,6 +208,19 @@ void ClientConnectionLoggingWrapper::send_grab_clipboard(ClipboardID id)
     conn_->send_grab_clipboard(id);
 }
 
+void ClientConnectionLoggingWrapper::send_clipboard_formats_1_7(
+        ClipboardID id, const IClipboard::FormatList& formats)
+{
+    LOG_DEBUG("send clipboard %d formats (%zu) to \"%s\"", id, formats.size(), name_.c_str());
+    conn_->send_clipboard_formats_1_7(id, formats);
+}
+
+void ClientConnectionLoggingWrapper::send_codecs_1_8(const std::vector<std::uint8_t>& codecs)
+{
+    LOG_DEBUG("send codecs (%zu) to \"%s\"", codecs.size(), name_.c_str());
+    conn_->send_codecs_1_8(codecs);
+}
+
 void ClientConnectionLoggingWrapper::flush()
 {
     conn_->flush();
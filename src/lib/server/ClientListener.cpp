@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY SERVER
+
 #include "server/ClientListener.h"
 
 #include "server/ClientProxy.h"
@@ -16,14 +16,17 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY PROTOCOL
+
 #include "server/ClientProxy1_6.h"
 #include "ClientConnectionByStream.h"
 
 #include "inputleap/ProtocolUtil.h"
 #include "inputleap/ClipboardChunk.h"
+#include "inputleap/ClipboardStreamer.h"
 #include "inputleap/Exceptions.h"
 #include "inputleap/FileChunk.h"
-#include "inputleap/StreamChunker.h"
+#include "inputleap/FileStreamer.h"
 #include "server/Server.h"
 #include "io/IStream.h"
 #include "base/Log.h"
@@ -56,13 +59,16 @@ ClientProxy1_6::ClientProxy1_6(const std::string& name,
                           [this](const auto& e){ handle_disconnect(); });
     m_events->add_handler(EventType::STREAM_OUTPUT_SHUTDOWN, get_conn().get_event_target(),
                           [this](const auto& e){ handle_write_error(); });
-    m_events->add_handler(EventType::FILE_KEEPALIVE, this,
-                          [this](const auto& e){ keepAlive(); });
-    m_events->add_handler(EventType::CLIPBOARD_SENDING, this,
-                          [this](const auto& e){ handle_clipboard_sending_event(e); });
+    m_events->add_handler(EventType::STREAM_OUTPUT_FLUSHED, get_conn().get_event_target(),
+                          [this](const auto& e){ handle_output_flushed(); });
     m_events->add_handler(EventType::TIMER, this,
                           [this](const auto& e){ handle_flatline(); });
 
+    clipboard_streamer_ = std::make_unique<ClipboardStreamer>(getStream(),
+        [this](const ClipboardChunk& chunk) { get_conn().send_clipboard_chunk_1_6(chunk); });
+    file_streamer_ = std::make_unique<FileStreamer>(m_events, getStream(),
+        [this](const FileChunk& chunk) { get_conn().send_file_chunk_1_6(chunk); });
+
     setHeartbeatRate(kHeartRate, kHeartRate * kHeartBeatsUntilDeath);
 
     get_conn().send_query_info_1_6();
@@ -95,8 +101,7 @@ void ClientProxy1_6::remove_handlers()
     m_events->remove_handler(EventType::STREAM_INPUT_SHUTDOWN, get_conn().get_event_target());
     m_events->remove_handler(EventType::STREAM_OUTPUT_SHUTDOWN, get_conn().get_event_target());
     m_events->remove_handler(EventType::STREAM_INPUT_FORMAT_ERROR, get_conn().get_event_target());
-    m_events->remove_handler(EventType::FILE_KEEPALIVE, this);
-    m_events->remove_handler(EventType::CLIPBOARD_SENDING, this);
+    m_events->remove_handler(EventType::STREAM_OUTPUT_FLUSHED, get_conn().get_event_target());
     m_events->remove_handler(EventType::TIMER, this);
 
     // remove timer
@@ -258,6 +263,12 @@ void ClientProxy1_6::handle_write_error()
     disconnect();
 }
 
+void ClientProxy1_6::handle_output_flushed()
+{
+    clipboard_streamer_->pump();
+    file_streamer_->pump();
+}
+
 void ClientProxy1_6::handle_flatline()
 {
     // didn't get a heartbeat fast enough.  assume client is dead.
@@ -265,14 +276,9 @@ void ClientProxy1_6::handle_flatline()
     disconnect();
 }
 
-void ClientProxy1_6::handle_clipboard_sending_event(const Event& event)
-{
-    get_conn().send_clipboard_chunk_1_6(event.get_data_as<ClipboardChunk>());
-}
-
 bool ClientProxy1_6::getClipboard(ClipboardID id, IClipboard* clipboard) const
 {
-    Clipboard::copy(clipboard, &m_clipboard[id].m_clipboard);
+    IClipboard::unmarshall(clipboard, *m_clipboard[id].data_, 0);
     return true;
 }
 
@@ -305,20 +311,16 @@ bool ClientProxy1_6::leave()
     return true;
 }
 
-void ClientProxy1_6::setClipboard(ClipboardID id, const IClipboard* clipboard)
+void ClientProxy1_6::setClipboard(ClipboardID id, const Clipboard* clipboard)
 {
     // ignore if this clipboard is already clean
     if (m_clipboard[id].m_dirty) {
         // this clipboard is now clean
         m_clipboard[id].m_dirty = false;
-        Clipboard::copy(&m_clipboard[id].m_clipboard, clipboard);
-
-        std::string data = m_clipboard[id].m_clipboard.marshall();
+        m_clipboard[id].data_ = clipboard->marshalled();
 
-        size_t size = data.size();
         LOG_DEBUG("sending clipboard %d to \"%s\"", id, getName().c_str());
-
-        StreamChunker::sendClipboard(data, size, id, 0, m_events, this);
+        clipboard_streamer_->send(m_clipboard[id].data_, id, 0);
     }
 }
 
@@ -382,9 +384,14 @@ void ClientProxy1_6::sendDragInfo(std::uint32_t fileCount, const char* info, siz
     get_conn().send_drag_info_1_6(fileCount, data);
 }
 
-void ClientProxy1_6::file_chunk_sending(const FileChunk& chunk)
+void ClientProxy1_6::send_files(const std::vector<std::string>& filenames)
+{
+    file_streamer_->send(filenames);
+}
+
+void ClientProxy1_6::cancel_file()
 {
-    get_conn().send_file_chunk_1_6(chunk);
+    file_streamer_->cancel();
 }
 
 void ClientProxy1_6::screensaver(bool on)
@@ -467,7 +474,7 @@ bool ClientProxy1_6::recvClipboard()
         LOG_DEBUG("received client \"%s\" clipboard %d seqnum=%d, size=%zd",
                 getName().c_str(), id, seq, dataCached.size());
         // save clipboard
-        m_clipboard[id].m_clipboard.unmarshall(dataCached, 0);
+        m_clipboard[id].data_ = std::make_shared<const std::string>(std::move(dataCached));
         m_clipboard[id].m_sequenceNumber = seq;
 
         // notify
@@ -514,8 +521,7 @@ void ClientProxy1_6::keepAlive()
 void ClientProxy1_6::fileChunkReceived()
 {
     Server* server = getServer();
-    int result = FileChunk::assemble(getStream(), server->getReceivedFileData(),
-                                     server->getExpectedFileSize());
+    int result = server->get_file_receiver().receive(getStream());
 
     if (result == kFinish) {
         m_events->add_event(EventType::FILE_RECEIVE_COMPLETED, server);
@@ -538,7 +544,7 @@ void ClientProxy1_6::dragInfoReceived()
 }
 
 ClientProxy1_6::ClientClipboard::ClientClipboard() :
-    m_clipboard(),
+    data_(Clipboard().marshalled()),
     m_sequenceNumber(0),
     m_dirty(true)
 {
@@ -21,6 +21,7 @@
 #include "server/ClientProxy.h"
 #include "base/Fwd.h"
 #include "inputleap/Clipboard.h"
+#include "inputleap/Fwd.h"
 #include "inputleap/protocol_types.h"
 
 namespace inputleap {
@@ -49,7 +50,7 @@ public:
     void enter(std::int32_t xAbs, std::int32_t yAbs, std::uint32_t seqNum, KeyModifierMask mask,
                bool forScreensaver) override;
     bool leave() override;
-    void setClipboard(ClipboardID, const IClipboard*) override;
+    void setClipboard(ClipboardID, const Clipboard*) override;
     void grabClipboard(ClipboardID) override;
     void setClipboardDirty(ClipboardID, bool) override;
     void keyDown(KeyID, KeyModifierMask, KeyButton) override;
@@ -64,7 +65,8 @@ public:
     void resetOptions() override;
     void setOptions(const OptionsList& options) override;
     void sendDragInfo(std::uint32_t fileCount, const char* info, size_t size) override;
-    void file_chunk_sending(const FileChunk& chunk) override;
+    void send_files(const std::vector<std::string>& filenames) override;
+    void cancel_file() override;
 
 protected:
     virtual bool parseHandshakeMessage(const std::uint8_t* code);
@@ -88,8 +90,8 @@ private:
     void handle_data();
     void handle_disconnect();
     void handle_write_error();
+    void handle_output_flushed();
     void handle_flatline();
-    void handle_clipboard_sending_event(const Event& event);
 
     bool recvInfo();
     bool recvGrabClipboard();
@@ -100,13 +102,18 @@ protected:
         ClientClipboard();
 
     public:
-        Clipboard m_clipboard;
+        // marshalled clipboard, shared with the server and other clients
+        std::shared_ptr<const std::string> data_;
         std::uint32_t m_sequenceNumber;
         bool m_dirty;
     };
 
     ClientClipboard m_clipboard[kClipboardEnd];
 
+    // send clipboards and files as the stream takes them
+    std::unique_ptr<ClipboardStreamer> clipboard_streamer_;
+    std::unique_ptr<FileStreamer> file_streamer_;
+
 protected:
     typedef bool (ClientProxy1_6::*MessageParser)(const std::uint8_t*);
 
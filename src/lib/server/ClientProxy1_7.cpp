@@ -0,0 +1,100 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define INPUTLEAP_LOG_CATEGORY PROTOCOL
+
+#include "server/ClientProxy1_7.h"
+#include "server/IClientConnection.h"
+#include "inputleap/ProtocolUtil.h"
+#include "inputleap/ClipboardStreamer.h"
+#include "base/Log.h"
+
+#include <cstring>
+
+namespace inputleap {
+
+ClientProxy1_7::ClientProxy1_7(const std::string& name,
+                               std::unique_ptr<IClientConnection> backend,
+                               Server* server, IEventQueue* events) :
+    ClientProxy1_6(name, std::move(backend), server, events)
+{
+}
+
+ClientProxy1_7::~ClientProxy1_7()
+{
+}
+
+void ClientProxy1_7::setClipboard(ClipboardID id, const Clipboard* clipboard)
+{
+    // ignore if this clipboard is already clean
+    if (m_clipboard[id].m_dirty) {
+        // this clipboard is now clean
+        m_clipboard[id].m_dirty = false;
+        m_clipboard[id].data_ = clipboard->marshalled();
+
+        // only tell the client what we have.  it asks for the data
+        // when it needs it.
+        LOG_DEBUG("offering clipboard %d to \"%s\"", id, getName().c_str());
+        get_conn().send_clipboard_formats_1_7(id, clipboard->formats());
+        offered_[id] = true;
+    }
+}
+
+void ClientProxy1_7::grabClipboard(ClipboardID id)
+{
+    ClientProxy1_6::grabClipboard(id);
+
+    // whatever we offered is gone
+    offered_[id] = false;
+}
+
+bool ClientProxy1_7::parseMessage(const std::uint8_t* code)
+{
+    if (memcmp(code, kMsgQClipboard, 4) == 0) {
+        return recvQueryClipboard();
+    }
+    return ClientProxy1_6::parseMessage(code);
+}
+
+bool ClientProxy1_7::recvQueryClipboard()
+{
+    // parse message
+    ClipboardID id;
+    std::uint32_t seqNum;
+    if (!ProtocolUtil::readf(getStream(), kMsgQClipboard + 4, &id, &seqNum)) {
+        return false;
+    }
+
+    // validate
+    if (id >= kClipboardEnd) {
+        return false;
+    }
+
+    // the client may still ask for a clipboard it lost in the meantime
+    if (!offered_[id]) {
+        LOG_DEBUG("ignored client \"%s\" query for clipboard %d (not offered)",
+                  getName().c_str(), id);
+        return true;
+    }
+    offered_[id] = false;
+
+    LOG_DEBUG("sending clipboard %d to \"%s\"", id, getName().c_str());
+    clipboard_streamer_->send(m_clipboard[id].data_, id, 0);
+    return true;
+}
+
+} // namespace inputleap
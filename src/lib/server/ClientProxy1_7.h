@@ -0,0 +1,52 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "server/ClientProxy1_6.h"
+
+namespace inputleap {
+
+//! Proxy for client implementing protocol version 1.7
+/*!
+Clipboards are offered to the client as a list of formats and sizes and
+only sent once the client asks for them, i.e. when something on the
+client wants to paste.
+*/
+class ClientProxy1_7 : public ClientProxy1_6 {
+public:
+    ClientProxy1_7(const std::string& name, std::unique_ptr<IClientConnection> backend,
+                   Server* server, IEventQueue* events);
+    ~ClientProxy1_7() override;
+
+    // IClient overrides
+    void setClipboard(ClipboardID, const Clipboard*) override;
+    void grabClipboard(ClipboardID) override;
+
+protected:
+    // ClientProxy1_6 overrides
+    bool parseMessage(const std::uint8_t* code) override;
+
+private:
+    bool recvQueryClipboard();
+
+private:
+    // true while the client may ask for the offered clipboard
+    bool offered_[kClipboardEnd] = {};
+};
+
+} // namespace inputleap
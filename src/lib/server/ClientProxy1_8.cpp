@@ -0,0 +1,76 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define INPUTLEAP_LOG_CATEGORY PROTOCOL
+
+#include "server/ClientProxy1_8.h"
+#include "server/IClientConnection.h"
+#include "inputleap/ChunkCodec.h"
+#include "inputleap/ClipboardStreamer.h"
+#include "inputleap/FileStreamer.h"
+#include "inputleap/ProtocolUtil.h"
+#include "base/Log.h"
+
+#include <cstring>
+
+namespace inputleap {
+
+ClientProxy1_8::ClientProxy1_8(const std::string& name,
+                               std::unique_ptr<IClientConnection> backend,
+                               Server* server, IEventQueue* events) :
+    ClientProxy1_7(name, std::move(backend), server, events)
+{
+    get_conn().send_codecs_1_8(supported_chunk_codecs());
+}
+
+ClientProxy1_8::~ClientProxy1_8()
+{
+}
+
+bool ClientProxy1_8::parseHandshakeMessage(const std::uint8_t* code)
+{
+    // the client may answer before it sends its info
+    if (memcmp(code, kMsgDCodecs, 4) == 0) {
+        return recvCodecs();
+    }
+    return ClientProxy1_7::parseHandshakeMessage(code);
+}
+
+bool ClientProxy1_8::parseMessage(const std::uint8_t* code)
+{
+    if (memcmp(code, kMsgDCodecs, 4) == 0) {
+        return recvCodecs();
+    }
+    return ClientProxy1_7::parseMessage(code);
+}
+
+bool ClientProxy1_8::recvCodecs()
+{
+    std::vector<std::uint8_t> codecs;
+    if (!ProtocolUtil::readf(getStream(), kMsgDCodecs + 4, &codecs)) {
+        return false;
+    }
+
+    ChunkCodec codec = choose_chunk_codec(codecs);
+    LOG_DEBUG("client \"%s\" decompresses %zu codecs, using codec %d",
+              getName().c_str(), codecs.size(), static_cast<int>(codec));
+    clipboard_streamer_->set_codec(codec);
+    file_streamer_->set_codec(codec);
+    return true;
+}
+
+} // namespace inputleap
@@ -16,12 +16,16 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY PROTOCOL
+
 #include "server/ClientProxyUnknown.h"
 #include "ClientConnectionByStream.h"
 #include "ClientConnectionLoggingWrapper.h"
 #include "base/ELevel.h"
 #include "server/Server.h"
 #include "server/ClientProxy1_6.h"
+#include "server/ClientProxy1_7.h"
+#include "server/ClientProxy1_8.h"
 #include "inputleap/protocol_types.h"
 #include "inputleap/ProtocolUtil.h"
 #include "inputleap/Exceptions.h"
@@ -185,6 +189,12 @@ void ClientProxyUnknown::handle_data()
                 case 6:
                     m_proxy = new ClientProxy1_6(name, std::move(conn), m_server, m_events);
                     break;
+                case 7:
+                    m_proxy = new ClientProxy1_7(name, std::move(conn), m_server, m_events);
+                    break;
+                case 8:
+                    m_proxy = new ClientProxy1_8(name, std::move(conn), m_server, m_events);
+                    break;
                 default:
                     break;
                 }
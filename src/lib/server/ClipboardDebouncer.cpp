@@ -0,0 +1,61 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ClipboardDebouncer.h"
+
+#include <algorithm>
+
+namespace inputleap {
+
+ClipboardDebouncer::ClipboardDebouncer(double quiet_period, double max_rate)
+{
+    configure(quiet_period, max_rate);
+}
+
+void ClipboardDebouncer::configure(double quiet_period, double max_rate)
+{
+    quiet_period_ = std::max(quiet_period, 0.0);
+    min_interval_ = max_rate > 0.0 ? 1.0 / max_rate : 0.0;
+}
+
+double ClipboardDebouncer::changed(double now)
+{
+    pending_ = true;
+    last_change_ = now;
+    return remaining(now);
+}
+
+void ClipboardDebouncer::updated(double now)
+{
+    pending_ = false;
+    updated_ = true;
+    last_update_ = now;
+}
+
+double ClipboardDebouncer::remaining(double now) const
+{
+    if (!pending_) {
+        return 0.0;
+    }
+    double due = last_change_ + quiet_period_;
+    if (updated_) {
+        due = std::max(due, last_update_ + min_interval_);
+    }
+    return std::max(due - now, 0.0);
+}
+
+} // namespace inputleap
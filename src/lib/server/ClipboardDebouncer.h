@@ -0,0 +1,77 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+namespace inputleap {
+
+//! Decides when a changing clipboard has settled
+/*!
+Tracks the pending update of one clipboard.  An update is due once the
+clipboard was left alone for the quiet period and at least the minimum
+interval has passed since the previous update, so a burst of changes is
+propagated once, with its final state.  Times are in seconds on any
+monotonic clock.
+*/
+class ClipboardDebouncer {
+public:
+    ClipboardDebouncer() = default;
+    ClipboardDebouncer(double quiet_period, double max_rate);
+
+    //! @name manipulators
+    //@{
+
+    //! Wait for \p quiet_period and update at most \p max_rate times a second
+    /*!
+    A \p max_rate of zero or less means no limit.
+    */
+    void configure(double quiet_period, double max_rate);
+
+    //! Record a change at \p now
+    /*!
+    Returns the seconds until the update is due.
+    */
+    double changed(double now);
+
+    //! Record that the pending update was propagated at \p now
+    void updated(double now);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Test if changes are propagated without waiting
+    bool is_immediate() const { return quiet_period_ <= 0.0 && min_interval_ <= 0.0; }
+
+    //! Test if an update is pending
+    bool is_pending() const { return pending_; }
+
+    //! Returns the seconds until the pending update is due, 0 if it is due
+    double remaining(double now) const;
+
+    //@}
+
+private:
+    double quiet_period_ = 0.0;
+    double min_interval_ = 0.0;
+    bool pending_ = false;
+    bool updated_ = false;
+    double last_change_ = 0.0;
+    double last_update_ = 0.0;
+};
+
+} // namespace inputleap
@@ -726,6 +726,9 @@ Config::readSectionOptions(ConfigReadContext& s)
 		else if (name == "clipboardSharingSize") {
 			addOption("", kOptionClipboardSharingSize, s.parseInt(value));
 		}
+		else if (name == "clipboardSelectionRate") {
+			addOption("", kOptionClipboardSelectionRate, s.parseInt(value));
+		}
 
 		else {
 			handled = false;
@@ -1338,6 +1341,9 @@ Config::getOptionName(OptionID id)
 	if (id == kOptionClipboardSharingSize) {
 		return "clipboardSharingSize";
 	}
+	if (id == kOptionClipboardSelectionRate) {
+		return "clipboardSelectionRate";
+	}
 	return nullptr;
 }
 
@@ -1390,7 +1396,8 @@ std::string Config::getOptionValue(OptionID id, OptionValue value)
 	if (id == kOptionHeartbeat ||
 		id == kOptionScreenSwitchCornerSize ||
 		id == kOptionScreenSwitchDelay ||
-		id == kOptionScreenSwitchTwoTap) {
+		id == kOptionScreenSwitchTwoTap ||
+		id == kOptionClipboardSelectionRate) {
 		return inputleap::string::sprintf("%d", value);
 	}
 	if (id == kOptionScreenSwitchCorners) {
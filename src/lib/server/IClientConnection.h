@@ -19,10 +19,12 @@
 #include "base/Fwd.h"
 #include "inputleap/Fwd.h"
 #include "inputleap/clipboard_types.h"
+#include "inputleap/IClipboard.h"
 #include "inputleap/key_types.h"
 #include "inputleap/mouse_types.h"
 #include "inputleap/option_types.h"
 #include <string>
+#include <vector>
 
 namespace inputleap {
 
@@ -61,6 +63,9 @@ public:
     virtual void send_clipboard_chunk_1_6(const ClipboardChunk& chunk) = 0;
     virtual void send_file_chunk_1_6(const FileChunk& chunk) = 0;
     virtual void send_grab_clipboard(ClipboardID id) = 0;
+    virtual void send_clipboard_formats_1_7(ClipboardID id,
+                                            const IClipboard::FormatList& formats) = 0;
+    virtual void send_codecs_1_8(const std::vector<std::uint8_t>& codecs) = 0;
 
     virtual void flush() = 0;
     virtual void close() = 0;
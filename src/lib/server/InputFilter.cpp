@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY SERVER
+
 #include "server/InputFilter.h"
 #include "server/Server.h"
 #include "server/PrimaryClient.h"
@@ -28,6 +30,32 @@
 
 namespace inputleap {
 
+constexpr std::uint64_t InputFilter::kAnyEvent;
+
+namespace {
+
+// modifiers that cannot be combined with a mouse button
+const KeyModifierMask s_buttonIgnoreMask =
+    KeyModifierAltGr | KeyModifierCapsLock |
+    KeyModifierNumLock | KeyModifierScrollLock;
+
+// event keys are tagged in the high byte so hot key ids and button
+// combinations can't collide and no key is kAnyEvent
+const std::uint64_t kHotKeyEventKey = std::uint64_t(1) << 56;
+const std::uint64_t kButtonEventKey = std::uint64_t(2) << 56;
+
+std::uint64_t hot_key_event_key(std::uint32_t id)
+{
+    return kHotKeyEventKey | id;
+}
+
+std::uint64_t button_event_key(ButtonID button, KeyModifierMask mask)
+{
+    return kButtonEventKey | (std::uint64_t(button) << 32) | mask;
+}
+
+} // namespace
+
 // -----------------------------------------------------------------------------
 // Input Filter Condition Classes
 // -----------------------------------------------------------------------------
@@ -41,6 +69,11 @@ InputFilter::Condition::~Condition()
     // do nothing
 }
 
+std::uint64_t InputFilter::Condition::event_key() const
+{
+    return kAnyEvent;
+}
+
 void
 InputFilter::Condition::enablePrimary(PrimaryClient*)
 {
@@ -121,6 +154,11 @@ InputFilter::KeystrokeCondition::match(const Event& event)
     return status;
 }
 
+std::uint64_t InputFilter::KeystrokeCondition::event_key() const
+{
+    return hot_key_event_key(m_id);
+}
+
 void
 InputFilter::KeystrokeCondition::enablePrimary(PrimaryClient* primary)
 {
@@ -181,10 +219,6 @@ std::string InputFilter::MouseButtonCondition::format() const
 InputFilter::EFilterStatus
 InputFilter::MouseButtonCondition::match(const Event& event)
 {
-    static const KeyModifierMask s_ignoreMask =
-        KeyModifierAltGr | KeyModifierCapsLock |
-        KeyModifierNumLock | KeyModifierScrollLock;
-
     EFilterStatus status;
 
     // check for hotkey events
@@ -201,15 +235,21 @@ InputFilter::MouseButtonCondition::match(const Event& event)
     // check if it's the right button and modifiers.  ignore modifiers
     // that cannot be combined with a mouse button.
     const auto& minfo = event.get_data_as<IPlatformScreen::ButtonInfo>();
-    if (minfo.m_button != m_button || (minfo.m_mask & ~s_ignoreMask) != m_mask) {
+    if (minfo.m_button != m_button || (minfo.m_mask & ~s_buttonIgnoreMask) != m_mask) {
         return kNoMatch;
     }
 
     return status;
 }
 
+std::uint64_t InputFilter::MouseButtonCondition::event_key() const
+{
+    return button_event_key(m_button, m_mask);
+}
+
 InputFilter::ScreenConnectedCondition::ScreenConnectedCondition(const std::string& screen) :
-    m_screen(screen)
+    m_screen(screen),
+    screen_id_(screen.empty() ? ScreenId() : ScreenId::intern(screen))
 {
     // do nothing
 }
@@ -235,7 +275,7 @@ InputFilter::ScreenConnectedCondition::match(const Event& event)
 {
     if (event.getType() == EventType::SERVER_CONNECTED) {
         const auto& info = event.get_data_as<Server::ScreenConnectedInfo>();
-        if (m_screen == info.m_screen || m_screen.empty()) {
+        if (screen_id_ == info.m_id || !screen_id_.is_valid()) {
             return kActivate;
         }
     }
@@ -297,7 +337,8 @@ InputFilter::LockCursorToScreenAction::perform(IEventQueue* queue, const Event&
 }
 
 InputFilter::SwitchToScreenAction::SwitchToScreenAction(const std::string& screen) :
-    m_screen(screen)
+    m_screen(screen),
+    screen_id_(screen.empty() ? ScreenId() : ScreenId::intern(screen))
 {
 }
 
@@ -323,13 +364,15 @@ InputFilter::SwitchToScreenAction::perform(IEventQueue* queue, const Event& even
     // pick screen name.  if m_screen is empty then use the screen from
     // event if it has one.
     std::string screen = m_screen;
+    ScreenId id = screen_id_;
     if (screen.empty() && event.getType() == EventType::SERVER_CONNECTED) {
         const auto& info = event.get_data_as<Server::ScreenConnectedInfo>();
         screen = info.m_screen;
+        id = info.m_id;
     }
 
     // send event
-    Server::SwitchToScreenInfo info{screen};
+    Server::SwitchToScreenInfo info{screen, id};
     queue->add_event(EventType::SERVER_SWITCH_TO_SCREEN, event.getTarget(),
                         create_event_data<Server::SwitchToScreenInfo>(info),
                         Event::kDeliverImmediately);
@@ -813,6 +856,7 @@ InputFilter::InputFilter(const InputFilter& x) :
     m_primaryClient(nullptr),
     m_events(x.m_events)
 {
+    rebuild_index();
     setPrimaryClient(x.m_primaryClient);
 }
 
@@ -829,6 +873,7 @@ InputFilter::operator=(const InputFilter& x)
         setPrimaryClient(nullptr);
 
         m_ruleList = x.m_ruleList;
+        rebuild_index();
 
         setPrimaryClient(oldClient);
     }
@@ -842,6 +887,7 @@ InputFilter::addFilterRule(const Rule& rule)
     if (m_primaryClient != nullptr) {
         m_ruleList.back().enable(m_primaryClient);
     }
+    index_rule(m_ruleList.size() - 1);
 }
 
 void InputFilter::add_rules(const std::vector<Rule>& rules)
@@ -875,6 +921,11 @@ InputFilter::setPrimaryClient(PrimaryClient* client)
 
     m_primaryClient = client;
 
+    // hot key ids change with the primary client
+    if (m_primaryClient == nullptr) {
+        rebuild_index();
+    }
+
     if (m_primaryClient != nullptr) {
         auto event_target = m_primaryClient->get_event_target();
         m_events->add_handler(EventType::KEY_STATE_KEY_DOWN, event_target,
@@ -897,6 +948,51 @@ InputFilter::setPrimaryClient(PrimaryClient* client)
         for (auto rule = m_ruleList.begin(); rule != m_ruleList.end(); ++rule) {
             rule->enable(m_primaryClient);
         }
+        rebuild_index();
+    }
+}
+
+std::uint64_t InputFilter::event_key(const Event& event)
+{
+    switch (event.getType()) {
+    case EventType::PRIMARY_SCREEN_HOTKEY_DOWN:
+    case EventType::PRIMARY_SCREEN_HOTKEY_UP:
+        return hot_key_event_key(event.get_data_as<IPlatformScreen::HotKeyInfo>().m_id);
+
+    case EventType::PRIMARY_SCREEN_BUTTON_DOWN:
+    case EventType::PRIMARY_SCREEN_BUTTON_UP: {
+        const auto& info = event.get_data_as<IPlatformScreen::ButtonInfo>();
+        return button_event_key(info.m_button, info.m_mask & ~s_buttonIgnoreMask);
+    }
+
+    default:
+        return kAnyEvent;
+    }
+}
+
+void InputFilter::index_rule(std::size_t index)
+{
+    // rules are indexed in order so each list stays sorted
+    const Condition* condition = m_ruleList[index].getCondition();
+    if (condition == nullptr) {
+        // never matches
+        return;
+    }
+    std::uint64_t key = condition->event_key();
+    if (key == kAnyEvent) {
+        unkeyed_rules_.push_back(index);
+    }
+    else {
+        rules_by_key_[key].push_back(index);
+    }
+}
+
+void InputFilter::rebuild_index()
+{
+    rules_by_key_.clear();
+    unkeyed_rules_.clear();
+    for (std::size_t i = 0; i < m_ruleList.size(); ++i) {
+        index_rule(i);
     }
 }
 
@@ -906,9 +1002,28 @@ void InputFilter::handle_event(const Event& event)
     Event myEvent(event.getType(), this, nullptr, event.getFlags() | Event::kDeliverImmediately);
     myEvent.clone_data_from(event);
 
-    // let each rule try to match the event until one does
-    for (auto rule = m_ruleList.begin(); rule != m_ruleList.end(); ++rule) {
-        if (rule->handle_event(m_events, myEvent)) {
+    // only rules with the event's key and unkeyed rules can match.  let
+    // each of them, in rule order, try to match the event until one does.
+    static const RuleIndexList s_noRules;
+    const RuleIndexList* keyed = &s_noRules;
+    std::uint64_t key = event_key(myEvent);
+    if (key != kAnyEvent) {
+        auto i = rules_by_key_.find(key);
+        if (i != rules_by_key_.end()) {
+            keyed = &i->second;
+        }
+    }
+    auto a = keyed->begin();
+    auto b = unkeyed_rules_.begin();
+    while (a != keyed->end() || b != unkeyed_rules_.end()) {
+        std::size_t index;
+        if (b == unkeyed_rules_.end() || (a != keyed->end() && *a < *b)) {
+            index = *a++;
+        }
+        else {
+            index = *b++;
+        }
+        if (m_ruleList[index].handle_event(m_events, myEvent)) {
             // handled
             return;
         }
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "server/ScreenId.h"
 #include "base/Fwd.h"
 #include "base/EventTarget.h"
 #include "inputleap/key_types.h"
@@ -27,6 +28,7 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 
 namespace inputleap {
 
@@ -43,6 +45,9 @@ public:
         kDeactivate
     };
 
+    // event key of conditions that don't restrict the events they match
+    static constexpr std::uint64_t kAnyEvent = 0;
+
     class Condition {
     public:
         Condition();
@@ -53,6 +58,11 @@ public:
 
         virtual EFilterStatus match(const Event&) = 0;
 
+        // returns the key of the only events match() can accept (see
+        // InputFilter::event_key()) or kAnyEvent if it must see them all.
+        // valid once the condition is enabled.
+        virtual std::uint64_t event_key() const;
+
         virtual void enablePrimary(PrimaryClient*);
         virtual void disablePrimary(PrimaryClient*);
     };
@@ -71,6 +81,7 @@ public:
         Condition* clone() const override;
         std::string format() const override;
         EFilterStatus match(const Event&) override;
+        std::uint64_t event_key() const override;
         void enablePrimary(PrimaryClient*) override;
         void disablePrimary(PrimaryClient*) override;
 
@@ -94,6 +105,7 @@ public:
         Condition* clone() const override;
         std::string format() const override;
         EFilterStatus match(const Event&) override;
+        std::uint64_t event_key() const override;
 
     private:
         ButtonID m_button;
@@ -113,6 +125,7 @@ public:
 
     private:
         std::string m_screen;
+        ScreenId screen_id_;
     };
 
     // -------------------------------------------------------------------------
@@ -162,6 +175,7 @@ public:
 
     private:
         std::string m_screen;
+        ScreenId screen_id_;
     };
 
     // ToggleScreenAction
@@ -332,12 +346,28 @@ public:
 
     const std::vector<Rule>& get_rules() const { return m_ruleList; }
 
+    // returns the key that a condition accepting \p event reports from
+    // Condition::event_key(), or kAnyEvent if no keyed condition can
+    // accept it
+    static std::uint64_t event_key(const Event& event);
+
 private:
     // event handling
     void handle_event(const Event&);
 
+    // rule index maintenance
+    void index_rule(std::size_t index);
+    void rebuild_index();
+
 private:
+    typedef std::vector<std::size_t> RuleIndexList;
+
     RuleList m_ruleList;
+    // indices into m_ruleList, in rule order, of the rules whose
+    // condition has an event key and of those that have to see every
+    // event
+    std::unordered_map<std::uint64_t, RuleIndexList> rules_by_key_;
+    RuleIndexList unkeyed_rules_;
     PrimaryClient* m_primaryClient;
     IEventQueue* m_events;
 };
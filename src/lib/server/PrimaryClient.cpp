@@ -144,7 +144,7 @@ PrimaryClient::leave()
 }
 
 void
-PrimaryClient::setClipboard(ClipboardID id, const IClipboard* clipboard)
+PrimaryClient::setClipboard(ClipboardID id, const Clipboard* clipboard)
 {
     // ignore if this clipboard is already clean
     if (m_clipboardDirty[id]) {
@@ -243,13 +243,18 @@ void PrimaryClient::sendDragInfo(std::uint32_t fileCount, const char* info, size
     // ignore
 }
 
-void PrimaryClient::file_chunk_sending(const FileChunk& chunk)
+void PrimaryClient::send_files(const std::vector<std::string>& filenames)
 {
-    (void) chunk;
+    (void) filenames;
 
     // ignore
 }
 
+void PrimaryClient::cancel_file()
+{
+    // ignore
+}
+
 void
 PrimaryClient::resetOptions()
 {
@@ -129,7 +129,7 @@ public:
     void enter(std::int32_t xAbs, std::int32_t yAbs, std::uint32_t seqNum, KeyModifierMask mask,
                bool forScreensaver) override;
     bool leave() override;
-    void setClipboard(ClipboardID, const IClipboard*) override;
+    void setClipboard(ClipboardID, const Clipboard*) override;
     void grabClipboard(ClipboardID) override;
     void setClipboardDirty(ClipboardID, bool) override;
     void keyDown(KeyID, KeyModifierMask, KeyButton) override;
@@ -144,7 +144,8 @@ public:
     void resetOptions() override;
     void setOptions(const OptionsList& options) override;
     void sendDragInfo(std::uint32_t fileCount, const char* info, size_t size) override;
-    void file_chunk_sending(const FileChunk& chunk) override;
+    void send_files(const std::vector<std::string>& filenames) override;
+    void cancel_file() override;
 
     virtual IClientConnection& get_conn() const override
     {
@@ -0,0 +1,90 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ScreenId.h"
+
+#include <cctype>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace inputleap {
+
+namespace {
+
+struct Registry {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::uint32_t> ids;     // by folded name
+    std::deque<std::string> names;                          // by id - 1
+};
+
+Registry& registry()
+{
+    static Registry s_registry;
+    return s_registry;
+}
+
+// same folding as CaselessCmp
+std::string fold(const std::string& name)
+{
+    std::string folded(name);
+    for (char& c : folded) {
+        c = static_cast<char>(tolower(c));
+    }
+    return folded;
+}
+
+} // namespace
+
+ScreenId ScreenId::intern(const std::string& name)
+{
+    Registry& r = registry();
+    std::string folded = fold(name);
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto i = r.ids.find(folded);
+    if (i != r.ids.end()) {
+        return ScreenId(i->second);
+    }
+    r.names.push_back(name);
+    std::uint32_t value = static_cast<std::uint32_t>(r.names.size());
+    r.ids.emplace(std::move(folded), value);
+    return ScreenId(value);
+}
+
+ScreenId ScreenId::find(const std::string& name)
+{
+    Registry& r = registry();
+    std::string folded = fold(name);
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto i = r.ids.find(folded);
+    return i == r.ids.end() ? ScreenId() : ScreenId(i->second);
+}
+
+const std::string& ScreenId::name() const
+{
+    static const std::string s_empty;
+    if (value_ == 0) {
+        return s_empty;
+    }
+
+    // deque elements don't move when others are added
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.names[value_ - 1];
+}
+
+} // namespace inputleap
@@ -0,0 +1,82 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace inputleap {
+
+//! Interned screen name
+/*!
+A small integer standing for a screen name.  Names that differ only in
+case get the same id, matching how screen names are compared everywhere
+else, so ids can be compared and hashed without touching the name.  The
+case folding happens once, in \c intern().
+
+Ids are process wide and never released, so only names from the
+configuration are interned;  names that come from the network, like
+the name a client connects with, are looked up with \c find().  A
+default constructed id is invalid and matches no name.
+*/
+class ScreenId {
+public:
+    ScreenId() = default;
+
+    //! Get the id for \p name, creating it if necessary
+    static ScreenId intern(const std::string& name);
+
+    //! Get the id for \p name
+    /*!
+    Returns an invalid id if \p name was never interned.
+    */
+    static ScreenId find(const std::string& name);
+
+    //! @name accessors
+    //@{
+
+    //! Returns false for a default constructed id
+    bool is_valid() const { return value_ != 0; }
+
+    //! Returns the id as a number, 0 if invalid
+    std::uint32_t value() const { return value_; }
+
+    //! Returns the name, spelled as when first interned
+    /*!
+    Returns an empty string for an invalid id.  Meant for logging.
+    */
+    const std::string& name() const;
+
+    bool operator==(const ScreenId& other) const { return value_ == other.value_; }
+    bool operator!=(const ScreenId& other) const { return value_ != other.value_; }
+    bool operator<(const ScreenId& other) const { return value_ < other.value_; }
+
+    //@}
+
+private:
+    explicit ScreenId(std::uint32_t value) : value_(value) { }
+
+    std::uint32_t value_ = 0;
+};
+
+struct ScreenIdHash {
+    std::size_t operator()(const ScreenId& id) const { return id.value(); }
+};
+
+} // namespace inputleap
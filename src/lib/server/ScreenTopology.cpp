@@ -0,0 +1,156 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ScreenTopology.h"
+
+#include "server/Config.h"
+#include "base/String.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace inputleap {
+
+constexpr ScreenTopology::Index ScreenTopology::kNoScreen;
+
+namespace {
+
+std::size_t side_slot(ScreenTopology::Index screen, EDirection side)
+{
+    return screen * kNumDirections + (side - kFirstDirection);
+}
+
+} // namespace
+
+ScreenTopology::ScreenTopology(const Config& config)
+{
+    // number the screens.  config iterates in canonical name order.
+    for (auto i = config.begin(); i != config.end(); ++i) {
+        names_.push_back(*i);
+        ids_.push_back(ScreenId::intern(*i));
+    }
+    for (auto i = config.beginAll(); i != config.endAll(); ++i) {
+        const std::string canonical = config.getCanonicalName(i->first);
+        auto screen = std::lower_bound(names_.begin(), names_.end(), canonical,
+                                       string::CaselessCmp());
+        if (screen == names_.end() || !string::CaselessCmp::equal(*screen, canonical)) {
+            continue;
+        }
+        ScreenId id = ScreenId::intern(i->first);
+        if (id.value() >= screens_by_id_.size()) {
+            screens_by_id_.resize(id.value() + 1, kNoScreen);
+        }
+        screens_by_id_[id.value()] = static_cast<Index>(screen - names_.begin());
+    }
+
+    // compile the links of each side
+    sides_.resize(names_.size() * kNumDirections);
+    for (Index screen = 0; screen < names_.size(); ++screen) {
+        std::vector<std::pair<EDirection, Link>> links;
+        for (auto i = config.beginNeighbor(names_[screen]);
+                i != config.endNeighbor(names_[screen]); ++i) {
+            Index dst = find(i->second.getName());
+            if (dst == kNoScreen) {
+                continue;
+            }
+            const Config::Interval src_interval = i->first.getInterval();
+            const Config::Interval dst_interval = i->second.getInterval();
+            Link link;
+            link.start     = src_interval.first;
+            link.end       = src_interval.second;
+            link.width     = src_interval.second - src_interval.first;
+            link.dst_start = dst_interval.first;
+            link.dst_width = dst_interval.second - dst_interval.first;
+            link.dst       = dst;
+            links.emplace_back(i->first.getSide(), link);
+        }
+        std::sort(links.begin(), links.end(),
+                  [](const std::pair<EDirection, Link>& a, const std::pair<EDirection, Link>& b)
+                  {
+                      if (a.first != b.first) {
+                          return a.first < b.first;
+                      }
+                      return a.second.start < b.second.start;
+                  });
+
+        for (const auto& link : links) {
+            Side& side = sides_[side_slot(screen, link.first)];
+            if (side.begin == side.end) {
+                side.begin = static_cast<std::uint32_t>(links_.size());
+            }
+            links_.push_back(link.second);
+            side.end = static_cast<std::uint32_t>(links_.size());
+        }
+    }
+}
+
+ScreenTopology::Index ScreenTopology::find(const std::string& name) const
+{
+    return find(ScreenId::find(name));
+}
+
+ScreenTopology::Index ScreenTopology::find(ScreenId id) const
+{
+    if (id.value() >= screens_by_id_.size()) {
+        return kNoScreen;
+    }
+    return screens_by_id_[id.value()];
+}
+
+ScreenTopology::Neighbor ScreenTopology::neighbor(Index screen, EDirection side,
+                                                  float position) const
+{
+    assert(side >= kFirstDirection && side <= kLastDirection);
+
+    Neighbor result;
+    if (screen >= names_.size()) {
+        return result;
+    }
+
+    // find the last link starting at or before position
+    const Side& links = sides_[side_slot(screen, side)];
+    const Link* begin = links_.data() + links.begin;
+    const Link* end   = links_.data() + links.end;
+    const Link* link  = std::upper_bound(begin, end, position,
+                                         [](float x, const Link& l) { return x < l.start; });
+    if (link == begin) {
+        return result;
+    }
+    --link;
+    if (position >= link->end) {
+        return result;
+    }
+
+    // same arithmetic as CellEdge::transform() and inverseTransform()
+    result.screen   = link->dst;
+    result.position = ((position - link->start) / link->width) * link->dst_width +
+                      link->dst_start;
+    return result;
+}
+
+bool ScreenTopology::has_neighbor(Index screen, EDirection side) const
+{
+    assert(side >= kFirstDirection && side <= kLastDirection);
+
+    if (screen >= names_.size()) {
+        return false;
+    }
+    const Side& links = sides_[side_slot(screen, side)];
+    return links.begin != links.end;
+}
+
+} // namespace inputleap
@@ -0,0 +1,127 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "server/ScreenId.h"
+#include "inputleap/protocol_types.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace inputleap {
+
+class Config;
+
+//! Compiled screen layout
+/*!
+An immutable copy of the links between the screens of a Config, built
+for the lookups the server does whenever the cursor hits an edge.
+Screens are numbered from zero in canonical name order and known by
+the ScreenId of their canonical name or of any alias.  Each side of a
+screen has its links sorted by position, with the mapping onto the
+neighbor's edge already worked out.  Lookups don't allocate or compare
+names.
+
+Build a new topology whenever the Config changes.
+*/
+class ScreenTopology {
+public:
+    using Index = std::uint32_t;
+
+    //! Index returned for unknown screens and missing neighbors
+    static constexpr Index kNoScreen = static_cast<Index>(-1);
+
+    //! A neighbor and the position on its edge
+    struct Neighbor {
+        Index screen = kNoScreen;
+        float position = 0.0f;
+    };
+
+    //! Create a topology without screens
+    ScreenTopology() = default;
+
+    //! Compile the screens and links of \p config
+    explicit ScreenTopology(const Config& config);
+
+    //! @name accessors
+    //@{
+
+    //! Returns the number of screens
+    std::size_t size() const { return names_.size(); }
+
+    //! Find a screen
+    /*!
+    Returns the index of the screen with the canonical name or alias
+    \p name, ignoring case, or \c kNoScreen if there's no such screen.
+    */
+    Index find(const std::string& name) const;
+
+    //! Find a screen
+    /*!
+    Returns the index of the screen whose canonical name or alias has
+    the id \p id, or \c kNoScreen if there's no such screen.
+    */
+    Index find(ScreenId id) const;
+
+    //! Returns the canonical name of screen \p screen
+    const std::string& name(Index screen) const { return names_[screen]; }
+
+    //! Returns the id of the canonical name of screen \p screen
+    ScreenId id(Index screen) const { return ids_[screen]; }
+
+    //! Find the neighbor at a position
+    /*!
+    Returns the screen linked to side \p side of \p screen at
+    \p position (from 0 to 1 along the side) and the matching position
+    on the neighbor's side.  The screen is \c kNoScreen if there is no
+    link there.  This matches Config::getNeighbor().
+    */
+    Neighbor neighbor(Index screen, EDirection side, float position) const;
+
+    //! Test for any neighbor on a side
+    bool has_neighbor(Index screen, EDirection side) const;
+
+    //@}
+
+private:
+    // a link from an interval of a side to an interval of another
+    // screen's side
+    struct Link {
+        float start;
+        float end;
+        float width;
+        float dst_start;
+        float dst_width;
+        Index dst;
+    };
+
+    // where the links of a side are in links_
+    struct Side {
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+    };
+
+    std::vector<std::string> names_;
+    std::vector<ScreenId> ids_;
+    std::vector<Index> screens_by_id_;      // indexed by ScreenId::value()
+    std::vector<Side> sides_;               // kNumDirections per screen
+    std::vector<Link> links_;
+};
+
+} // namespace inputleap
@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define INPUTLEAP_LOG_CATEGORY SERVER
+
 #include "server/Server.h"
 
 #include "server/ClientProxy.h"
@@ -29,7 +31,6 @@
 #include "inputleap/protocol_types.h"
 #include "inputleap/XScreen.h"
 #include "inputleap/Exceptions.h"
-#include "inputleap/StreamChunker.h"
 #include "inputleap/KeyState.h"
 #include "inputleap/Screen.h"
 #include "inputleap/PacketStreamFilter.h"
@@ -54,6 +55,17 @@
 
 namespace inputleap {
 
+namespace {
+
+// a selection that is being dragged out changes many times a second.  it
+// is propagated once it didn't change for this long, in seconds.
+const double kSelectionQuietPeriod = 0.1;
+
+// the default of kOptionClipboardSelectionRate, in updates per second
+const int kDefaultSelectionRate = 4;
+
+} // namespace
+
 Server::Server(
 		Config& config,
 		PrimaryClient* primaryClient,
@@ -87,7 +99,6 @@ Server::Server(
 	m_lockedToScreen(false),
 	m_screen(screen),
 	m_events(events),
-	m_sendFileThread(nullptr),
 	m_writeToDropDirThread(nullptr),
 	m_ignoreFileTransfer(false),
 	m_enableClipboard(true),
@@ -103,19 +114,24 @@ Server::Server(
 	assert(config.isScreen(primaryClient->getName()));
 	assert(m_screen != nullptr);
 
-    std::string primaryName = getName(primaryClient);
+	// compile the screen layout so clients can be looked up
+	topology_ = ScreenTopology(config);
+
+    ScreenId primaryId = get_id(primaryClient);
 
 	// clear clipboards
 	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
 		ClipboardInfo& clipboard   = m_clipboards[id];
-		clipboard.m_clipboardOwner  = primaryName;
+		clipboard.m_clipboardOwner  = primaryId;
 		clipboard.m_clipboardSeqNum = m_seqNum;
 		if (clipboard.m_clipboard.open(0)) {
 			clipboard.m_clipboard.clear();
 			clipboard.m_clipboard.close();
 		}
-		clipboard.m_clipboardData   = clipboard.m_clipboard.marshall();
+		clipboard.digest_           = clipboard.m_clipboard.digest();
 	}
+	m_clipboards[kClipboardSelection].debouncer_.configure(kSelectionQuietPeriod,
+														   kDefaultSelectionRate);
 
     // install event handlers
     m_events->add_handler(EventType::TIMER, this,
@@ -161,8 +177,6 @@ Server::Server(
                           [this](const auto& e){ handle_fake_input_end_event(); });
 
     if (m_args.m_enableDragDrop) {
-        m_events->add_handler(EventType::FILE_CHUNK_SENDING, this,
-                              [this](const auto& e){ handle_file_chunk_sending_event(e); });
         m_events->add_handler(EventType::FILE_RECEIVE_COMPLETED, this,
                               [this](const auto& e){ handle_file_receive_completed_event(e); });
 	}
@@ -206,6 +220,9 @@ Server::~Server()
     m_events->remove_handler(EventType::PRIMARY_SCREEN_FAKE_INPUT_END, &input_filter_);
     m_events->remove_handler(EventType::TIMER, this);
 	stopSwitch();
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		stopClipboardSettle(id);
+	}
 
 	// force immediate disconnection of secondary clients
 	disconnect();
@@ -233,6 +250,10 @@ Server::setConfig(const Config& config)
 		return false;
 	}
 
+	// compile the screen layout for edge lookups
+	topology_ = ScreenTopology(*m_config);
+	update_topology_clients();
+
 	// close clients that are connected but being dropped from the
 	// configuration.
 	closeClients(config);
@@ -301,7 +322,7 @@ Server::adoptClient(BaseClientProxy* client)
 	}
 
 	// send notification
-    Server::ScreenConnectedInfo info{getName(client)};
+    Server::ScreenConnectedInfo info{getName(client), get_id(client)};
     m_events->add_event(EventType::SERVER_CONNECTED, m_primaryClient->get_event_target(),
                         create_event_data<Server::ScreenConnectedInfo>(info));
 }
@@ -329,8 +350,26 @@ Server::getClients(std::vector<std::string>& list) const
 {
 	list.clear();
     for (auto index = m_clients.begin(); index != m_clients.end(); ++index) {
-		list.push_back(index->first);
+		list.push_back(canonical_name(index->first));
+	}
+}
+
+ScreenId Server::get_id(const BaseClientProxy* client) const
+{
+	ScreenTopology::Index index = topology_.find(client->get_id());
+	if (index == ScreenTopology::kNoScreen) {
+		return client->get_id();
+	}
+	return topology_.id(index);
+}
+
+const std::string& Server::canonical_name(ScreenId id) const
+{
+	ScreenTopology::Index index = topology_.find(id);
+	if (index == ScreenTopology::kNoScreen) {
+		return id.name();
 	}
+	return topology_.name(index);
 }
 
 std::string Server::getName(const BaseClientProxy* client) const
@@ -433,12 +472,15 @@ void Server::switchScreen(BaseClientProxy* dst, std::int32_t x, std::int32_t y,
 			return;
 		}
 
+		// the screens must agree on the clipboards before switching
+		settleClipboards();
+
 		// update the primary client's clipboards if we're leaving the
 		// primary screen.
 		if (m_active == m_primaryClient && m_enableClipboard) {
 			for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
 				ClipboardInfo& clipboard = m_clipboards[id];
-				if (clipboard.m_clipboardOwner == getName(m_primaryClient)) {
+				if (clipboard.m_clipboardOwner == get_id(m_primaryClient)) {
 					onClipboardChanged(m_primaryClient,
 						id, clipboard.m_clipboardSeqNum);
 				}
@@ -460,14 +502,14 @@ void Server::switchScreen(BaseClientProxy* dst, std::int32_t x, std::int32_t y,
 			// send the clipboard data to new active screen
 			for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
 				// Hackity hackity hack
-				if (m_clipboards[id].m_clipboard.marshall().size() > m_maximumClipboardSize) {
+				if (m_clipboards[id].m_clipboard.marshalled_size() > m_maximumClipboardSize) {
 					continue;
 				}
 				m_active->setClipboard(id, &m_clipboards[id].m_clipboard);
 			}
 		}
 
-        Server::SwitchToScreenInfo info{m_active->getName()};
+        Server::SwitchToScreenInfo info{m_active->getName(), m_active->get_id()};
         m_events->add_event(EventType::SERVER_SCREEN_SWITCHED, this,
                             create_event_data<Server::SwitchToScreenInfo>(info));
 	}
@@ -543,7 +585,29 @@ Server::hasAnyNeighbor(BaseClientProxy* client, EDirection dir) const
 {
 	assert(client != nullptr);
 
-	return m_config->hasNeighbor(getName(client), dir);
+	return topology_.has_neighbor(topology_index(client), dir);
+}
+
+ScreenTopology::Index Server::topology_index(const BaseClientProxy* client) const
+{
+    // there are only a handful of screens so a scan beats a lookup by name
+    for (std::size_t i = 0; i < topology_clients_.size(); ++i) {
+        if (topology_clients_[i] == client) {
+            return static_cast<ScreenTopology::Index>(i);
+        }
+    }
+    return ScreenTopology::kNoScreen;
+}
+
+void Server::update_topology_clients()
+{
+    topology_clients_.assign(topology_.size(), nullptr);
+    for (const auto& client : m_clients) {
+        ScreenTopology::Index index = topology_.find(client.first);
+        if (index != ScreenTopology::kNoScreen) {
+            topology_clients_[index] = client.second;
+        }
+    }
 }
 
 BaseClientProxy* Server::getNeighbor(BaseClientProxy* src, EDirection dir, std::int32_t& x,
@@ -553,44 +617,43 @@ BaseClientProxy* Server::getNeighbor(BaseClientProxy* src, EDirection dir, std::
 
 	assert(src != nullptr);
 
-	// get source screen name
-    std::string srcName = getName(src);
-	assert(!srcName.empty());
-	LOG_DEBUG2("find neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str());
+	// get source screen
+	ScreenTopology::Index srcIndex = topology_index(src);
+	LOG_DEBUG2("find neighbor on %s of \"%s\"", Config::dirName(dir), getName(src).c_str());
 
 	// convert position to fraction
 	float t = mapToFraction(src, dir, x, y);
 
-	// search for the closest neighbor that exists in direction dir
-	float tTmp;
-	for (;;) {
-        std::string dstName(m_config->getNeighbor(srcName, dir, t, &tTmp));
-
-		// if nothing in that direction then return nullptr. if the
-		// destination is the source then we can make no more
-		// progress in this direction.  since we haven't found a
-		// connected neighbor we return nullptr.
-		if (dstName.empty()) {
-			LOG_DEBUG2("no neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str());
+	// search for the closest neighbor that exists in direction dir.
+	// skipping more screens than there are means we're going around
+	// in a circle of unconnected screens.
+	for (std::size_t skipped = 0; skipped <= topology_.size(); ++skipped) {
+		ScreenTopology::Neighbor dst = topology_.neighbor(srcIndex, dir, t);
+
+		// if nothing in that direction then return nullptr
+		if (dst.screen == ScreenTopology::kNoScreen) {
+			LOG_DEBUG2("no neighbor on %s of \"%s\"", Config::dirName(dir), getName(src).c_str());
 			return nullptr;
 		}
 
-		// look up neighbor cell.  if the screen is connected and
-		// ready then we can stop.
-        auto index = m_clients.find(dstName);
-		if (index != m_clients.end()) {
-			LOG_DEBUG2("\"%s\" is on %s of \"%s\" at %f", dstName.c_str(), Config::dirName(dir), srcName.c_str(), t);
-			mapToPixel(index->second, dir, tTmp, x, y);
-			return index->second;
+		// if the screen is connected and ready then we can stop
+		BaseClientProxy* client = topology_clients_[dst.screen];
+		if (client != nullptr) {
+			LOG_DEBUG2("\"%s\" is on %s of \"%s\" at %f", topology_.name(dst.screen).c_str(),
+					   Config::dirName(dir), getName(src).c_str(), t);
+			mapToPixel(client, dir, dst.position, x, y);
+			return client;
 		}
 
 		// skip over unconnected screen
-		LOG_DEBUG2("ignored \"%s\" on %s of \"%s\"", dstName.c_str(), Config::dirName(dir), srcName.c_str());
-		srcName = dstName;
+		LOG_DEBUG2("ignored \"%s\" on %s of \"%s\"", topology_.name(dst.screen).c_str(),
+				   Config::dirName(dir), topology_.name(srcIndex).c_str());
+		srcIndex = dst.screen;
 
 		// use position on skipped screen
-		t = tTmp;
+		t = dst.position;
 	}
+	return nullptr;
 }
 
 BaseClientProxy* Server::mapToNeighbor(BaseClientProxy* src, EDirection srcSide, std::int32_t& x,
@@ -709,7 +772,7 @@ void Server::avoidJumpZone(BaseClientProxy* dst, EDirection dir, std::int32_t& x
 		return;
 	}
 
-    const std::string dstName(getName(dst));
+	const ScreenTopology::Index dstIndex = topology_index(dst);
 	std::int32_t dx, dy, dw, dh;
 	dst->getShape(dx, dy, dw, dh);
 	float t = mapToFraction(dst, dir, x, y);
@@ -720,25 +783,25 @@ void Server::avoidJumpZone(BaseClientProxy* dst, EDirection dir, std::int32_t& x
 	// don't need to move inwards because that side can't provoke a jump.
 	switch (dir) {
 	case kLeft:
-		if (!m_config->getNeighbor(dstName, kRight, t, nullptr).empty() &&
+		if (topology_.neighbor(dstIndex, kRight, t).screen != ScreenTopology::kNoScreen &&
 			x > dx + dw - 1 - z)
 			x = dx + dw - 1 - z;
 		break;
 
 	case kRight:
-		if (!m_config->getNeighbor(dstName, kLeft, t, nullptr).empty() &&
+		if (topology_.neighbor(dstIndex, kLeft, t).screen != ScreenTopology::kNoScreen &&
 			x < dx + z)
 			x = dx + z;
 		break;
 
 	case kTop:
-		if (!m_config->getNeighbor(dstName, kBottom, t, nullptr).empty() &&
+		if (topology_.neighbor(dstIndex, kBottom, t).screen != ScreenTopology::kNoScreen &&
 			y > dy + dh - 1 - z)
 			y = dy + dh - 1 - z;
 		break;
 
 	case kBottom:
-		if (!m_config->getNeighbor(dstName, kTop, t, nullptr).empty() &&
+		if (topology_.neighbor(dstIndex, kTop, t).screen != ScreenTopology::kNoScreen &&
 			y < dy + z)
 			y = dy + z;
 		break;
@@ -802,7 +865,7 @@ bool Server::isSwitchOkay(BaseClientProxy* newScreen, EDirection dir, std::int32
 	// are we in a locked corner?  first check if screen has the option set
 	// and, if not, check the global options.
 	const Config::ScreenOptions* options =
-						m_config->getOptions(getName(m_active));
+						m_config->getOptions(canonical_name(get_id(m_active)));
 	if (options == nullptr || options->count(kOptionScreenSwitchCorners) == 0) {
 		options = m_config->getOptions("");
 	}
@@ -967,6 +1030,99 @@ Server::isSwitchWaitStarted() const
 	return (m_switchWaitTimer != nullptr);
 }
 
+void
+Server::startClipboardSettle(ClipboardID id, double delay)
+{
+	if (delay <= 0.0) {
+		settleClipboard(id);
+		return;
+	}
+
+	// a running timer checks the deadline again when it fires
+	ClipboardInfo& clipboard = m_clipboards[id];
+	if (clipboard.debounce_timer_ == nullptr) {
+		clipboard.debounce_timer_ = m_events->newOneShotTimer(delay, nullptr);
+		m_events->add_handler(EventType::TIMER, clipboard.debounce_timer_,
+							  [this, id](const auto& e){ handle_clipboard_settled(id); });
+	}
+}
+
+void
+Server::stopClipboardSettle(ClipboardID id)
+{
+	ClipboardInfo& clipboard = m_clipboards[id];
+	if (clipboard.debounce_timer_ != nullptr) {
+		m_events->remove_handler(EventType::TIMER, clipboard.debounce_timer_);
+		m_events->deleteTimer(clipboard.debounce_timer_);
+		clipboard.debounce_timer_ = nullptr;
+	}
+}
+
+void
+Server::settleClipboard(ClipboardID id)
+{
+	stopClipboardSettle(id);
+
+	ClipboardInfo& clipboard = m_clipboards[id];
+	if (!clipboard.debouncer_.is_pending()) {
+		return;
+	}
+	clipboard.debouncer_.updated(clipboard_clock_.getTime());
+
+	BaseClientProxy* grabber = clipboard.pending_grabber_;
+	BaseClientProxy* changer = clipboard.pending_changer_;
+	clipboard.pending_grabber_ = nullptr;
+	clipboard.pending_changer_ = nullptr;
+
+	// the grab was checked when it arrived but the clipboard may have
+	// changed hands since
+	if (grabber != nullptr && isClipboardGrabValid(grabber, id, clipboard.pending_grab_seq_)) {
+		onClipboardGrabbed(grabber, id, clipboard.pending_grab_seq_);
+	}
+	if (changer != nullptr) {
+		if (clipboard.m_clipboardOwner == get_id(changer)) {
+			onClipboardChanged(changer, id, clipboard.pending_change_seq_);
+		}
+		else {
+			LOG_DEBUG("ignored screen \"%s\" update of clipboard %d (not the owner)",
+					  getName(changer).c_str(), id);
+		}
+	}
+}
+
+void
+Server::settleClipboards()
+{
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		settleClipboard(id);
+	}
+}
+
+bool
+Server::isClipboardGrabValid(BaseClientProxy* grabber, ClipboardID id,
+							 std::uint32_t seqNum) const
+{
+	if (!m_enableClipboard || (m_maximumClipboardSize == 0)) {
+		return false;
+	}
+
+	// ignore events from unknown clients
+	if (m_clientSet.count(grabber) == 0) {
+		return false;
+	}
+
+	// ignore grab if sequence number is older than the current grab or
+	// the one waiting to settle.  always allow primary screen to grab.
+	const ClipboardInfo& clipboard = m_clipboards[id];
+	if (grabber != m_primaryClient &&
+		(seqNum < clipboard.m_clipboardSeqNum ||
+		 (clipboard.pending_grabber_ != nullptr && seqNum < clipboard.pending_grab_seq_))) {
+		LOG_INFO("ignored screen \"%s\" grab of clipboard %d", getName(grabber).c_str(), id);
+		return false;
+	}
+	return true;
+}
+
 std::uint32_t Server::getCorner(BaseClientProxy* client, std::int32_t x, std::int32_t y,
                                 std::int32_t size) const
 {
@@ -1132,6 +1288,12 @@ Server::processOptions()
 				m_maximumClipboardSize = static_cast<size_t>(value);
 			}
 		}
+		else if (id == kOptionClipboardSelectionRate) {
+			// a rate of 0 propagates every change of the selection
+			settleClipboard(kClipboardSelection);
+			m_clipboards[kClipboardSelection].debouncer_.configure(
+						value > 0 ? kSelectionQuietPeriod : 0.0, value);
+		}
 	}
 	if (m_relativeMoves && !newRelativeMoves) {
 		stopRelativeMoves();
@@ -1172,49 +1334,22 @@ void Server::handle_shape_changed(BaseClientProxy* client)
 
 void Server::handle_clipboard_grabbed(const Event& event, BaseClientProxy* grabber)
 {
-	if (!m_enableClipboard || (m_maximumClipboardSize == 0)) {
-		return;
-	}
-
-	// ignore events from unknown clients
-	if (m_clientSet.count(grabber) == 0) {
-		return;
-	}
     const auto& info = event.get_data_as<IScreen::ClipboardInfo>();
-
-	// ignore grab if sequence number is old.  always allow primary
-	// screen to grab.
-    ClipboardInfo& clipboard = m_clipboards[info.m_id];
-    if (grabber != m_primaryClient && info.m_sequenceNumber < clipboard.m_clipboardSeqNum) {
-        LOG_INFO("ignored screen \"%s\" grab of clipboard %d", getName(grabber).c_str(),
-             info.m_id);
+	if (!isClipboardGrabValid(grabber, info.m_id, info.m_sequenceNumber)) {
 		return;
 	}
 
-	// mark screen as owning clipboard
-    LOG_INFO("screen \"%s\" grabbed clipboard %d from \"%s\"", getName(grabber).c_str(),
-         info.m_id, clipboard.m_clipboardOwner.c_str());
-	clipboard.m_clipboardOwner  = getName(grabber);
-    clipboard.m_clipboardSeqNum = info.m_sequenceNumber;
-
-	// clear the clipboard data (since it's not known at this point)
-	if (clipboard.m_clipboard.open(0)) {
-		clipboard.m_clipboard.clear();
-		clipboard.m_clipboard.close();
+	ClipboardInfo& clipboard = m_clipboards[info.m_id];
+	if (clipboard.debouncer_.is_immediate()) {
+		onClipboardGrabbed(grabber, info.m_id, info.m_sequenceNumber);
+		return;
 	}
-	clipboard.m_clipboardData = clipboard.m_clipboard.marshall();
 
-	// tell all other screens to take ownership of clipboard.  tell the
-	// grabber that it's clipboard isn't dirty.
-    for (auto index = m_clients.begin(); index != m_clients.end(); ++index) {
-		BaseClientProxy* client = index->second;
-		if (client == grabber) {
-            client->setClipboardDirty(info.m_id, false);
-		}
-		else {
-            client->grabClipboard(info.m_id);
-		}
-	}
+	// the new grab replaces the one waiting to settle along with its data
+	clipboard.pending_grabber_  = grabber;
+	clipboard.pending_grab_seq_ = info.m_sequenceNumber;
+	clipboard.pending_changer_  = nullptr;
+	startClipboardSettle(info.m_id, clipboard.debouncer_.changed(clipboard_clock_.getTime()));
 }
 
 void Server::handle_clipboard_changed(const Event& event, BaseClientProxy* client)
@@ -1224,7 +1359,25 @@ void Server::handle_clipboard_changed(const Event& event, BaseClientProxy* clien
 		return;
 	}
     const auto& info = event.get_data_as<IScreen::ClipboardInfo>();
-    onClipboardChanged(client, info.m_id, info.m_sequenceNumber);
+
+	ClipboardInfo& clipboard = m_clipboards[info.m_id];
+	if (clipboard.debouncer_.is_immediate()) {
+		onClipboardChanged(client, info.m_id, info.m_sequenceNumber);
+		return;
+	}
+
+	// only the data the clipboard settles with is fetched
+	clipboard.pending_changer_    = client;
+	clipboard.pending_change_seq_ = info.m_sequenceNumber;
+	startClipboardSettle(info.m_id, clipboard.debouncer_.changed(clipboard_clock_.getTime()));
+}
+
+void Server::handle_clipboard_settled(ClipboardID id)
+{
+	// changes since the timer was started may have moved the deadline
+	double remaining = m_clipboards[id].debouncer_.remaining(clipboard_clock_.getTime());
+	stopClipboardSettle(id);
+	startClipboardSettle(id, remaining);
 }
 
 void Server::handle_key_down_event(const Event& event)
@@ -1321,12 +1474,15 @@ void Server::handle_switch_to_screen_event(const Event& event)
 {
     const auto& info = event.get_data_as<SwitchToScreenInfo>();
 
-    auto index = m_clients.find(info.m_screen);
-	if (index == m_clients.end()) {
+	// the name may be an alias
+	ScreenTopology::Index index = topology_.find(info.m_id);
+	BaseClientProxy* client = (index == ScreenTopology::kNoScreen) ? nullptr :
+															topology_clients_[index];
+	if (client == nullptr) {
         LOG_DEBUG1("screen \"%s\" not active", info.m_screen.c_str());
 	}
 	else {
-        jumpToScreen(index->second);
+        jumpToScreen(client);
 	}
 }
 
@@ -1335,18 +1491,19 @@ Server::handle_toggle_screen_event(const Event& event)
 {
     (void) event;
 
-  std::string current = getName(m_active);
-  auto index = m_clients.find(current);
-  if (index == m_clients.end()) {
-    LOG_DEBUG1("screen \"%s\" not active", current.c_str());
-  }
-  else {
-    ++index;
-    if (index == m_clients.end()) {
-      index = m_clients.begin();
-    }
-    jumpToScreen(index->second);
-  }
+	// go to the next connected screen in name order
+	ScreenTopology::Index current = topology_index(m_active);
+	if (current == ScreenTopology::kNoScreen) {
+		LOG_DEBUG1("screen \"%s\" not active", getName(m_active).c_str());
+		return;
+	}
+	for (std::size_t i = 1; i <= topology_.size(); ++i) {
+		BaseClientProxy* client = topology_clients_[(current + i) % topology_.size()];
+		if (client != nullptr) {
+			jumpToScreen(client);
+			return;
+		}
+	}
 }
 
 
@@ -1438,11 +1595,6 @@ void Server::handle_fake_input_end_event()
 	m_primaryClient->fakeInputEnd();
 }
 
-void Server::handle_file_chunk_sending_event(const Event& event)
-{
-    on_file_chunk_sending(event.get_data_as<FileChunk>());
-}
-
 void Server::handle_file_receive_completed_event(const Event& event)
 {
     (void) event;
@@ -1450,6 +1602,35 @@ void Server::handle_file_receive_completed_event(const Event& event)
 	onFileReceiveCompleted();
 }
 
+void Server::onClipboardGrabbed(BaseClientProxy* grabber, ClipboardID id, std::uint32_t seqNum)
+{
+	// mark screen as owning clipboard
+	ClipboardInfo& clipboard = m_clipboards[id];
+    LOG_INFO("screen \"%s\" grabbed clipboard %d from \"%s\"", getName(grabber).c_str(),
+         id, canonical_name(clipboard.m_clipboardOwner).c_str());
+	clipboard.m_clipboardOwner  = get_id(grabber);
+    clipboard.m_clipboardSeqNum = seqNum;
+
+	// clear the clipboard data (since it's not known at this point)
+	if (clipboard.m_clipboard.open(0)) {
+		clipboard.m_clipboard.clear();
+		clipboard.m_clipboard.close();
+	}
+	clipboard.digest_ = clipboard.m_clipboard.digest();
+
+	// tell all other screens to take ownership of clipboard.  tell the
+	// grabber that it's clipboard isn't dirty.
+    for (auto index = m_clients.begin(); index != m_clients.end(); ++index) {
+		BaseClientProxy* client = index->second;
+		if (client == grabber) {
+            client->setClipboardDirty(id, false);
+		}
+		else {
+            client->grabClipboard(id);
+		}
+	}
+}
+
 void Server::onClipboardChanged(BaseClientProxy* sender, ClipboardID id, std::uint32_t seqNum)
 {
 	ClipboardInfo& clipboard = m_clipboards[id];
@@ -1466,25 +1647,25 @@ void Server::onClipboardChanged(BaseClientProxy* sender, ClipboardID id, std::ui
 	// get data
 	if (!sender->getClipboard(id, &clipboard.m_clipboard)) {
 		LOG_DEBUG("ignored screen \"%s\" update of clipboard %d (failed to get clipboard)",
-				clipboard.m_clipboardOwner.c_str(), id);
+				canonical_name(clipboard.m_clipboardOwner).c_str(), id);
 		return;
 	}
 
 	// ignore if data hasn't changed
-    std::string data = clipboard.m_clipboard.marshall();
-	if (data.size() > m_maximumClipboardSize) {
+	if (clipboard.m_clipboard.marshalled_size() > m_maximumClipboardSize) {
 		LOG_NOTE("not updating clipboard because it's over the size limit (%zi KB) configured by the server",
 			m_maximumClipboardSize);
 		return;
 	}
-	if (data == clipboard.m_clipboardData) {
-		LOG_DEBUG("ignored screen \"%s\" update of clipboard %d (unchanged)", clipboard.m_clipboardOwner.c_str(), id);
+	ContentHash digest = clipboard.m_clipboard.digest();
+	if (digest == clipboard.digest_) {
+		LOG_DEBUG("ignored screen \"%s\" update of clipboard %d (unchanged)", canonical_name(clipboard.m_clipboardOwner).c_str(), id);
 		return;
 	}
 
 	// got new data
-	LOG_INFO("screen \"%s\" updated clipboard %d", clipboard.m_clipboardOwner.c_str(), id);
-	clipboard.m_clipboardData = data;
+	LOG_INFO("screen \"%s\" updated clipboard %d", canonical_name(clipboard.m_clipboardOwner).c_str(), id);
+	clipboard.digest_ = digest;
 
 	// tell all clients except the sender that the clipboard is dirty
     for (auto index = m_clients.begin(); index != m_clients.end(); ++index) {
@@ -1569,7 +1750,7 @@ Server::onKeyDown(KeyID id, KeyModifierMask mask, KeyButton button,
 			}
 		}
         for (auto index = m_clients.begin(); index != m_clients.end(); ++index) {
-			if (IKeyState::KeyInfo::contains(screens, index->first)) {
+			if (IKeyState::KeyInfo::contains(screens, canonical_name(index->first))) {
 				index->second->keyDown(id, mask, button);
 			}
 		}
@@ -1595,7 +1776,7 @@ Server::onKeyUp(KeyID id, KeyModifierMask mask, KeyButton button,
 			}
 		}
         for (auto index = m_clients.begin(); index != m_clients.end(); ++index) {
-			if (IKeyState::KeyInfo::contains(screens, index->first)) {
+			if (IKeyState::KeyInfo::contains(screens, canonical_name(index->first))) {
 				index->second->keyUp(id, mask, button);
 			}
 		}
@@ -1931,10 +2112,7 @@ void Server::onMouseMoveSecondary(std::int32_t dx, std::int32_t dy)
 	} while (false);
 
 	if (jump) {
-		if (m_sendFileThread != nullptr) {
-			StreamChunker::interruptFile();
-			m_sendFileThread = nullptr;
-		}
+		m_active->cancel_file();
 
 		std::int32_t newX = m_x;
 		std::int32_t newY = m_y;
@@ -1980,23 +2158,27 @@ void Server::onMouseWheel(std::int32_t xDelta, std::int32_t yDelta)
 	m_active->mouseWheel(xDelta, yDelta);
 }
 
-void Server::on_file_chunk_sending(const FileChunk& chunk)
-{
-	LOG_DEBUG1("sending file chunk");
-	assert(m_active != nullptr);
-
-    m_active->file_chunk_sending(chunk);
-}
-
 void
 Server::onFileReceiveCompleted()
 {
-	if (isReceivedFileSizeValid()) {
-        m_writeToDropDirThread = new Thread([this]() { write_to_drop_dir_thread(); });
+	if (!isReceivedFileSizeValid()) {
+		return;
+	}
+
+	// the files arrive one after another in the order of the drag list
+	received_files_.push_back(file_receiver_.take_file());
+	if (received_files_.size() < m_fakeDragFileList.size()) {
+		return;
 	}
+
+	std::vector<fs::path> received;
+	received.swap(received_files_);
+	m_writeToDropDirThread = new Thread([this, received]() {
+		write_to_drop_dir_thread(received);
+	});
 }
 
-void Server::write_to_drop_dir_thread()
+void Server::write_to_drop_dir_thread(const std::vector<fs::path>& received)
 {
 	LOG_DEBUG("starting write to drop dir thread");
 
@@ -2004,15 +2186,18 @@ void Server::write_to_drop_dir_thread()
 		inputleap::this_thread_sleep(.1f);
 	}
 
-	DropHelper::writeToDir(m_screen->getDropTarget(), m_fakeDragFileList,
-					m_receivedFileData);
+	DropHelper::writeToDir(m_screen->getDropTarget(), m_fakeDragFileList, received);
 }
 
 bool
 Server::addClient(BaseClientProxy* client)
 {
-    std::string name = getName(client);
-	if (m_clients.count(name) != 0) {
+	// the name is our own or passed the configuration check, so interning
+	// it can't grow the registry on a peer's say-so.  the primary client
+	// is added before the configuration's names are interned.
+	ScreenId::intern(client->getName());
+    ScreenId id = get_id(client);
+	if (m_clients.count(id) != 0) {
 		return false;
 	}
 
@@ -2026,7 +2211,8 @@ Server::addClient(BaseClientProxy* client)
 
 	// add to list
 	m_clientSet.insert(client);
-	m_clients.insert(std::make_pair(name, client));
+	m_clients.insert(std::make_pair(id, client));
+	update_topology_clients();
 
 	// initialize client data
 	std::int32_t x, y;
@@ -2054,8 +2240,25 @@ Server::removeClient(BaseClientProxy* client)
     m_events->remove_handler(EventType::CLIPBOARD_CHANGED, client->get_event_target());
 
 	// remove from list
-	m_clients.erase(getName(client));
+	for (auto index = m_clients.begin(); index != m_clients.end(); ++index) {
+		if (index->second == client) {
+			m_clients.erase(index);
+			break;
+		}
+	}
 	m_clientSet.erase(i);
+	update_topology_clients();
+
+	// drop its clipboard updates that wait to settle
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		ClipboardInfo& clipboard = m_clipboards[id];
+		if (clipboard.pending_grabber_ == client) {
+			clipboard.pending_grabber_ = nullptr;
+		}
+		if (clipboard.pending_changer_ == client) {
+			clipboard.pending_changer_ = nullptr;
+		}
+	}
 
 	return true;
 }
@@ -2106,7 +2309,7 @@ Server::closeClients(const Config& config)
 	typedef std::set<BaseClientProxy*> RemovedClients;
 	RemovedClients removed;
     for (auto index = m_clients.begin(); index != m_clients.end(); ++index) {
-		if (!config.isCanonicalName(index->first)) {
+		if (!config.isCanonicalName(index->first.name())) {
 			removed.insert(index->second);
 		}
 	}
@@ -2176,7 +2379,7 @@ Server::forceLeaveClient(BaseClientProxy* client)
 								m_primaryClient->getToggleMask(), false);
 		}
 
-        Server::SwitchToScreenInfo info{m_active->getName()};
+        Server::SwitchToScreenInfo info{m_active->getName(), m_active->get_id()};
         m_events->add_event(EventType::SERVER_SCREEN_SWITCHED, this,
                             create_event_data<Server::SwitchToScreenInfo>(info));
 	}
@@ -2199,7 +2402,6 @@ Server::forceLeaveClient(BaseClientProxy* client)
 
 Server::ClipboardInfo::ClipboardInfo() :
 	m_clipboard(),
-	m_clipboardData(),
 	m_clipboardOwner(),
 	m_clipboardSeqNum(0)
 {
@@ -2209,30 +2411,16 @@ Server::ClipboardInfo::ClipboardInfo() :
 bool
 Server::isReceivedFileSizeValid()
 {
-	return m_expectedFileSize == m_receivedFileData.size();
+	return file_receiver_.is_complete();
 }
 
 void
 Server::sendFileToClient(const char* filename)
 {
-	if (m_sendFileThread != nullptr) {
-		StreamChunker::interruptFile();
-	}
-
-    m_sendFileThread = new Thread([this, filename]() { send_file_thread(filename); });
-}
-
-void Server::send_file_thread(const char* filename)
-{
-	try {
-		LOG_DEBUG("sending file to client, filename=%s", filename);
-		StreamChunker::sendFile(filename, m_events, this);
-	}
-	catch (std::runtime_error &error) {
-		LOG_ERR("failed sending file chunks, error: %s", error.what());
-	}
+	assert(m_active != nullptr);
 
-	m_sendFileThread = nullptr;
+	LOG_DEBUG("sending file to client, filename=%s", filename);
+	m_active->send_files({filename});
 }
 
 void Server::dragInfoReceived(std::uint32_t fileNum, std::string content)
@@ -2243,6 +2431,8 @@ void Server::dragInfoReceived(std::uint32_t fileNum, std::string content)
 	}
 
 	DragInformation::parseDragInfo(m_fakeDragFileList, fileNum, content);
+	received_files_.clear();
+	file_receiver_.set_directory(DropHelper::receive_directory(m_screen));
 
 	m_screen->startDraggingFiles(m_fakeDragFileList);
 }
@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include "server/ClipboardDebouncer.h"
 #include "server/Config.h"
+#include "server/ScreenTopology.h"
 #include "inputleap/clipboard_types.h"
 #include "inputleap/Clipboard.h"
 #include "inputleap/key_types.h"
@@ -26,6 +28,7 @@
 #include "inputleap/Fwd.h"
 #include "inputleap/INode.h"
 #include "inputleap/DragInformation.h"
+#include "inputleap/FileReceiver.h"
 #include "inputleap/ServerArgs.h"
 #include "base/Fwd.h"
 #include "base/Event.h"
@@ -63,11 +66,16 @@ public:
     class SwitchToScreenInfo {
     public:
         SwitchToScreenInfo(const std::string& screen) :
-            m_screen{screen}
+            SwitchToScreenInfo(screen, ScreenId::find(screen))
+        {}
+        SwitchToScreenInfo(const std::string& screen, ScreenId id) :
+            m_screen{screen},
+            m_id{id}
         {}
 
     public:
         std::string m_screen;
+        ScreenId m_id;
     };
 
     //! Switch in direction data
@@ -82,10 +90,11 @@ public:
     //! Screen connected data
     class ScreenConnectedInfo {
     public:
-        ScreenConnectedInfo(std::string screen) : m_screen(screen) { }
+        ScreenConnectedInfo(std::string screen, ScreenId id) : m_screen(screen), m_id(id) { }
 
     public:
         std::string m_screen;
+        ScreenId m_id;
     };
 
     //! Keyboard broadcast data
@@ -176,11 +185,8 @@ public:
     //! Return true if received file size is valid
     bool isReceivedFileSizeValid();
 
-    //! Return expected file data size
-    size_t& getExpectedFileSize() { return m_expectedFileSize; }
-
-    //! Return received file data
-    std::string& getReceivedFileData() { return m_receivedFileData; }
+    //! Return the receiver of dragged files
+    FileReceiver& get_file_receiver() { return file_receiver_; }
 
     //! Return fake drag file list
     DragFileList getFakeDragFileList() { return m_fakeDragFileList; }
@@ -191,6 +197,12 @@ private:
     // get canonical name of client
     std::string getName(const BaseClientProxy*) const;
 
+    // get the id of the canonical name of client
+    ScreenId get_id(const BaseClientProxy*) const;
+
+    // get the canonical spelling of a screen name
+    const std::string& canonical_name(ScreenId) const;
+
     // get the sides of the primary screen that have neighbors
     std::uint32_t getActivePrimarySides() const;
 
@@ -224,6 +236,12 @@ private:
     // indicated by the direction.
     bool hasAnyNeighbor(BaseClientProxy*, EDirection) const;
 
+    // returns the index of the client's screen in topology_
+    ScreenTopology::Index topology_index(const BaseClientProxy*) const;
+
+    // refill topology_clients_ from m_clients
+    void update_topology_clients();
+
     // lookup neighboring screen, mapping the coordinate independent of
     // the direction to the neighbor's coordinate space.
     BaseClientProxy* getNeighbor(BaseClientProxy*, EDirection, std::int32_t& x,
@@ -278,6 +296,23 @@ private:
     // returns true iff the delay switch timer is started
     bool isSwitchWaitStarted() const;
 
+    // wait \p delay seconds before propagating the pending clipboard update
+    void startClipboardSettle(ClipboardID id, double delay);
+
+    // stop waiting for clipboard \p id to settle
+    void stopClipboardSettle(ClipboardID id);
+
+    // propagate the pending update of clipboard \p id now
+    void settleClipboard(ClipboardID id);
+
+    // propagate the pending updates of all clipboards now
+    void settleClipboards();
+
+    // returns true iff \p grabber may take clipboard \p id with the
+    // given sequence number
+    bool isClipboardGrabValid(BaseClientProxy* grabber, ClipboardID id,
+                              std::uint32_t seqNum) const;
+
     // returns the corner (EScreenSwitchCornerMasks) where x,y is on the
     // given client.  corners have the given size.
     std::uint32_t getCorner(BaseClientProxy*, std::int32_t x, std::int32_t y,
@@ -296,6 +331,7 @@ private:
     void handle_shape_changed(BaseClientProxy* client);
     void handle_clipboard_grabbed(const Event& event, BaseClientProxy* client);
     void handle_clipboard_changed(const Event& event, BaseClientProxy* client);
+    void handle_clipboard_settled(ClipboardID id);
     void handle_key_down_event(const Event& event);
     void handle_key_up_event(const Event& event);
     void handle_key_repeat_event(const Event& event);
@@ -316,10 +352,10 @@ private:
     void handle_lock_cursor_to_screen_event(const Event& event);
     void handle_fake_input_begin_event();
     void handle_fake_input_end_event();
-    void handle_file_chunk_sending_event(const Event& event);
     void handle_file_receive_completed_event(const Event& event);
 
     // event processing
+    void onClipboardGrabbed(BaseClientProxy* grabber, ClipboardID id, std::uint32_t seqNum);
     void onClipboardChanged(BaseClientProxy* sender, ClipboardID id, std::uint32_t seqNum);
     void onScreensaver(bool activated);
     void onKeyDown(KeyID, KeyModifierMask, KeyButton,
@@ -332,7 +368,6 @@ private:
     bool onMouseMovePrimary(std::int32_t x, std::int32_t y);
     void onMouseMoveSecondary(std::int32_t dx, std::int32_t dy);
     void onMouseWheel(std::int32_t xDelta, std::int32_t yDelta);
-    void on_file_chunk_sending(const FileChunk& chunk);
     void onFileReceiveCompleted();
 
     // add client to list and attach event handlers for client
@@ -358,11 +393,8 @@ private:
     // force the cursor off of \p client
     void forceLeaveClient(BaseClientProxy* client);
 
-    // thread function for sending file
-    void send_file_thread(const char* filename);
-
     // thread function for writing file to drop directory
-    void write_to_drop_dir_thread();
+    void write_to_drop_dir_thread(const std::vector<fs::path>& received);
 
     // thread function for sending drag information
     void send_drag_info_thread(BaseClientProxy* newScreen);
@@ -380,20 +412,34 @@ private:
 
     public:
         Clipboard m_clipboard;
-        std::string m_clipboardData;
-        std::string m_clipboardOwner;
+        ContentHash digest_;        // m_clipboard.digest() when last sent
+        ScreenId m_clipboardOwner;
         std::uint32_t m_clipboardSeqNum;
+
+        // grab and change waiting for the clipboard to settle
+        ClipboardDebouncer debouncer_;
+        EventQueueTimer* debounce_timer_ = nullptr;
+        BaseClientProxy* pending_grabber_ = nullptr;
+        std::uint32_t pending_grab_seq_ = 0;
+        BaseClientProxy* pending_changer_ = nullptr;
+        std::uint32_t pending_change_seq_ = 0;
     };
 
     // the primary screen client
     PrimaryClient* m_primaryClient;
 
-    // all clients (including the primary client) indexed by name
-    typedef std::map<std::string, BaseClientProxy*> ClientList;
+    // all clients (including the primary client) indexed by the id of
+    // their canonical name when they were added
+    typedef std::map<ScreenId, BaseClientProxy*> ClientList;
     typedef std::set<BaseClientProxy*> ClientSet;
     ClientList m_clients;
     ClientSet m_clientSet;
 
+    // the screen layout compiled by setConfig() and the connected client
+    // for each of its screens, if any
+    ScreenTopology topology_;
+    std::vector<BaseClientProxy*> topology_clients_;
+
     // all old connections that we're waiting to hangup
     typedef std::map<BaseClientProxy*, EventQueueTimer*> OldClients;
     OldClients m_oldClients;
@@ -423,6 +469,7 @@ private:
 
     // clipboard cache
     ClipboardInfo m_clipboards[kClipboardEnd];
+    Stopwatch clipboard_clock_;
 
     // state saved when screen saver activates
     BaseClientProxy* m_activeSaver;
@@ -467,11 +514,10 @@ private:
     IEventQueue* m_events;
 
     // file transfer
-    size_t m_expectedFileSize;
-    std::string m_receivedFileData;
+    FileReceiver file_receiver_;
+    std::vector<fs::path> received_files_;
     DragFileList m_dragFileList;
     DragFileList m_fakeDragFileList;
-    Thread* m_sendFileThread;
     Thread* m_writeToDropDirThread;
     std::string m_dragFileExt;
     bool m_ignoreFileTransfer;
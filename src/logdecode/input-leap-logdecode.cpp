@@ -0,0 +1,63 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "arch/Arch.h"
+#include "base/BinaryLog.h"
+#include "base/Log.h"
+#include "io/filesystem.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace inputleap {
+
+int logdecode_main(int argc, char** argv)
+{
+    if (argc != 2 || std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h") {
+        std::cerr << "Usage: " << argv[0] << " <binary-log-file>\n"
+                  << "Writes the messages recorded with --binary-log to standard output.\n";
+        return argc == 2 ? 0 : 1;
+    }
+
+    Arch arch;
+    arch.init();
+
+    // only used for the priority names
+    Log log;
+
+    std::ifstream in;
+    open_utf8_path(in, argv[1], std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << argv[0] << ": cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::string error;
+    if (!decode_binary_log(in, std::cout, error)) {
+        std::cerr << argv[0] << ": " << argv[1] << ": " << error << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace inputleap
+
+int main(int argc, char** argv)
+{
+    return inputleap::logdecode_main(argc, argv);
+}
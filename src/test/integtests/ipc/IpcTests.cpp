@@ -50,6 +50,9 @@ public:
     void sendMessageToServer_serverHandleMessageReceived(const Event& e);
     void sendMessageToClient_server_handle_client_connected(const Event& e);
     void sendMessageToClient_client_handle_message_received(const Event& e);
+    void sendLogFilterToServer_server_handle_message_received(const Event& e);
+    void sendLogFilterToClient_server_handle_client_connected(const Event& e);
+    void sendLogFilterToClient_client_handle_message_received(const Event& e);
 
 public:
     SocketMultiplexer m_multiplexer;
@@ -60,6 +63,9 @@ public:
     std::string m_sendMessageToClient_receivedString;
     IpcClient* m_sendMessageToServer_client;
     IpcServer* m_sendMessageToClient_server;
+    std::string m_sendLogFilter_receivedFilters;
+    IpcClient* m_sendLogFilterToServer_client;
+    IpcServer* m_sendLogFilterToClient_server;
     TestEventQueue m_events;
 
 };
@@ -146,12 +152,71 @@ TEST_F(IpcTests, sendMessageToClient)
     EXPECT_EQ("test", m_sendMessageToClient_receivedString);
 }
 
+TEST_F(IpcTests, sendLogFilterToServer)
+{
+    SocketMultiplexer socketMultiplexer;
+    IpcServer server(&m_events, &socketMultiplexer, TEST_IPC_PORT);
+    server.listen();
+
+    // like the gui, the client sends filters for the daemon to apply
+    m_events.add_handler(EventType::IPC_SERVER_MESSAGE_RECEIVED, &server,
+                         [this](const auto& e)
+    {
+        sendLogFilterToServer_server_handle_message_received(e);
+    });
+
+    IpcClient client(&m_events, &socketMultiplexer, TEST_IPC_PORT);
+    client.connect();
+    m_sendLogFilterToServer_client = &client;
+
+    m_events.initQuitTimeout(5);
+    m_events.loop();
+    m_events.remove_handler(EventType::IPC_SERVER_MESSAGE_RECEIVED, &server);
+    m_events.cleanupQuitTimeout();
+
+    EXPECT_EQ("net=DEBUG2", m_sendLogFilter_receivedFilters);
+}
+
+TEST_F(IpcTests, sendLogFilterToClient)
+{
+    SocketMultiplexer socketMultiplexer;
+    IpcServer server(&m_events, &socketMultiplexer, TEST_IPC_PORT);
+    server.listen();
+    m_sendLogFilterToClient_server = &server;
+
+    // the daemon passes the filters on to the node
+    m_events.add_handler(EventType::IPC_SERVER_MESSAGE_RECEIVED, &server,
+                         [this](const auto& e)
+    {
+        sendLogFilterToClient_server_handle_client_connected(e);
+    });
+
+    IpcClient client(&m_events, &socketMultiplexer, TEST_IPC_PORT);
+    client.connect();
+
+    m_events.add_handler(EventType::IPC_CLIENT_MESSAGE_RECEIVED, &client,
+                         [this](const auto& e)
+    {
+        sendLogFilterToClient_client_handle_message_received(e);
+    });
+
+    m_events.initQuitTimeout(5);
+    m_events.loop();
+    m_events.remove_handler(EventType::IPC_SERVER_MESSAGE_RECEIVED, &server);
+    m_events.remove_handler(EventType::IPC_CLIENT_MESSAGE_RECEIVED, &client);
+    m_events.cleanupQuitTimeout();
+
+    EXPECT_EQ("net=DEBUG2", m_sendLogFilter_receivedFilters);
+}
+
 IpcTests::IpcTests() :
 m_connectToServer_helloMessageReceived(false),
 m_connectToServer_hasClientNode(false),
 m_connectToServer_server(nullptr),
 m_sendMessageToServer_client(nullptr),
-m_sendMessageToClient_server(nullptr)
+m_sendMessageToClient_server(nullptr),
+m_sendLogFilterToServer_client(nullptr),
+m_sendLogFilterToClient_server(nullptr)
 {
 }
 
@@ -207,6 +272,39 @@ void IpcTests::sendMessageToClient_client_handle_message_received(const Event& e
     }
 }
 
+void IpcTests::sendLogFilterToServer_server_handle_message_received(const Event& e)
+{
+    const auto& m = e.get_data_as<IpcMessage>();
+    if (m.type() == kIpcHello) {
+        IpcLogFilterMessage lfm("net=DEBUG2");
+        m_sendLogFilterToServer_client->send(lfm);
+    }
+    else if (m.type() == kIpcLogFilter) {
+        const auto& lfm = static_cast<const IpcLogFilterMessage&>(m);
+        m_sendLogFilter_receivedFilters = lfm.filters();
+        m_events.raiseQuitEvent();
+    }
+}
+
+void IpcTests::sendLogFilterToClient_server_handle_client_connected(const Event& e)
+{
+    const auto& m = e.get_data_as<IpcMessage>();
+    if (m.type() == kIpcHello) {
+        IpcLogFilterMessage lfm("net=DEBUG2");
+        m_sendLogFilterToClient_server->send(lfm, kIpcClientNode);
+    }
+}
+
+void IpcTests::sendLogFilterToClient_client_handle_message_received(const Event& e)
+{
+    const auto& m = e.get_data_as<IpcMessage>();
+    if (m.type() == kIpcLogFilter) {
+        const auto& lfm = static_cast<const IpcLogFilterMessage&>(m);
+        m_sendLogFilter_receivedFilters = lfm.filters();
+        m_events.raiseQuitEvent();
+    }
+}
+
 } // namespace inputleap
 
 #endif // WINAPI_CARBON
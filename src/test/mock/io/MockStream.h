@@ -32,11 +32,8 @@ public:
     MOCK_METHOD0(flush, void());
     MOCK_METHOD0(shutdownInput, void());
     MOCK_METHOD0(shutdownOutput, void());
-    MOCK_METHOD0(getInputReadyEvent, EventType());
-    MOCK_METHOD0(getOutputErrorEvent, EventType());
-    MOCK_METHOD0(getInputShutdownEvent, EventType());
-    MOCK_METHOD0(getOutputShutdownEvent, EventType());
-    MOCK_CONST_METHOD0(get_event_target, void*());
+    MOCK_CONST_METHOD0(get_event_target, const inputleap::EventTarget*());
     MOCK_CONST_METHOD0(isReady, bool());
     MOCK_CONST_METHOD0(getSize, std::uint32_t());
+    MOCK_CONST_METHOD0(getOutputSize, std::uint32_t());
 };
@@ -0,0 +1,49 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// gmock must come first, Xlib defines macros like None and Bool
+#include <gmock/gmock.h>
+
+#include "platform/XWindowsImpl.h"
+
+namespace inputleap {
+
+// mocks the calls the clipboard and the event queue buffer make while
+// they wait;  everything else still goes to Xlib
+class MockXWindowsImpl : public XWindowsImpl
+{
+public:
+    MOCK_METHOD3(XInternAtom, Atom(Display*, _Xconst char*, Bool));
+    MOCK_METHOD3(XDeleteProperty, int(Display*, Window, Atom));
+    MOCK_METHOD3(XGetWindowAttributes, Status(Display*, Window, XWindowAttributes*));
+    MOCK_METHOD3(XSelectInput, int(Display*, Window, long));
+    MOCK_METHOD6(XConvertSelection, int(Display*, Atom, Atom, Atom, Window, Time));
+    MOCK_METHOD2(XSync, int(Display*, Bool));
+    MOCK_METHOD1(XFlush, int(Display*));
+    MOCK_METHOD5(XSendEvent, Status(Display*, Window, Bool, long, XEvent*));
+    MOCK_METHOD1(XPending, int(Display*));
+    MOCK_METHOD2(XEventsQueued, int(Display*, int));
+    MOCK_METHOD2(XNextEvent, int(Display*, XEvent*));
+    MOCK_METHOD2(XPutBackEvent, int(Display*, XEvent*));
+    MOCK_METHOD1(XConnectionNumber, int(Display*));
+    MOCK_METHOD8(XChangeProperty, int(Display*, Window, Atom, Atom, int, int,
+                                      const unsigned char*, int));
+};
+
+} // namespace inputleap
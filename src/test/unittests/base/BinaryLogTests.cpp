@@ -0,0 +1,201 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/BinaryLog.h"
+#include "io/filesystem.h"
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#if SYSAPI_UNIX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace inputleap;
+
+namespace {
+
+void record(BinaryLogWriter& writer, ELevel priority, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    writer.record(priority, "file.cpp", 42, format, args);
+    va_end(args);
+}
+
+std::string decode(const fs::path& path, bool& ok)
+{
+    std::ifstream in;
+    open_utf8_path(in, path, std::ios::in | std::ios::binary);
+    std::ostringstream out;
+    std::string error;
+    ok = decode_binary_log(in, out, error);
+    return out.str();
+}
+
+fs::path temp_path(const char* name)
+{
+    return fs::temp_directory_path() / name;
+}
+
+} // namespace
+
+TEST(BinaryLogTests, decode_recordedMessages_matchesPrintf)
+{
+    auto path = temp_path("inputleap_binary_log_test.bin");
+    {
+        BinaryLogWriter writer(path.u8string());
+        ASSERT_TRUE(writer.is_open());
+
+        const char unterminated[] = { 'a', 'b', 'c', 'd' };
+        record(writer, kDEBUG2, "move to %d,%d", -5, 300);
+        record(writer, kDEBUG5, "%s=%08x %.*s %5.2f %c %llu %%",
+               "key", 0xbeefu, 3, unterminated, 3.14159, 'z', 1ull << 40);
+        record(writer, kPRINT, "plain %s", nullptr);
+    }
+
+    bool ok = false;
+    std::string text = decode(path, ok);
+    fs::remove(path);
+
+    EXPECT_TRUE(ok);
+    EXPECT_NE(std::string::npos, text.find("DEBUG2: move to -5,300\n\tfile.cpp,42\n"));
+    EXPECT_NE(std::string::npos,
+              text.find("DEBUG5: key=0000beef abc  3.14 z 1099511627776 %\n"));
+    EXPECT_NE(std::string::npos, text.find("\nplain (null)\n"));
+}
+
+TEST(BinaryLogTests, decode_severalThreads_orderedByTime)
+{
+    auto path = temp_path("inputleap_binary_log_threads.bin");
+    {
+        BinaryLogWriter writer(path.u8string());
+        record(writer, kDEBUG, "first");
+        std::thread other([&writer]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            record(writer, kDEBUG, "second");
+        });
+        other.join();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        record(writer, kDEBUG, "third");
+    }
+
+    bool ok = false;
+    std::string text = decode(path, ok);
+    fs::remove(path);
+
+    EXPECT_TRUE(ok);
+    auto first = text.find("first");
+    auto second = text.find("second");
+    auto third = text.find("third");
+    ASSERT_NE(std::string::npos, third);
+    EXPECT_LT(first, second);
+    EXPECT_LT(second, third);
+}
+
+TEST(BinaryLogTests, record_threadsExit_buffersReused)
+{
+    auto path = temp_path("inputleap_binary_log_reuse.bin");
+    {
+        BinaryLogWriter writer(path.u8string());
+        for (int i = 0; i < 5; ++i) {
+            std::thread([&writer, i]() { record(writer, kDEBUG, "thread %d", i); }).join();
+        }
+        EXPECT_EQ(1u, writer.buffer_count());
+    }
+
+    bool ok = false;
+    std::string text = decode(path, ok);
+    fs::remove(path);
+
+    EXPECT_TRUE(ok);
+    EXPECT_NE(std::string::npos, text.find("thread 0"));
+    EXPECT_NE(std::string::npos, text.find("thread 4"));
+}
+
+TEST(BinaryLogTests, record_noFlush_writtenSoonAfter)
+{
+    auto path = temp_path("inputleap_binary_log_timer.bin");
+    bool ok = false;
+    std::string text;
+    {
+        BinaryLogWriter writer(path.u8string());
+        record(writer, kDEBUG, "unflushed");
+
+        // written by the writer's timer while it is still open
+        for (int i = 0; i < 100 && text.find("unflushed") == std::string::npos; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            text = decode(path, ok);
+        }
+    }
+    fs::remove(path);
+
+    EXPECT_TRUE(ok);
+    EXPECT_NE(std::string::npos, text.find("unflushed"));
+}
+
+#if SYSAPI_UNIX
+TEST(BinaryLogTests, record_daemonizedAfterCreate_flushedByChild)
+{
+    // like --binary-log with --daemon:  the parent creates the writer and
+    // exits, the forked child does all the logging
+    auto path = temp_path("inputleap_binary_log_daemon.bin");
+    {
+        BinaryLogWriter writer(path.u8string());
+        pid_t pid = fork();
+        ASSERT_NE(-1, pid);
+        if (pid == 0) {
+            // written by the writer's timer, which must run in the child
+            record(writer, kDEBUG, "from daemon");
+            bool found = false;
+            for (int i = 0; i < 100 && !found; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                bool ok = false;
+                found = decode(path, ok).find("from daemon") != std::string::npos;
+            }
+            // shutting down joins the writer's thread
+            writer.~BinaryLogWriter();
+            _exit(found ? 0 : 1);
+        }
+
+        int status = 0;
+        ASSERT_EQ(pid, waitpid(pid, &status, 0));
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(0, WEXITSTATUS(status));
+    }
+
+    bool ok = false;
+    std::string text = decode(path, ok);
+    fs::remove(path);
+
+    EXPECT_TRUE(ok);
+    EXPECT_NE(std::string::npos, text.find("from daemon"));
+}
+#endif
+
+TEST(BinaryLogTests, decode_notBinaryLog_fails)
+{
+    std::istringstream in("[2024-01-01T00:00:00] INFO: text log\n");
+    std::ostringstream out;
+    std::string error;
+
+    EXPECT_FALSE(decode_binary_log(in, out, error));
+    EXPECT_FALSE(error.empty());
+}
@@ -0,0 +1,51 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/ContentHash.h"
+
+#include <gtest/gtest.h>
+
+using namespace inputleap;
+
+TEST(ContentHashTests, matches_murmur3_reference)
+{
+    ContentHash empty = content_hash("");
+    EXPECT_EQ(empty.low, 0u);
+    EXPECT_EQ(empty.high, 0u);
+
+    ContentHash fox = content_hash("The quick brown fox jumps over the lazy dog");
+    EXPECT_EQ(fox.low, 0xe34bbc7bbc071b6cULL);
+    EXPECT_EQ(fox.high, 0x7a433ca9c49a9347ULL);
+}
+
+TEST(ContentHashTests, every_tail_length_changes_hash)
+{
+    std::string data;
+    ContentHash previous = content_hash(data);
+    for (int i = 0; i < 40; ++i) {
+        data += static_cast<char>('a' + i % 26);
+        ContentHash hash = content_hash(data);
+        EXPECT_NE(hash, previous) << i;
+        previous = hash;
+    }
+}
+
+TEST(ContentHashTests, seed_changes_hash)
+{
+    EXPECT_NE(content_hash("clipboard", 0), content_hash("clipboard", 1));
+    EXPECT_EQ(content_hash("clipboard", 7), content_hash("clipboard", 7));
+}
@@ -0,0 +1,50 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/EventProfiler.h"
+
+#include <gtest/gtest.h>
+
+using namespace inputleap;
+
+TEST(EventProfilerTests, recordDispatch_countsPerType)
+{
+    EventProfiler profiler;
+    auto now = EventProfiler::Clock::now();
+
+    profiler.record_dispatch(EventType::KEY_STATE_KEY_DOWN, now, now, now);
+    profiler.record_dispatch(EventType::KEY_STATE_KEY_DOWN, now, now, now);
+    profiler.record_dispatch(EventType::SYSTEM, EventProfiler::Clock::time_point(), now, now);
+
+    EXPECT_EQ(2u, profiler.dispatched(EventType::KEY_STATE_KEY_DOWN));
+    EXPECT_EQ(1u, profiler.dispatched(EventType::SYSTEM));
+    EXPECT_EQ(0u, profiler.dispatched(EventType::KEY_STATE_KEY_UP));
+}
+
+TEST(EventProfilerTests, recordPost_keepsPeakDepth)
+{
+    EventProfiler profiler;
+
+    profiler.record_post(EventType::FILE_CHUNK_SENDING, 3);
+    profiler.record_post(EventType::FILE_CHUNK_SENDING, 12);
+    profiler.record_post(EventType::FILE_CHUNK_SENDING, 5);
+
+    EXPECT_EQ(12u, profiler.peak_depth(EventType::FILE_CHUNK_SENDING));
+
+    profiler.reset();
+    EXPECT_EQ(0u, profiler.peak_depth(EventType::FILE_CHUNK_SENDING));
+}
@@ -0,0 +1,100 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "test/global/TestEventQueue.h"
+#include "base/EventTarget.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace inputleap;
+
+TEST(EventQueueTests, loop_fileChunkWakeup_dispatchedInOrder)
+{
+    TestEventQueue queue;
+    EventTarget target;
+    std::string order;
+
+    // FileStreamer waits for this to send the next chunk;  it must not be
+    // held back behind input
+    queue.add_handler(EventType::FILE_CHUNK_SENDING, &target, [&](const Event&) {
+        order += 'F';
+    });
+    queue.add_handler(EventType::KEY_STATE_KEY_DOWN, &target, [&](const Event&) {
+        order += 'k';
+        if (order.size() == 5) {
+            queue.raiseQuitEvent();
+        }
+    });
+
+    queue.add_event(Event(EventType::KEY_STATE_KEY_DOWN, &target));
+    queue.add_event(Event(EventType::FILE_CHUNK_SENDING, &target));
+    for (int i = 0; i < 3; ++i) {
+        queue.add_event(Event(EventType::KEY_STATE_KEY_DOWN, &target));
+    }
+
+    queue.initQuitTimeout(5);
+    queue.loop();
+    queue.cleanupQuitTimeout();
+    queue.remove_handlers(&target);
+
+    EXPECT_EQ("kFkkk", order);
+}
+
+TEST(EventQueueTests, add_event_severalThreads_eachDispatchedOnce)
+{
+    TestEventQueue queue;
+    const int kThreads = 4;
+    const int kPerThread = 2000;
+    EventTarget targets[kThreads];
+    std::vector<int> received(kThreads, 0);
+    int total = 0;
+
+    for (int i = 0; i < kThreads; ++i) {
+        queue.add_handler(EventType::KEY_STATE_KEY_DOWN, &targets[i], [&, i](const Event&) {
+            ++received[i];
+            if (++total == kThreads * kPerThread) {
+                queue.raiseQuitEvent();
+            }
+        });
+    }
+
+    // posting threads only share the buffer lock, so they race each other
+    // and the dispatching thread
+    std::vector<std::thread> posters;
+    for (int i = 0; i < kThreads; ++i) {
+        posters.emplace_back([&, i]() {
+            queue.waitForReady();
+            for (int j = 0; j < kPerThread; ++j) {
+                queue.add_event(Event(EventType::KEY_STATE_KEY_DOWN, &targets[i]));
+            }
+        });
+    }
+
+    queue.initQuitTimeout(10);
+    queue.loop();
+    queue.cleanupQuitTimeout();
+    for (auto& poster : posters) {
+        poster.join();
+    }
+    for (int i = 0; i < kThreads; ++i) {
+        queue.remove_handlers(&targets[i]);
+        EXPECT_EQ(kPerThread, received[i]);
+    }
+}
@@ -0,0 +1,182 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/Log.h"
+#include "base/ILogOutputter.h"
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace inputleap;
+
+namespace {
+
+// records messages and keeps them from reaching the console
+class RecordingOutputter : public ILogOutputter {
+public:
+    void open(const char*) override { }
+    void close() override { }
+    void show(bool) override { }
+    bool write(ELevel level, const char* message) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        levels.push_back(level);
+        messages.push_back(message);
+        return false;
+    }
+
+    std::mutex mutex;
+    std::vector<ELevel> levels;
+    std::vector<std::string> messages;
+};
+
+bool contains(const std::string& message, const char* text)
+{
+    return message.find(text) != std::string::npos;
+}
+
+} // namespace
+
+TEST(LogTests, print_async_flushWritesAllMessages)
+{
+    RecordingOutputter outputter;
+    CLOG->insert(&outputter);
+    CLOG->set_async(true);
+    std::uint64_t dropped = CLOG->dropped_messages();
+
+    const int threads = 4;
+    const int per_thread = 50;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; ++t) {
+        producers.emplace_back([]() {
+            for (int i = 0; i < per_thread; ++i) {
+                LOG_WARN("async message %d", i);
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    CLOG->flush();
+
+    std::size_t written = 0;
+    {
+        std::lock_guard<std::mutex> lock(outputter.mutex);
+        for (const auto& message : outputter.messages) {
+            if (contains(message, "async message")) {
+                ++written;
+            }
+        }
+    }
+
+    dropped = CLOG->dropped_messages() - dropped;
+
+    CLOG->set_async(false);
+    CLOG->remove(&outputter);
+
+    // anything that did not fit in the ring must have been counted
+    EXPECT_GT(written, 0u);
+    EXPECT_EQ(std::uint64_t(threads * per_thread), written + dropped);
+}
+
+TEST(LogTests, print_asyncFatal_writtenAfterEarlierMessages)
+{
+    RecordingOutputter outputter;
+    CLOG->insert(&outputter);
+    CLOG->set_async(true);
+
+    LOG_WARN("before fatal");
+    LOG_CRIT("fatal message");
+
+    // the fatal message is written synchronously, so no flush is needed
+    std::vector<std::string> messages;
+    {
+        std::lock_guard<std::mutex> lock(outputter.mutex);
+        messages = outputter.messages;
+    }
+
+    CLOG->set_async(false);
+    CLOG->remove(&outputter);
+
+    ASSERT_EQ(2u, messages.size());
+    EXPECT_TRUE(contains(messages[0], "before fatal"));
+    EXPECT_TRUE(contains(messages[1], "fatal message"));
+}
+
+TEST(LogTests, setAsync_disable_writesPendingMessages)
+{
+    RecordingOutputter outputter;
+    CLOG->insert(&outputter);
+    CLOG->set_async(true);
+    EXPECT_TRUE(CLOG->is_async());
+
+    LOG_WARN("pending message");
+    CLOG->set_async(false);
+    EXPECT_FALSE(CLOG->is_async());
+
+    std::size_t count = outputter.messages.size();
+    CLOG->remove(&outputter);
+
+    EXPECT_EQ(1u, count);
+}
+
+TEST(LogTests, setCategoryFilters_validSpec_overridesGlobalFilter)
+{
+    int global = CLOG->getFilter();
+
+    EXPECT_TRUE(CLOG->set_category_filters("net=DEBUG2,x11=WARNING"));
+    EXPECT_TRUE(CLOG->is_enabled(LogCategory::NET, kDEBUG2));
+    EXPECT_FALSE(CLOG->is_enabled(LogCategory::NET, kDEBUG3));
+    EXPECT_FALSE(CLOG->is_enabled(LogCategory::X11, kNOTE));
+    EXPECT_EQ(global, CLOG->get_category_filter(LogCategory::SERVER));
+
+    // categories without their own filter follow the global one
+    CLOG->setFilter(kINFO);
+    EXPECT_EQ(kINFO, CLOG->get_category_filter(LogCategory::SERVER));
+    EXPECT_EQ(kDEBUG2, CLOG->get_category_filter(LogCategory::NET));
+
+    EXPECT_TRUE(CLOG->set_category_filters("net=default,x11=default"));
+    EXPECT_EQ(kINFO, CLOG->get_category_filter(LogCategory::NET));
+    EXPECT_EQ(kINFO, CLOG->get_category_filter(LogCategory::X11));
+
+    CLOG->setFilter(global);
+}
+
+TEST(LogTests, setCategoryFilters_emptySpec_clearsAllFilters)
+{
+    int global = CLOG->getFilter();
+
+    EXPECT_TRUE(CLOG->set_category_filters("net=DEBUG2,x11=WARNING"));
+    EXPECT_TRUE(CLOG->set_category_filters(""));
+    EXPECT_EQ(global, CLOG->get_category_filter(LogCategory::NET));
+    EXPECT_EQ(global, CLOG->get_category_filter(LogCategory::X11));
+}
+
+TEST(LogTests, setCategoryFilters_invalidSpec_changesNothing)
+{
+    int net = CLOG->get_category_filter(LogCategory::NET);
+
+    EXPECT_FALSE(CLOG->set_category_filters("net=DEBUG5,bogus=INFO"));
+    EXPECT_FALSE(CLOG->set_category_filters("net=LOUD"));
+    EXPECT_FALSE(CLOG->set_category_filters("net"));
+    EXPECT_EQ(net, CLOG->get_category_filter(LogCategory::NET));
+}
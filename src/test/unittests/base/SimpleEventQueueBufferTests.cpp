@@ -0,0 +1,111 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/SimpleEventQueueBuffer.h"
+#include "base/Event.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace inputleap;
+
+TEST(SimpleEventQueueBufferTests, getEvent_emptyBuffer_returnsNone)
+{
+    SimpleEventQueueBuffer buffer;
+    Event event;
+    std::uint32_t id = 0;
+
+    EXPECT_TRUE(buffer.isEmpty());
+    EXPECT_EQ(IEventQueueBuffer::kNone, buffer.getEvent(event, id));
+}
+
+TEST(SimpleEventQueueBufferTests, addEvent_moreThanRingCapacity_keepsOrder)
+{
+    SimpleEventQueueBuffer buffer;
+    const std::uint32_t count = 5000;
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        EXPECT_TRUE(buffer.addEvent(i));
+    }
+
+    Event event;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint32_t id = 0;
+        ASSERT_EQ(IEventQueueBuffer::kUser, buffer.getEvent(event, id));
+        EXPECT_EQ(i, id);
+    }
+    EXPECT_TRUE(buffer.isEmpty());
+    EXPECT_GT(buffer.get_stats().overflowed, 0u);
+}
+
+TEST(SimpleEventQueueBufferTests, addEvent_multipleProducers_keepsPerThreadOrder)
+{
+    SimpleEventQueueBuffer buffer;
+    const std::uint32_t producers = 4;
+    const std::uint32_t per_producer = 20000;
+
+    std::vector<std::thread> threads;
+    for (std::uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&buffer, p, per_producer]() {
+            for (std::uint32_t i = 0; i < per_producer; ++i) {
+                buffer.addEvent((p << 24) | i);
+            }
+        });
+    }
+
+    std::vector<std::uint32_t> next(producers, 0);
+    Event event;
+    for (std::uint32_t received = 0; received < producers * per_producer;) {
+        buffer.waitForEvent(1.0);
+        std::uint32_t id = 0;
+        if (buffer.getEvent(event, id) != IEventQueueBuffer::kUser) {
+            continue;
+        }
+        std::uint32_t p = id >> 24;
+        ASSERT_LT(p, producers);
+        ASSERT_EQ(next[p], id & 0xffffff);
+        ++next[p];
+        ++received;
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(buffer.isEmpty());
+}
+
+TEST(SimpleEventQueueBufferTests, waitForEvent_sleepingConsumer_isWoken)
+{
+    SimpleEventQueueBuffer buffer;
+
+    std::thread producer([&buffer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        buffer.addEvent(42);
+    });
+
+    while (buffer.isEmpty()) {
+        buffer.waitForEvent(5.0);
+    }
+    producer.join();
+
+    Event event;
+    std::uint32_t id = 0;
+    EXPECT_EQ(IEventQueueBuffer::kUser, buffer.getEvent(event, id));
+    EXPECT_EQ(42u, id);
+    EXPECT_GE(buffer.get_stats().wakes, 1u);
+}
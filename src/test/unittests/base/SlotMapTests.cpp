@@ -0,0 +1,96 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/SlotMap.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace inputleap;
+
+TEST(SlotMapTests, insert_take_returnsValue)
+{
+    SlotMap<std::string> slots;
+
+    auto id = slots.insert("foo");
+    EXPECT_EQ(1u, slots.size());
+
+    std::string value;
+    EXPECT_TRUE(slots.take(id, value));
+    EXPECT_EQ("foo", value);
+    EXPECT_TRUE(slots.empty());
+}
+
+TEST(SlotMapTests, take_staleId_fails)
+{
+    SlotMap<std::string> slots;
+
+    auto old_id = slots.insert("foo");
+    std::string value;
+    slots.take(old_id, value);
+
+    // the slot is reused with a new generation
+    auto new_id = slots.insert("bar");
+    EXPECT_NE(old_id, new_id);
+    EXPECT_EQ(old_id & SlotMap<std::string>::kIndexMask,
+              new_id & SlotMap<std::string>::kIndexMask);
+
+    value.clear();
+    EXPECT_FALSE(slots.take(old_id, value));
+    EXPECT_EQ("", value);
+    EXPECT_TRUE(slots.take(new_id, value));
+    EXPECT_EQ("bar", value);
+}
+
+TEST(SlotMapTests, contains_generationWrapsAround)
+{
+    SlotMap<int> slots;
+    auto old_id = slots.insert(1);
+    int value;
+    slots.take(old_id, value);
+
+    // the documented limit:  the generation in the ID only has so many bits
+    for (unsigned i = 1; i < (1u << SlotMap<int>::kGenerationBits); ++i) {
+        EXPECT_FALSE(slots.contains(old_id));
+        slots.take(slots.insert(2), value);
+    }
+    EXPECT_EQ(slots.insert(3), old_id);
+}
+
+TEST(SlotMapTests, take_unknownId_fails)
+{
+    SlotMap<int> slots;
+    int value = 0;
+    EXPECT_FALSE(slots.take(1234, value));
+}
+
+TEST(SlotMapTests, clear_visitsAllValues)
+{
+    SlotMap<int> slots;
+    auto id1 = slots.insert(1);
+    slots.insert(2);
+    slots.insert(3);
+    int value = 0;
+    slots.take(id1, value);
+
+    int sum = 0;
+    slots.clear([&](int v) { sum += v; });
+
+    EXPECT_EQ(5, sum);
+    EXPECT_TRUE(slots.empty());
+    EXPECT_FALSE(slots.contains(id1));
+}
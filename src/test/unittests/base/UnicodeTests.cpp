@@ -0,0 +1,406 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/Unicode.h"
+#include "base/UnicodeSimd.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace inputleap;
+
+namespace {
+
+std::string wide16(const std::vector<std::uint16_t>& chars)
+{
+    return std::string(reinterpret_cast<const char*>(chars.data()), 2 * chars.size());
+}
+
+std::string wide32(const std::vector<std::uint32_t>& chars)
+{
+    return std::string(reinterpret_cast<const char*>(chars.data()), 4 * chars.size());
+}
+
+std::string swap16(const std::string& src)
+{
+    std::string dst = src;
+    for (std::size_t i = 0; i + 1 < dst.size(); i += 2) {
+        std::swap(dst[i], dst[i + 1]);
+    }
+    return dst;
+}
+
+// ASCII text long enough to exercise every vector width, with a multibyte
+// character placed at offset
+std::string ascii_text(std::size_t size, std::size_t offset = std::string::npos)
+{
+    std::string text;
+    for (std::size_t i = 0; i < size; ++i) {
+        text += static_cast<char>('a' + i % 26);
+        if (i + 1 == offset) {
+            text += "\xc3\xa9";
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+TEST(UnicodeSimdTests, ascii_prefix_stops_at_first_high_byte)
+{
+    std::vector<std::uint8_t> data(100, 'x');
+    for (std::size_t pos = 0; pos < data.size(); ++pos) {
+        data[pos] = 0x80;
+        EXPECT_EQ(unicode_simd::ascii_prefix(data.data(), data.size()), pos);
+        data[pos] = 'x';
+    }
+    EXPECT_EQ(unicode_simd::ascii_prefix(data.data(), data.size()), data.size());
+    EXPECT_EQ(unicode_simd::ascii_prefix(data.data(), 0), 0u);
+}
+
+TEST(UnicodeSimdTests, widen_and_narrow_match_scalar)
+{
+    for (std::size_t size = 0; size < 70; ++size) {
+        std::vector<std::uint8_t> src(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            src[i] = static_cast<std::uint8_t>(0x20 + i % 0x5f);
+        }
+
+        std::vector<std::uint16_t> w16(size);
+        std::vector<std::uint32_t> w32(size);
+        EXPECT_EQ(unicode_simd::widen_ascii16(src.data(), size,
+                    reinterpret_cast<std::uint8_t*>(w16.data())), size);
+        EXPECT_EQ(unicode_simd::widen_ascii32(src.data(), size,
+                    reinterpret_cast<std::uint8_t*>(w32.data())), size);
+        for (std::size_t i = 0; i < size; ++i) {
+            EXPECT_EQ(w16[i], src[i]);
+            EXPECT_EQ(w32[i], src[i]);
+        }
+
+        std::vector<std::uint8_t> n16(size), n32(size);
+        EXPECT_EQ(unicode_simd::narrow_ascii16(
+                    reinterpret_cast<const std::uint8_t*>(w16.data()), size, n16.data()), size);
+        EXPECT_EQ(unicode_simd::narrow_ascii32(
+                    reinterpret_cast<const std::uint8_t*>(w32.data()), size, n32.data()), size);
+        EXPECT_EQ(n16, src);
+        EXPECT_EQ(n32, src);
+    }
+}
+
+TEST(UnicodeSimdTests, narrow_stops_at_wide_characters)
+{
+    std::vector<std::uint16_t> w16(40, 'a');
+    std::vector<std::uint32_t> w32(40, 'a');
+    std::vector<std::uint8_t> out(40);
+    w16[33] = 0x0100;
+    w32[17] = 0x00010000;
+    EXPECT_EQ(unicode_simd::narrow_ascii16(
+                reinterpret_cast<const std::uint8_t*>(w16.data()), 40, out.data()), 33u);
+    EXPECT_EQ(unicode_simd::narrow_ascii32(
+                reinterpret_cast<const std::uint8_t*>(w32.data()), 40, out.data()), 17u);
+    w16[33] = 0x0080;
+    EXPECT_EQ(unicode_simd::narrow_ascii16(
+                reinterpret_cast<const std::uint8_t*>(w16.data()), 40, out.data()), 33u);
+}
+
+TEST(UnicodeTests, isUTF8_long_text)
+{
+    for (std::size_t offset : { 0, 5, 16, 31, 32, 33, 63, 100 }) {
+        std::string text = ascii_text(120, offset);
+        EXPECT_TRUE(Unicode::isUTF8(text));
+        text.back() = '\xff';
+        EXPECT_FALSE(Unicode::isUTF8(text));
+    }
+    EXPECT_TRUE(Unicode::isUTF8(""));
+    EXPECT_FALSE(Unicode::isUTF8(ascii_text(64) + "\xc3"));
+    EXPECT_FALSE(Unicode::isUTF8(ascii_text(64) + "\xed\xa0\x80")); // surrogate
+    EXPECT_FALSE(Unicode::isUTF8(ascii_text(64) + "\xc0\xaf"));     // overlong
+}
+
+TEST(UnicodeTests, UTF8ToUTF16_mixed_text)
+{
+    std::string text = ascii_text(40) + "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80" + ascii_text(20);
+    std::vector<std::uint16_t> expected;
+    for (char c : ascii_text(40)) {
+        expected.push_back(static_cast<std::uint16_t>(c));
+    }
+    expected.insert(expected.end(), { 0x00e9, 0x20ac, 0xd83d, 0xde00 });
+    for (char c : ascii_text(20)) {
+        expected.push_back(static_cast<std::uint16_t>(c));
+    }
+
+    bool errors = true;
+    EXPECT_EQ(Unicode::UTF8ToUTF16(text, &errors), wide16(expected));
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(Unicode::UTF16ToUTF8(wide16(expected), &errors), text);
+    EXPECT_FALSE(errors);
+}
+
+TEST(UnicodeTests, UTF8ToUCS2_replaces_characters_outside_bmp)
+{
+    bool errors = false;
+    std::string result = Unicode::UTF8ToUCS2(ascii_text(33) + "\xf0\x9f\x98\x80", &errors);
+    EXPECT_TRUE(errors);
+    ASSERT_EQ(result.size(), 2u * 34);
+    std::uint16_t last;
+    std::memcpy(&last, result.data() + 66, 2);
+    EXPECT_EQ(last, 0xfffd);
+}
+
+TEST(UnicodeTests, UTF8ToUTF32_round_trip)
+{
+    std::string text = ascii_text(70, 17) + "\xe2\x82\xac";
+    bool errors = true;
+    std::string wide = Unicode::UTF8ToUTF32(text, &errors);
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(wide.size(), 4u * 72);
+    EXPECT_EQ(Unicode::UTF32ToUTF8(wide, &errors), text);
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(Unicode::UTF8ToUCS4(text, &errors), wide);
+    EXPECT_EQ(Unicode::UCS4ToUTF8(wide, &errors), text);
+}
+
+TEST(UnicodeTests, invalid_utf8_is_replaced_without_error)
+{
+    bool errors = true;
+    std::string result = Unicode::UTF8ToUTF32(ascii_text(20) + "\xff" + "z", &errors);
+    EXPECT_FALSE(errors);
+    std::vector<std::uint32_t> expected;
+    for (char c : ascii_text(20)) {
+        expected.push_back(static_cast<std::uint32_t>(c));
+    }
+    expected.push_back(0xfffd);
+    expected.push_back('z');
+    EXPECT_EQ(result, wide32(expected));
+}
+
+TEST(UnicodeTests, UTF16ToUTF8_lone_surrogates)
+{
+    bool errors = false;
+    EXPECT_EQ(Unicode::UTF16ToUTF8(wide16({ 'a', 0xdc00, 'b' }), &errors), "a\xef\xbf\xbd" "b");
+    EXPECT_TRUE(errors);
+    errors = false;
+    EXPECT_EQ(Unicode::UTF16ToUTF8(wide16({ 'a', 0xd800 }), &errors), "a\xef\xbf\xbd");
+    EXPECT_TRUE(errors);
+    errors = false;
+    EXPECT_EQ(Unicode::UCS2ToUTF8(wide16({ 0xd800, 'a' }), &errors), "\xef\xbf\xbd" "a");
+    EXPECT_TRUE(errors);
+}
+
+TEST(UnicodeTests, byte_order_mark)
+{
+    std::string text = ascii_text(50) + "\xc3\xa9";
+    std::string wide = Unicode::UTF8ToUTF16(text);
+    bool errors = true;
+    EXPECT_EQ(Unicode::UTF16ToUTF8(wide16({ 0xfeff }) + wide, &errors), text);
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(Unicode::UTF16ToUTF8(swap16(wide16({ 0xfeff }) + wide), &errors), text);
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(Unicode::UCS2ToUTF8(swap16(wide16({ 0xfeff }) + wide), &errors), text);
+    EXPECT_FALSE(errors);
+}
+
+TEST(UnicodeTests, UTF32ToUTF8_out_of_range)
+{
+    bool errors = false;
+    EXPECT_EQ(Unicode::UTF32ToUTF8(wide32({ 'a', 0x00110000 }), &errors), "a\xef\xbf\xbd");
+    EXPECT_TRUE(errors);
+}
+
+TEST(UnicodeSimdTests, plain_text_stops_at_line_endings)
+{
+    for (std::size_t pos = 0; pos < 40; ++pos) {
+        for (char stop : { '\r', '\n' }) {
+            std::string text(40, 'a');
+            text[pos] = stop;
+            const std::uint8_t* src = reinterpret_cast<const std::uint8_t*>(text.data());
+            std::vector<std::uint8_t> out(40);
+            std::vector<std::uint16_t> wide(40);
+            EXPECT_EQ(unicode_simd::copy_plain(src, 40, out.data()), pos);
+            EXPECT_EQ(unicode_simd::widen_plain16(src, 40,
+                        reinterpret_cast<std::uint8_t*>(wide.data())), pos);
+
+            std::vector<std::uint16_t> chars(40, 'a');
+            chars[pos] = static_cast<std::uint16_t>(stop);
+            EXPECT_EQ(unicode_simd::narrow_plain16(
+                        reinterpret_cast<const std::uint8_t*>(chars.data()), 40, out.data()), pos);
+        }
+    }
+}
+
+TEST(UnicodeTests, from_utf8_text_normalizes_line_endings)
+{
+    const std::string text = ascii_text(20) + "\r\n" + ascii_text(20, 3) + "\r" + "x\n\n";
+    const std::string lf   = ascii_text(20) + "\n"   + ascii_text(20, 3) + "\n" + "x\n\n";
+    const std::string crlf = ascii_text(20) + "\r\n" + ascii_text(20, 3) + "\r\n" + "x\r\n\r\n";
+    const std::string cr   = ascii_text(20) + "\r"   + ascii_text(20, 3) + "\r" + "x\r\r";
+    using E = Unicode::TextEncoding;
+    using N = Unicode::Newline;
+
+    EXPECT_EQ(Unicode::from_utf8_text(text, E::UTF8, N::LF), lf);
+    EXPECT_EQ(Unicode::from_utf8_text(text, E::UTF8, N::CRLF), crlf);
+    EXPECT_EQ(Unicode::from_utf8_text(text, E::UTF8, N::CR), cr);
+    EXPECT_EQ(Unicode::from_utf8_text(lf, E::UTF8, N::LF), lf);
+
+    bool errors = true;
+    EXPECT_EQ(Unicode::from_utf8_text(text, E::UTF16, N::CRLF, &errors), Unicode::UTF8ToUTF16(crlf));
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(Unicode::from_utf8_text(text, E::UCS2, N::LF, &errors), Unicode::UTF8ToUCS2(lf));
+    EXPECT_FALSE(errors);
+}
+
+TEST(UnicodeTests, from_utf8_text_errors_match_plain_conversion)
+{
+    const std::string text = "a\xf0\x9f\x98\x80\r\nb\xff";
+    bool errors = false;
+    EXPECT_EQ(Unicode::from_utf8_text(text, Unicode::TextEncoding::UCS2, Unicode::Newline::LF,
+                                      &errors),
+              Unicode::UTF8ToUCS2("a\xf0\x9f\x98\x80\nb\xff"));
+    EXPECT_TRUE(errors);
+    EXPECT_EQ(Unicode::from_utf8_text(text, Unicode::TextEncoding::UTF16, Unicode::Newline::LF,
+                                      &errors),
+              Unicode::UTF8ToUTF16("a\xf0\x9f\x98\x80\nb\xff"));
+    EXPECT_FALSE(errors);
+
+    // invalid bytes pass through unchanged when staying in UTF-8
+    EXPECT_EQ(Unicode::from_utf8_text(text, Unicode::TextEncoding::UTF8, Unicode::Newline::LF),
+              "a\xf0\x9f\x98\x80\nb\xff");
+}
+
+TEST(UnicodeTests, to_utf8_text_normalizes_line_endings)
+{
+    const std::string text = ascii_text(30) + "\r\n\xc3\xa9\r" + ascii_text(17) + "\n";
+    const std::string lf   = ascii_text(30) + "\n\xc3\xa9\n"    + ascii_text(17) + "\n";
+    using E = Unicode::TextEncoding;
+    using N = Unicode::Newline;
+
+    bool errors = true;
+    EXPECT_EQ(Unicode::to_utf8_text(Unicode::UTF8ToUTF16(text), E::UTF16, N::LF, &errors), lf);
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(Unicode::to_utf8_text(swap16(wide16({ 0xfeff }) + Unicode::UTF8ToUCS2(text)),
+                                    E::UCS2, N::LF, &errors), lf);
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(Unicode::to_utf8_text(text, E::UTF8, N::LF), lf);
+    EXPECT_EQ(Unicode::to_utf8_text(wide16({ 'a', 0xd83d, 0xde00, '\r' }), E::UTF16, N::CRLF),
+              "a\xf0\x9f\x98\x80\r\n");
+}
+
+TEST(UnicodeTests, long_text_is_sized_exactly)
+{
+    // several output blocks, with characters of every size across their ends
+    std::string text;
+    std::string lf;
+    for (std::size_t i = 0; text.size() < 40000; ++i) {
+        text += ascii_text(i % 61) + "\r\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\r";
+        lf   += ascii_text(i % 61) + "\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\n";
+    }
+    using E = Unicode::TextEncoding;
+    using N = Unicode::Newline;
+    auto exact = [](const std::string& s) { return s.capacity() < s.size() + 16; };
+
+    bool errors = true;
+    std::string utf16 = Unicode::UTF8ToUTF16(text, &errors);
+    EXPECT_FALSE(errors);
+    EXPECT_TRUE(exact(utf16));
+    std::string utf8 = Unicode::UTF16ToUTF8(utf16, &errors);
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(utf8, text);
+    EXPECT_TRUE(exact(utf8));
+    EXPECT_EQ(Unicode::UTF16ToUTF8(swap16(wide16({ 0xfeff }) + utf16)), text);
+
+    std::string utf32 = Unicode::UTF8ToUTF32(text);
+    EXPECT_TRUE(exact(utf32));
+    utf8 = Unicode::UTF32ToUTF8(utf32);
+    EXPECT_EQ(utf8, text);
+    EXPECT_TRUE(exact(utf8));
+    EXPECT_TRUE(exact(Unicode::UTF8ToUCS2(text)));
+    EXPECT_TRUE(exact(Unicode::UTF8ToUCS4(text)));
+
+    std::string crlf16 = Unicode::from_utf8_text(text, E::UTF16, N::CRLF, &errors);
+    EXPECT_FALSE(errors);
+    EXPECT_TRUE(exact(crlf16));
+    utf8 = Unicode::to_utf8_text(crlf16, E::UTF16, N::LF, &errors);
+    EXPECT_FALSE(errors);
+    EXPECT_EQ(utf8, lf);
+    EXPECT_TRUE(exact(utf8));
+    EXPECT_EQ(Unicode::to_utf8_text(swap16(wide16({ 0xfeff }) + crlf16), E::UTF16, N::LF), lf);
+    utf8 = Unicode::from_utf8_text(text, E::UTF8, N::LF);
+    EXPECT_EQ(utf8, lf);
+    EXPECT_TRUE(exact(utf8));
+}
+
+// timings for the conversions; run with --gtest_also_run_disabled_tests
+TEST(UnicodeTests, DISABLED_benchmark)
+{
+    const std::string ascii = ascii_text(1 << 20);
+    std::string mixed;
+    while (mixed.size() < (1u << 20)) {
+        mixed += "Gr\xc3\xbc\xc3\x9f" "e, \xe4\xb8\x96\xe7\x95\x8c and some more ASCII text. ";
+    }
+
+    auto run = [](const char* name, const std::string& text, std::string (*fn)(const std::string&, bool*)) {
+        const int iterations = 50;
+        std::size_t total = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            total += fn(text, nullptr).size();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double mb = static_cast<double>(text.size()) * iterations / (1 << 20);
+        std::printf("%-24s %8.1f MB/s (%zu)\n", name, mb / elapsed.count(), total);
+    };
+
+    std::printf("implementation: %s\n", unicode_simd::implementation());
+    run("UTF8ToUTF16 ascii", ascii, &Unicode::UTF8ToUTF16);
+    run("UTF8ToUTF16 mixed", mixed, &Unicode::UTF8ToUTF16);
+    run("UTF8ToUTF32 ascii", ascii, &Unicode::UTF8ToUTF32);
+    run("UTF8ToUCS2 mixed", mixed, &Unicode::UTF8ToUCS2);
+    const std::string wide_ascii = Unicode::UTF8ToUTF16(ascii);
+    const std::string wide_mixed = Unicode::UTF8ToUTF16(mixed);
+    run("UTF16ToUTF8 ascii", wide_ascii, &Unicode::UTF16ToUTF8);
+    run("UTF16ToUTF8 mixed", wide_mixed, &Unicode::UTF16ToUTF8);
+    run("UTF32ToUTF8 ascii", Unicode::UTF8ToUTF32(ascii), &Unicode::UTF32ToUTF8);
+
+    auto start = std::chrono::steady_clock::now();
+    bool valid = true;
+    for (int i = 0; i < 50; ++i) {
+        valid = valid && Unicode::isUTF8(mixed);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%-24s %8.1f MB/s\n", "isUTF8 mixed",
+                static_cast<double>(mixed.size()) * 50 / (1 << 20) / elapsed.count());
+    EXPECT_TRUE(valid);
+
+    std::string lines;
+    while (lines.size() < (1u << 20)) {
+        lines += "A line of text with a DOS line ending\r\n";
+    }
+    start = std::chrono::steady_clock::now();
+    std::size_t total = 0;
+    for (int i = 0; i < 50; ++i) {
+        total += Unicode::from_utf8_text(lines, Unicode::TextEncoding::UTF16,
+                                         Unicode::Newline::LF).size();
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%-24s %8.1f MB/s (%zu)\n", "from_utf8_text lines",
+                static_cast<double>(lines.size()) * 50 / (1 << 20) / elapsed.count(), total);
+}
@@ -0,0 +1,151 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/ChunkCodec.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace inputleap;
+
+namespace {
+
+const std::uint8_t* bytes(const std::string& s)
+{
+    return reinterpret_cast<const std::uint8_t*>(s.data());
+}
+
+std::string text(std::size_t size)
+{
+    std::string data;
+    while (data.size() < size) {
+        data += "The quick brown fox jumps over the lazy dog. ";
+    }
+    data.resize(size);
+    return data;
+}
+
+std::string noise(std::size_t size)
+{
+    std::mt19937 random(42);
+    std::string data(size, '\0');
+    for (auto& c : data) {
+        c = static_cast<char>(random());
+    }
+    return data;
+}
+
+ChunkCodec available_codec()
+{
+    auto codecs = supported_chunk_codecs();
+    return codecs.empty() ? ChunkCodec::kNone : static_cast<ChunkCodec>(codecs.front());
+}
+
+} // namespace
+
+TEST(ChunkCodecTests, compress_roundTrips)
+{
+    if (available_codec() == ChunkCodec::kNone) {
+        GTEST_SKIP() << "built without compression";
+    }
+
+    ChunkCompressor compressor(available_codec());
+    std::string data = text(32 * 1024);
+    std::string payload;
+    ASSERT_TRUE(compressor.compress(bytes(data), data.size(), payload));
+    EXPECT_LT(payload.size(), data.size() / 4);
+
+    std::string out = "prefix";
+    ASSERT_TRUE(decompress_chunk(bytes(payload), payload.size(), out));
+    EXPECT_EQ(out, "prefix" + data);
+
+    EXPECT_EQ(compressor.stats().raw_size, data.size());
+    EXPECT_EQ(compressor.stats().sent_size, payload.size());
+}
+
+TEST(ChunkCodecTests, compress_skipsSmallAndIncompressibleChunks)
+{
+    if (available_codec() == ChunkCodec::kNone) {
+        GTEST_SKIP() << "built without compression";
+    }
+
+    ChunkCompressor compressor(available_codec());
+    std::string payload;
+    std::string small = text(ChunkCompressor::kMinChunkSize - 1);
+    EXPECT_FALSE(compressor.compress(bytes(small), small.size(), payload));
+
+    // gives up after a few chunks that don't shrink
+    std::string random = noise(32 * 1024);
+    for (int i = 0; i < ChunkCompressor::kMaxPoorChunks; ++i) {
+        EXPECT_EQ(compressor.codec(), available_codec());
+        EXPECT_FALSE(compressor.compress(bytes(random), random.size(), payload));
+    }
+    EXPECT_EQ(compressor.codec(), ChunkCodec::kNone);
+    std::string data = text(32 * 1024);
+    EXPECT_FALSE(compressor.compress(bytes(data), data.size(), payload));
+    EXPECT_EQ(compressor.stats().sent_size, compressor.stats().raw_size);
+
+    // until the next transfer
+    compressor.reset(available_codec());
+    EXPECT_TRUE(compressor.compress(bytes(data), data.size(), payload));
+}
+
+TEST(ChunkCodecTests, decompress_rejectsCorruptChunks)
+{
+    std::string out;
+    EXPECT_FALSE(decompress_chunk(nullptr, 0, out));
+
+    // unknown codec
+    std::string unknown("\xff\x00\x00\x00\x10" "data", 9);
+    EXPECT_FALSE(decompress_chunk(bytes(unknown), unknown.size(), out));
+
+    if (available_codec() != ChunkCodec::kNone) {
+        ChunkCompressor compressor(available_codec());
+        std::string data = text(4096);
+        std::string payload;
+        ASSERT_TRUE(compressor.compress(bytes(data), data.size(), payload));
+        payload.resize(payload.size() / 2);
+        EXPECT_FALSE(decompress_chunk(bytes(payload), payload.size(), out));
+    }
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(ChunkCodecTests, choose_prefersSharedCodec)
+{
+    EXPECT_EQ(choose_chunk_codec({}), ChunkCodec::kNone);
+    EXPECT_EQ(choose_chunk_codec({200}), ChunkCodec::kNone);
+    EXPECT_EQ(choose_chunk_codec(supported_chunk_codecs()), available_codec());
+}
+
+TEST(ChunkCodecTests, is_compressed_format_recognizesImages)
+{
+    std::string png("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16);
+    std::string jpeg("\xff\xd8\xff\xe0\0\x10JFIF", 10);
+    std::string webp("RIFF\x10\0\0\0WEBPVP8 ", 16);
+    std::string wav("RIFF\x10\0\0\0WAVEfmt ", 16);
+
+    EXPECT_TRUE(is_compressed_format(bytes(png), png.size()));
+    EXPECT_TRUE(is_compressed_format(bytes(jpeg), jpeg.size()));
+    EXPECT_TRUE(is_compressed_format(bytes(webp), webp.size()));
+    EXPECT_FALSE(is_compressed_format(bytes(wav), wav.size()));
+    EXPECT_FALSE(is_compressed_format(bytes(png), 4));
+    std::string plain = text(100);
+    EXPECT_FALSE(is_compressed_format(bytes(plain), plain.size()));
+}
@@ -0,0 +1,194 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/ClipboardStreamer.h"
+#include "inputleap/Clipboard.h"
+#include "inputleap/protocol_types.h"
+#include "test/mock/io/MockStream.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <vector>
+
+using namespace inputleap;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace {
+
+// a stream whose output buffer fills with every chunk until flushed
+class StreamerHarness {
+public:
+    StreamerHarness()
+    {
+        ON_CALL(stream, getOutputSize()).WillByDefault(Invoke([this]() { return pending_; }));
+        streamer = std::make_unique<ClipboardStreamer>(&stream,
+            [this](const ClipboardChunk& chunk) {
+                chunks.push_back(chunk);
+                pending_ += CLIPBOARD_CHUNK_META_SIZE + chunk.payload_size();
+            });
+    }
+
+    void flush()
+    {
+        pending_ = 0;
+        streamer->pump();
+    }
+
+    NiceMock<MockStream> stream;
+    std::unique_ptr<ClipboardStreamer> streamer;
+    std::vector<ClipboardChunk> chunks;
+
+private:
+    std::uint32_t pending_ = 0;
+};
+
+} // namespace
+
+TEST(ClipboardStreamerTests, send_waitsForFlush)
+{
+    StreamerHarness harness;
+    auto data = std::make_shared<const std::string>(100 * 1024, 'x');
+
+    harness.streamer->send(data, 1, 7);
+
+    // start and two chunks fill the output buffer
+    ASSERT_EQ(harness.chunks.size(), 3u);
+    EXPECT_EQ(harness.chunks[0].mark_, kDataStart);
+    EXPECT_EQ(harness.chunks[0].data_, "102400");
+    EXPECT_EQ(harness.streamer->progress(1).sent, 64u * 1024);
+    EXPECT_EQ(harness.streamer->progress(1).size, data->size());
+
+    while (harness.streamer->is_sending()) {
+        std::size_t before = harness.chunks.size();
+        harness.flush();
+        ASSERT_GT(harness.chunks.size(), before);
+    }
+
+    ASSERT_EQ(harness.chunks.size(), 6u);
+    std::size_t offset = 0;
+    for (std::size_t i = 1; i + 1 < harness.chunks.size(); ++i) {
+        EXPECT_EQ(harness.chunks[i].mark_, kDataChunk);
+        EXPECT_EQ(harness.chunks[i].id_, 1);
+        EXPECT_EQ(harness.chunks[i].sequence_, 7u);
+        EXPECT_EQ(harness.chunks[i].payload(),
+                  reinterpret_cast<const std::uint8_t*>(data->data()) + offset);
+        offset += harness.chunks[i].payload_size();
+    }
+    EXPECT_EQ(offset, data->size());
+    EXPECT_EQ(harness.chunks.back().mark_, kDataEnd);
+    EXPECT_EQ(harness.streamer->progress(1).size, 0u);
+}
+
+TEST(ClipboardStreamerTests, send_empty_sendsEmptyChunk)
+{
+    StreamerHarness harness;
+
+    harness.streamer->send(std::make_shared<const std::string>(), 0, 0);
+
+    ASSERT_EQ(harness.chunks.size(), 3u);
+    EXPECT_EQ(harness.chunks[0].data_, "0");
+    EXPECT_EQ(harness.chunks[1].payload_size(), 0u);
+    EXPECT_EQ(harness.chunks[2].mark_, kDataEnd);
+    EXPECT_FALSE(harness.streamer->is_sending());
+}
+
+TEST(ClipboardStreamerTests, send_sameId_replacesQueuedClipboard)
+{
+    StreamerHarness harness;
+    harness.streamer->send(std::make_shared<const std::string>(200 * 1024, 'a'), 0, 0);
+    harness.streamer->send(std::make_shared<const std::string>(10, 'b'), 1, 0);
+    harness.streamer->send(std::make_shared<const std::string>(20, 'c'), 0, 0);
+
+    while (harness.streamer->is_sending()) {
+        harness.flush();
+    }
+
+    // clipboard 0 was cut short and sent again after clipboard 1
+    std::vector<std::pair<int, std::uint8_t>> starts;
+    for (const auto& chunk : harness.chunks) {
+        if (chunk.mark_ == kDataStart) {
+            starts.emplace_back(chunk.id_, chunk.data_.size());
+        }
+    }
+    EXPECT_EQ(starts, (std::vector<std::pair<int, std::uint8_t>>{{0, 6}, {1, 2}, {0, 2}}));
+    EXPECT_EQ(harness.chunks.back().mark_, kDataEnd);
+    EXPECT_EQ(harness.chunks.back().id_, 0);
+}
+
+TEST(ClipboardStreamerTests, cancel_stopsSending)
+{
+    StreamerHarness harness;
+    harness.streamer->send(std::make_shared<const std::string>(200 * 1024, 'a'), 0, 0);
+    std::size_t sent = harness.chunks.size();
+
+    harness.streamer->cancel(0);
+    harness.flush();
+
+    EXPECT_FALSE(harness.streamer->is_sending());
+    EXPECT_EQ(harness.chunks.size(), sent);
+}
+
+TEST(ClipboardStreamerTests, send_withCodec_compressesAllButImages)
+{
+    auto codecs = supported_chunk_codecs();
+    if (codecs.empty()) {
+        GTEST_SKIP() << "built without compression";
+    }
+
+    std::string text;
+    while (text.size() < 64 * 1024) {
+        text += "some clipboard text that compresses well\n";
+    }
+    std::string png("\x89PNG\r\n\x1a\n", 8);
+    png.resize(96 * 1024, 'p');
+
+    Clipboard clipboard;
+    clipboard.open(0);
+    clipboard.add(IClipboard::kText, text);
+    clipboard.add(IClipboard::kPNG, png);
+    clipboard.close();
+    auto data = clipboard.marshalled();
+
+    StreamerHarness harness;
+    harness.streamer->set_codec(static_cast<ChunkCodec>(codecs.front()));
+    harness.streamer->send(data, 0, 0);
+    while (harness.streamer->is_sending()) {
+        harness.flush();
+    }
+
+    std::string received;
+    std::size_t compressed = 0;
+    std::size_t raw = 0;
+    for (const auto& chunk : harness.chunks) {
+        if (chunk.mark_ == kDataCompressed) {
+            ASSERT_TRUE(decompress_chunk(chunk.payload(), chunk.payload_size(), received));
+            ++compressed;
+        } else if (chunk.mark_ == kDataChunk) {
+            received.append(reinterpret_cast<const char*>(chunk.payload()), chunk.payload_size());
+            ++raw;
+        }
+    }
+    EXPECT_EQ(received, *data);
+
+    // the text is compressed, the PNG isn't even though it would shrink
+    EXPECT_EQ(compressed, 2u);
+    EXPECT_EQ(raw, 4u);
+}
@@ -398,4 +398,138 @@ TEST(ClipboardTests, copy_withSingleText_clipboardsAreEqual)
     EXPECT_EQ("test string!", actual);
 }
 
+TEST(ClipboardTests, digest_sameData_digestsAreEqual)
+{
+    Clipboard clipboard1;
+    clipboard1.open(0);
+    clipboard1.add(Clipboard::kText, "test string!");
+    clipboard1.add(Clipboard::kHTML, "<b>test</b>");
+    clipboard1.close();
+
+    Clipboard clipboard2;
+    clipboard2.unmarshall(clipboard1.marshall(), 0);
+
+    EXPECT_EQ(clipboard1.digest(), clipboard2.digest());
+    EXPECT_EQ(clipboard1.get_hash(Clipboard::kText), content_hash("test string!"));
+}
+
+TEST(ClipboardTests, digest_differentData_digestsDiffer)
+{
+    Clipboard text;
+    text.open(0);
+    text.add(Clipboard::kText, "test string!");
+    text.close();
+
+    Clipboard html;
+    html.open(0);
+    html.add(Clipboard::kHTML, "test string!");
+    html.close();
+
+    Clipboard empty;
+    Clipboard emptyText;
+    emptyText.open(0);
+    emptyText.add(Clipboard::kText, "");
+    emptyText.close();
+
+    EXPECT_NE(text.digest(), html.digest());
+    EXPECT_NE(empty.digest(), emptyText.digest());
+
+    text.open(0);
+    text.clear();
+    text.close();
+    EXPECT_EQ(text.digest(), empty.digest());
+}
+
+TEST(ClipboardTests, marshalledSize_withTextAndHtml_matchesMarshall)
+{
+    Clipboard clipboard;
+    clipboard.open(0);
+    clipboard.add(Clipboard::kText, "test string!");
+    clipboard.add(Clipboard::kHTML, "<b>test</b>");
+    clipboard.close();
+
+    EXPECT_EQ(clipboard.marshall().size(), clipboard.marshalled_size());
+}
+
+TEST(ClipboardTests, marshalled_unchanged_returnsSameBuffer)
+{
+    Clipboard clipboard;
+    clipboard.open(0);
+    clipboard.add(Clipboard::kText, "test string!");
+    clipboard.close();
+
+    auto first = clipboard.marshalled();
+    auto second = clipboard.marshalled();
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(*first, clipboard.marshall());
+}
+
+TEST(ClipboardTests, marshalled_afterChange_keepsOldBuffer)
+{
+    Clipboard clipboard;
+    clipboard.open(0);
+    clipboard.add(Clipboard::kText, "test string!");
+    clipboard.close();
+    auto before = clipboard.marshalled();
+    std::string expected = *before;
+
+    clipboard.open(0);
+    clipboard.add(Clipboard::kHTML, "<b>test</b>");
+    clipboard.close();
+    auto after = clipboard.marshalled();
+
+    EXPECT_NE(before, after);
+    EXPECT_EQ(*before, expected);
+    EXPECT_EQ(*after, clipboard.marshall());
+}
+
+TEST(ClipboardTests, copy_sharesData)
+{
+    Clipboard src;
+    src.open(0);
+    src.add_shared(Clipboard::kText, std::make_shared<const std::string>("test string!"));
+    src.close();
+
+    Clipboard dst;
+    Clipboard::copy(&dst, &src);
+
+    src.open(0);
+    dst.open(0);
+    EXPECT_EQ(dst.get_shared(Clipboard::kText), src.get_shared(Clipboard::kText));
+    EXPECT_EQ(dst.get(Clipboard::kText), "test string!");
+    EXPECT_EQ(dst.get_hash(Clipboard::kText), src.get_hash(Clipboard::kText));
+    dst.close();
+    src.close();
+}
+
+TEST(ClipboardTests, getShared_noData_returnsEmpty)
+{
+    Clipboard clipboard;
+    clipboard.open(0);
+
+    auto data = clipboard.get_shared(Clipboard::kHTML);
+
+    ASSERT_NE(data, nullptr);
+    EXPECT_TRUE(data->empty());
+    clipboard.close();
+}
+
+TEST(ClipboardTests, formats_withTextAndHtml_listsFormatsAndSizes)
+{
+    Clipboard clipboard;
+    clipboard.open(0);
+    clipboard.add(Clipboard::kHTML, "<b>test</b>");
+    clipboard.add(Clipboard::kText, "test string!");
+    clipboard.close();
+
+    IClipboard::FormatList formats = clipboard.formats();
+
+    ASSERT_EQ(formats.size(), 2u);
+    EXPECT_EQ(formats[0].format, IClipboard::kText);
+    EXPECT_EQ(formats[0].size, 12u);
+    EXPECT_EQ(formats[1].format, IClipboard::kHTML);
+    EXPECT_EQ(formats[1].size, 11u);
+}
+
 } // namespace inputleap
@@ -0,0 +1,274 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/FileReceiver.h"
+#include "inputleap/ChunkCodec.h"
+#include "inputleap/DropHelper.h"
+#include "inputleap/FileChunk.h"
+#include "inputleap/protocol_types.h"
+#include "test/mock/io/MockStream.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace inputleap;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace {
+
+// a stream that reads back what was written to it
+class LoopbackStream {
+public:
+    LoopbackStream()
+    {
+        ON_CALL(stream, write(_, _)).WillByDefault(Invoke(
+            [this](const void* data, std::uint32_t size) {
+                buffer_.append(static_cast<const char*>(data), size);
+            }));
+        ON_CALL(stream, read(_, _)).WillByDefault(Invoke(
+            [this](void* data, std::uint32_t size) {
+                std::uint32_t n = std::min<std::uint32_t>(size, buffer_.size());
+                std::memcpy(data, buffer_.data(), n);
+                buffer_.erase(0, n);
+                return n;
+            }));
+    }
+
+    // send a chunk and feed the message body to the receiver
+    int deliver(FileReceiver& receiver, const FileChunk& chunk)
+    {
+        chunk.send(&stream);
+        buffer_.erase(0, 4);
+        return receiver.receive(&stream);
+    }
+
+    NiceMock<MockStream> stream;
+
+private:
+    std::string buffer_;
+};
+
+fs::path test_dir(const char* name)
+{
+    auto dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+std::string read_file(const fs::path& path)
+{
+    std::ifstream in;
+    open_utf8_path(in, path, std::ios::in | std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+bool is_empty_dir(const fs::path& dir)
+{
+    return fs::directory_iterator(dir) == fs::directory_iterator();
+}
+
+} // namespace
+
+TEST(FileReceiverTests, receive_writesFileToDisk)
+{
+    auto dir = test_dir("inputleap_file_receiver_whole");
+    LoopbackStream loopback;
+    FileReceiver receiver(dir);
+    std::string part1(40000, 'a');
+    std::string part2 = "tail";
+
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::start(part1.size() + part2.size())), kStart);
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::data(
+                  reinterpret_cast<const std::uint8_t*>(part1.data()), part1.size())), kNotFinish);
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::data(
+                  reinterpret_cast<const std::uint8_t*>(part2.data()), part2.size())), kNotFinish);
+    EXPECT_EQ(receiver.received_size(), part1.size() + part2.size());
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::end()), kFinish);
+    EXPECT_TRUE(receiver.is_complete());
+
+    fs::path received = receiver.take_file();
+    EXPECT_EQ(received.parent_path(), dir);
+    EXPECT_EQ(read_file(received), part1 + part2);
+    EXPECT_TRUE(receiver.take_file().empty());
+
+    fs::remove_all(dir);
+}
+
+TEST(FileReceiverTests, receive_incomplete_removesFile)
+{
+    auto dir = test_dir("inputleap_file_receiver_incomplete");
+    LoopbackStream loopback;
+    FileReceiver receiver(dir);
+    std::string part(50, 'b');
+
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::start(100)), kStart);
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::data(
+                  reinterpret_cast<const std::uint8_t*>(part.data()), part.size())), kNotFinish);
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::end()), kError);
+
+    EXPECT_FALSE(receiver.is_complete());
+    EXPECT_TRUE(receiver.take_file().empty());
+    EXPECT_TRUE(is_empty_dir(dir));
+
+    // chunks without a start are rejected
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::data(
+                  reinterpret_cast<const std::uint8_t*>(part.data()), part.size())), kError);
+
+    fs::remove_all(dir);
+}
+
+TEST(FileReceiverTests, receive_pastAnnouncedSize_failsAtOnce)
+{
+    auto dir = test_dir("inputleap_file_receiver_oversized");
+    LoopbackStream loopback;
+    FileReceiver receiver(dir);
+    std::string part(60, 'c');
+
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::start(100)), kStart);
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::data(
+                  reinterpret_cast<const std::uint8_t*>(part.data()), part.size())), kNotFinish);
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::data(
+                  reinterpret_cast<const std::uint8_t*>(part.data()), part.size())), kError);
+
+    EXPECT_EQ(receiver.received_size(), part.size());
+    EXPECT_TRUE(is_empty_dir(dir));
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::end()), kError);
+    EXPECT_FALSE(receiver.is_complete());
+
+    fs::remove_all(dir);
+}
+
+TEST(FileReceiverTests, destructor_removesUntakenFile)
+{
+    auto dir = test_dir("inputleap_file_receiver_untaken");
+    {
+        LoopbackStream loopback;
+        FileReceiver receiver(dir);
+        loopback.deliver(receiver, FileChunk::start(0));
+        EXPECT_EQ(loopback.deliver(receiver, FileChunk::end()), kFinish);
+        EXPECT_FALSE(is_empty_dir(dir));
+    }
+    EXPECT_TRUE(is_empty_dir(dir));
+
+    fs::remove_all(dir);
+}
+
+TEST(FileReceiverTests, receive_decompressesChunks)
+{
+    auto codecs = supported_chunk_codecs();
+    if (codecs.empty()) {
+        GTEST_SKIP() << "built without compression";
+    }
+
+    auto dir = test_dir("inputleap_file_receiver_compressed");
+    LoopbackStream loopback;
+    FileReceiver receiver(dir);
+    std::string content(10000, 'z');
+    ChunkCompressor compressor(static_cast<ChunkCodec>(codecs.front()));
+    std::string payload;
+    ASSERT_TRUE(compressor.compress(reinterpret_cast<const std::uint8_t*>(content.data()),
+                                    content.size(), payload));
+
+    loopback.deliver(receiver, FileChunk::start(content.size()));
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::compressed(
+                  reinterpret_cast<const std::uint8_t*>(payload.data()), payload.size())),
+              kNotFinish);
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::end()), kFinish);
+    EXPECT_EQ(read_file(receiver.take_file()), content);
+
+    // a corrupt chunk fails the transfer
+    loopback.deliver(receiver, FileChunk::start(content.size()));
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::compressed(
+                  reinterpret_cast<const std::uint8_t*>(payload.data()), payload.size() / 2)),
+              kError);
+    EXPECT_FALSE(receiver.is_complete());
+    EXPECT_TRUE(receiver.take_file().empty());
+
+    fs::remove_all(dir);
+}
+
+TEST(FileReceiverTests, setDirectory_receivesNextFileThere)
+{
+    auto dir = test_dir("inputleap_file_receiver_first");
+    auto drop_dir = test_dir("inputleap_file_receiver_second");
+    LoopbackStream loopback;
+    FileReceiver receiver(dir);
+    std::string content = "dropped";
+
+    receiver.set_directory(drop_dir);
+    loopback.deliver(receiver, FileChunk::start(content.size()));
+    loopback.deliver(receiver, FileChunk::data(
+                         reinterpret_cast<const std::uint8_t*>(content.data()), content.size()));
+    EXPECT_EQ(loopback.deliver(receiver, FileChunk::end()), kFinish);
+
+    fs::path received = receiver.take_file();
+    EXPECT_EQ(received.parent_path(), drop_dir);
+    EXPECT_TRUE(is_empty_dir(dir));
+
+    // the drop only renames the file
+    DragFileList files(1);
+    std::string name = "dropped.txt";
+    files[0].setFilename(name);
+    DropHelper::writeToDir(drop_dir.u8string(), files, {received});
+    EXPECT_EQ(read_file(drop_dir / "dropped.txt"), content);
+    EXPECT_EQ(std::distance(fs::directory_iterator(drop_dir), fs::directory_iterator()), 1);
+
+    fs::remove_all(dir);
+    fs::remove_all(drop_dir);
+}
+
+TEST(FileReceiverTests, writeToDir_movesReceivedFiles)
+{
+    auto dir = test_dir("inputleap_file_receiver_drop");
+    LoopbackStream loopback;
+    FileReceiver receiver(dir);
+    std::vector<std::string> contents = {"dropped", "also dropped"};
+
+    std::vector<fs::path> received;
+    for (const auto& content : contents) {
+        loopback.deliver(receiver, FileChunk::start(content.size()));
+        loopback.deliver(receiver, FileChunk::data(
+                             reinterpret_cast<const std::uint8_t*>(content.data()), content.size()));
+        loopback.deliver(receiver, FileChunk::end());
+        received.push_back(receiver.take_file());
+    }
+
+    DragFileList files(2);
+    std::string first = "dropped.txt";
+    std::string second = "also dropped.txt";
+    files[0].setFilename(first);
+    files[1].setFilename(second);
+    DropHelper::writeToDir(dir.u8string(), files, received);
+
+    EXPECT_FALSE(fs::exists(received[0]));
+    EXPECT_FALSE(fs::exists(received[1]));
+    EXPECT_EQ(read_file(dir / "dropped.txt"), contents[0]);
+    EXPECT_EQ(read_file(dir / "also dropped.txt"), contents[1]);
+    EXPECT_TRUE(files.empty());
+
+    fs::remove_all(dir);
+}
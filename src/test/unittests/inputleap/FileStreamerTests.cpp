@@ -0,0 +1,324 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/FileStreamer.h"
+#include "inputleap/protocol_types.h"
+#include "test/mock/inputleap/MockEventQueue.h"
+#include "test/mock/io/MockStream.h"
+#include "io/filesystem.h"
+#include "base/Event.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace inputleap;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace {
+
+struct SentChunk {
+    std::uint8_t mark;
+    std::string data;
+};
+
+// a stream whose output buffer fills with every chunk until flushed
+class StreamerHarness {
+public:
+    StreamerHarness()
+    {
+        ON_CALL(queue, add_event(_)).WillByDefault(Invoke([](Event&& event) {
+            Event::deleteData(event);
+        }));
+        ON_CALL(stream, getOutputSize()).WillByDefault(Invoke([this]() { return pending_; }));
+        streamer = std::make_unique<FileStreamer>(&queue, &stream,
+            [this](const FileChunk& chunk) {
+                chunks.push_back(SentChunk{chunk.mark_,
+                    std::string(reinterpret_cast<const char*>(chunk.payload()),
+                                chunk.payload_size())});
+                pending_ += FILE_CHUNK_META_SIZE + chunk.payload_size();
+            });
+    }
+
+    // pump until the stream is full or the file is sent
+    void pump_until_blocked()
+    {
+        while (streamer->is_sending() && pending_ < FileStreamer::kMaxPendingOutput) {
+            streamer->pump();
+            std::this_thread::yield();
+        }
+    }
+
+    void flush() { pending_ = 0; }
+
+    std::uint32_t pending() const { return pending_; }
+
+    NiceMock<MockEventQueue> queue;
+    NiceMock<MockStream> stream;
+    std::unique_ptr<FileStreamer> streamer;
+    std::vector<SentChunk> chunks;
+
+private:
+    std::uint32_t pending_ = 0;
+};
+
+std::string write_file(const char* name, std::size_t size)
+{
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<char>(i * 7 + i / 251);
+    }
+
+    auto path = fs::temp_directory_path() / name;
+    std::ofstream out;
+    open_utf8_path(out, path, std::ios::out | std::ios::binary);
+    out.write(data.data(), data.size());
+    return data;
+}
+
+std::string temp_file(const char* name)
+{
+    return (fs::temp_directory_path() / name).u8string();
+}
+
+} // namespace
+
+TEST(FileStreamerTests, send_chunksWholeFile)
+{
+    StreamerHarness harness;
+    const std::size_t size = 3 * FileStreamer::kChunkSize + 123;
+    std::string data = write_file("inputleap_file_streamer_whole.bin", size);
+
+    ASSERT_TRUE(harness.streamer->send({temp_file("inputleap_file_streamer_whole.bin")}));
+    while (harness.streamer->is_sending()) {
+        harness.pump_until_blocked();
+        harness.flush();
+    }
+
+    ASSERT_EQ(harness.chunks.size(), 6u);
+    EXPECT_EQ(harness.chunks.front().mark, kDataStart);
+    EXPECT_EQ(harness.chunks.front().data, std::to_string(size));
+    std::string received;
+    for (std::size_t i = 1; i + 1 < harness.chunks.size(); ++i) {
+        EXPECT_EQ(harness.chunks[i].mark, kDataChunk);
+        EXPECT_LE(harness.chunks[i].data.size(), FileStreamer::kChunkSize);
+        received += harness.chunks[i].data;
+    }
+    EXPECT_EQ(received, data);
+    EXPECT_EQ(harness.chunks.back().mark, kDataEnd);
+
+    fs::remove(temp_file("inputleap_file_streamer_whole.bin"));
+}
+
+TEST(FileStreamerTests, send_waitsForFlush)
+{
+    StreamerHarness harness;
+    const std::size_t size = 16 * FileStreamer::kChunkSize;
+    write_file("inputleap_file_streamer_flush.bin", size);
+
+    ASSERT_TRUE(harness.streamer->send({temp_file("inputleap_file_streamer_flush.bin")}));
+    harness.pump_until_blocked();
+
+    // start and two chunks fill the output buffer
+    EXPECT_EQ(harness.chunks.size(), 3u);
+    EXPECT_LT(harness.pending(), FileStreamer::kMaxPendingOutput + FileStreamer::kChunkSize +
+                                 FILE_CHUNK_META_SIZE);
+    harness.streamer->pump();
+    EXPECT_EQ(harness.chunks.size(), 3u);
+    EXPECT_EQ(harness.streamer->progress().sent, 2 * FileStreamer::kChunkSize);
+    EXPECT_EQ(harness.streamer->progress().size, size);
+
+    while (harness.streamer->is_sending()) {
+        harness.flush();
+        harness.pump_until_blocked();
+    }
+    EXPECT_EQ(harness.chunks.size(), 18u);
+    EXPECT_EQ(harness.chunks.back().mark, kDataEnd);
+
+    fs::remove(temp_file("inputleap_file_streamer_flush.bin"));
+}
+
+TEST(FileStreamerTests, cancel_sendsEnd)
+{
+    StreamerHarness harness;
+    write_file("inputleap_file_streamer_cancel.bin", 16 * FileStreamer::kChunkSize);
+
+    ASSERT_TRUE(harness.streamer->send({temp_file("inputleap_file_streamer_cancel.bin")}));
+    harness.pump_until_blocked();
+    harness.streamer->cancel();
+
+    EXPECT_FALSE(harness.streamer->is_sending());
+    EXPECT_EQ(harness.chunks.back().mark, kDataEnd);
+    EXPECT_EQ(harness.streamer->progress().size, 0u);
+
+    // cancelling again does nothing
+    std::size_t count = harness.chunks.size();
+    harness.streamer->cancel();
+    EXPECT_EQ(harness.chunks.size(), count);
+
+    fs::remove(temp_file("inputleap_file_streamer_cancel.bin"));
+}
+
+TEST(FileStreamerTests, send_emptyOrMissingFile)
+{
+    StreamerHarness harness;
+    write_file("inputleap_file_streamer_empty.bin", 0);
+
+    ASSERT_TRUE(harness.streamer->send({temp_file("inputleap_file_streamer_empty.bin")}));
+    harness.pump_until_blocked();
+
+    ASSERT_EQ(harness.chunks.size(), 2u);
+    EXPECT_EQ(harness.chunks[0].data, "0");
+    EXPECT_EQ(harness.chunks[1].mark, kDataEnd);
+
+    EXPECT_FALSE(harness.streamer->send({temp_file("inputleap_file_streamer_missing.bin")}));
+    EXPECT_FALSE(harness.streamer->is_sending());
+
+    fs::remove(temp_file("inputleap_file_streamer_empty.bin"));
+}
+
+TEST(FileStreamerTests, send_multipleFilesInOrder)
+{
+    StreamerHarness harness;
+    std::string first = write_file("inputleap_file_streamer_first.bin", 2 * FileStreamer::kChunkSize);
+    std::string second = write_file("inputleap_file_streamer_second.bin", 100);
+    std::string third = write_file("inputleap_file_streamer_third.bin", 0);
+
+    ASSERT_TRUE(harness.streamer->send({temp_file("inputleap_file_streamer_first.bin"),
+                                        temp_file("inputleap_file_streamer_missing.bin"),
+                                        temp_file("inputleap_file_streamer_second.bin"),
+                                        temp_file("inputleap_file_streamer_third.bin")}));
+    EXPECT_EQ(harness.streamer->progress().file_count, 3u);
+    EXPECT_EQ(harness.streamer->progress().size, first.size() + second.size());
+
+    while (harness.streamer->is_sending()) {
+        harness.pump_until_blocked();
+        harness.flush();
+    }
+
+    // one start, data, end sequence per file that exists
+    std::vector<std::string> received;
+    for (const auto& chunk : harness.chunks) {
+        if (chunk.mark == kDataStart) {
+            received.emplace_back();
+        } else if (chunk.mark == kDataChunk) {
+            received.back() += chunk.data;
+        }
+    }
+    ASSERT_EQ(received.size(), 3u);
+    EXPECT_EQ(received[0], first);
+    EXPECT_EQ(received[1], second);
+    EXPECT_EQ(received[2], third);
+    EXPECT_EQ(harness.chunks.back().mark, kDataEnd);
+
+    fs::remove(temp_file("inputleap_file_streamer_first.bin"));
+    fs::remove(temp_file("inputleap_file_streamer_second.bin"));
+    fs::remove(temp_file("inputleap_file_streamer_third.bin"));
+}
+
+TEST(FileStreamerTests, cancel_dropsQueuedFiles)
+{
+    StreamerHarness harness;
+    write_file("inputleap_file_streamer_current.bin", 16 * FileStreamer::kChunkSize);
+    write_file("inputleap_file_streamer_queued.bin", 16 * FileStreamer::kChunkSize);
+
+    ASSERT_TRUE(harness.streamer->send({temp_file("inputleap_file_streamer_current.bin"),
+                                        temp_file("inputleap_file_streamer_queued.bin")}));
+    harness.pump_until_blocked();
+    EXPECT_EQ(harness.streamer->progress().files_sent, 0u);
+    harness.streamer->cancel();
+
+    EXPECT_FALSE(harness.streamer->is_sending());
+    std::size_t starts = 0;
+    for (const auto& chunk : harness.chunks) {
+        starts += chunk.mark == kDataStart;
+    }
+    EXPECT_EQ(starts, 1u);
+    EXPECT_EQ(harness.chunks.back().mark, kDataEnd);
+
+    // the buffers are reused for the next files
+    harness.flush();
+    ASSERT_TRUE(harness.streamer->send({temp_file("inputleap_file_streamer_queued.bin")}));
+    while (harness.streamer->is_sending()) {
+        harness.pump_until_blocked();
+        harness.flush();
+    }
+    EXPECT_EQ(harness.chunks.back().mark, kDataEnd);
+
+    fs::remove(temp_file("inputleap_file_streamer_current.bin"));
+    fs::remove(temp_file("inputleap_file_streamer_queued.bin"));
+}
+
+TEST(FileStreamerTests, send_withCodec_compressesAllButImages)
+{
+    auto codecs = supported_chunk_codecs();
+    if (codecs.empty()) {
+        GTEST_SKIP() << "built without compression";
+    }
+
+    std::string text;
+    while (text.size() < 3 * FileStreamer::kChunkSize) {
+        text += "some file text that compresses well\n";
+    }
+    std::string png("\x89PNG\r\n\x1a\n", 8);
+    png.resize(2 * FileStreamer::kChunkSize, 'p');
+    for (const auto& file : {std::make_pair("inputleap_file_streamer_text.txt", &text),
+                             std::make_pair("inputleap_file_streamer_image.png", &png)}) {
+        std::ofstream out;
+        open_utf8_path(out, fs::temp_directory_path() / file.first,
+                       std::ios::out | std::ios::binary);
+        out.write(file.second->data(), file.second->size());
+    }
+
+    StreamerHarness harness;
+    harness.streamer->set_codec(static_cast<ChunkCodec>(codecs.front()));
+    ASSERT_TRUE(harness.streamer->send({temp_file("inputleap_file_streamer_text.txt"),
+                                        temp_file("inputleap_file_streamer_image.png")}));
+    while (harness.streamer->is_sending()) {
+        harness.pump_until_blocked();
+        harness.flush();
+    }
+
+    std::vector<std::string> received;
+    std::vector<std::size_t> compressed;
+    for (const auto& chunk : harness.chunks) {
+        if (chunk.mark == kDataStart) {
+            received.emplace_back();
+            compressed.push_back(0);
+        } else if (chunk.mark == kDataChunk) {
+            received.back() += chunk.data;
+        } else if (chunk.mark == kDataCompressed) {
+            ASSERT_TRUE(decompress_chunk(reinterpret_cast<const std::uint8_t*>(chunk.data.data()),
+                                         chunk.data.size(), received.back()));
+            ++compressed.back();
+        }
+    }
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0], text);
+    EXPECT_EQ(received[1], png);
+    EXPECT_EQ(compressed[0], 3u);
+    EXPECT_EQ(compressed[1], 0u);
+
+    fs::remove(temp_file("inputleap_file_streamer_text.txt"));
+    fs::remove(temp_file("inputleap_file_streamer_image.png"));
+}
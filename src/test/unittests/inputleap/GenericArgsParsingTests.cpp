@@ -77,6 +77,58 @@ TEST(GenericArgsParsingTests, parseGenericArgs_logFileCmd_saveLogFilename)
     EXPECT_EQ(a.size(), 0); // all args consumed
 }
 
+TEST(GenericArgsParsingTests, parseGenericArgs_asyncLogCmd_enableAsyncLog)
+{
+    const int argc = 2;
+    const char* kAsyncLogCmd[argc] = { "stub", "--async-log" };
+    Argv a(argc, kAsyncLogCmd);
+
+    ArgParser argParser(nullptr);
+    ArgsBase argsBase;
+    argParser.setArgsBase(argsBase);
+
+    argParser.parseGenericArgs(a);
+
+    EXPECT_TRUE(argsBase.m_asyncLog);
+    EXPECT_EQ(a.size(), 0); // all args consumed
+}
+
+TEST(GenericArgsParsingTests, parseGenericArgs_binaryLogCmd_saveBinaryLogFilename)
+{
+    const int argc = 3;
+    const char* kBinaryLogCmd[argc] = { "stub", "--binary-log", "mock_filename" };
+    Argv a(argc, kBinaryLogCmd);
+
+    ArgParser argParser(nullptr);
+    ArgsBase argsBase;
+    argParser.setArgsBase(argsBase);
+
+    argParser.parseGenericArgs(a);
+
+    std::string binaryLogFile = argsBase.m_binaryLogFile;
+
+    EXPECT_EQ("mock_filename", binaryLogFile);
+    EXPECT_EQ(a.size(), 0); // all args consumed
+}
+
+TEST(GenericArgsParsingTests, parseGenericArgs_logCategoryCmd_saveLogCategories)
+{
+    const int argc = 3;
+    const char* kLogCategoryCmd[argc] = { "stub", "--log-category", "net=DEBUG2" };
+    Argv a(argc, kLogCategoryCmd);
+
+    ArgParser argParser(nullptr);
+    ArgsBase argsBase;
+    argParser.setArgsBase(argsBase);
+
+    argParser.parseGenericArgs(a);
+
+    std::string logCategories = argsBase.m_logCategories;
+
+    EXPECT_EQ("net=DEBUG2", logCategories);
+    EXPECT_EQ(a.size(), 0); // all args consumed
+}
+
 TEST(GenericArgsParsingTests, parseGenericArgs_logFileCmdWithSpace_saveLogFilename)
 {
     const int argc = 3;
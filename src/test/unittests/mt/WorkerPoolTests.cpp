@@ -0,0 +1,80 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mt/WorkerPool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace inputleap;
+
+TEST(WorkerPoolTests, run_startsAtMostMaxThreads)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool release = false;
+    std::atomic<int> running{0};
+    std::atomic<int> done{0};
+
+    {
+        WorkerPool pool(2);
+        for (int i = 0; i < 5; ++i) {
+            pool.run([&]() {
+                ++running;
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return release; });
+                ++done;
+            });
+        }
+
+        while (running < 2) {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(pool.get_thread_count(), 2u);
+        EXPECT_EQ(running, 2);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            release = true;
+        }
+        cv.notify_all();
+    }
+
+    // the pool finishes the queued jobs before it's destroyed
+    EXPECT_EQ(done, 5);
+}
+
+TEST(WorkerPoolTests, run_reusesIdleThread)
+{
+    WorkerPool pool(4);
+    for (int i = 0; i < 10; ++i) {
+        std::atomic<bool> ran{false};
+        pool.run([&ran]() { ran = true; });
+        while (!ran) {
+            std::this_thread::yield();
+        }
+        // let the thread go back to waiting for jobs
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_LT(pool.get_thread_count(), 4u);
+}
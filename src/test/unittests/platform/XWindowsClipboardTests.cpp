@@ -0,0 +1,316 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// gtest must come first, Xlib defines macros like None and Bool
+#include <gtest/gtest.h>
+
+#include "test/mock/platform/MockXWindowsImpl.h"
+#include "platform/XWindowsClipboard.h"
+#include "base/Log.h"
+#include "base/Stopwatch.h"
+
+#include <X11/Xatom.h>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace inputleap {
+
+using ::testing::_;
+using ::testing::AtMost;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace {
+
+const Window kRequestor = 42;
+const Atom kProperty = 43;
+const Atom kTarget = 44;
+const Atom kAtomNone = 45;
+const Atom kAtomIncr = 46;
+const Atom kAtomMultiple = 47;
+const Atom kAtomAtomPair = 48;
+
+XEvent selection_notify(Window requestor, Atom property, Atom target = kTarget)
+{
+    XEvent event = {};
+    event.xselection.type      = SelectionNotify;
+    event.xselection.requestor = requestor;
+    event.xselection.target    = target;
+    event.xselection.property  = property;
+    return event;
+}
+
+XEvent property_notify(Window window, Atom property)
+{
+    XEvent event = {};
+    event.xproperty.type   = PropertyNotify;
+    event.xproperty.window = window;
+    event.xproperty.atom   = property;
+    event.xproperty.state  = PropertyNewValue;
+    return event;
+}
+
+XEvent destroy_notify(Window window)
+{
+    XEvent event = {};
+    event.xdestroywindow.type   = DestroyNotify;
+    event.xdestroywindow.window = window;
+    return event;
+}
+
+} // namespace
+
+class XWindowsClipboardTests : public ::testing::Test {
+protected:
+    using Getter = XWindowsClipboard::CICCCMGetClipboard;
+
+    void SetUp() override
+    {
+        ASSERT_EQ(pipe2(connection_, O_NONBLOCK), 0);
+
+        // the log would look up atom names on a real display
+        CLOG->set_category_filter(LogCategory::CLIPBOARD, kINFO);
+
+        ON_CALL(impl_, XInternAtom(_, _, _))
+                .WillByDefault(Invoke([](Display*, const char* name, Bool) {
+            if (std::strcmp(name, "INCR") == 0) {
+                return kAtomIncr;
+            }
+            if (std::strcmp(name, "MULTIPLE") == 0) {
+                return kAtomMultiple;
+            }
+            if (std::strcmp(name, "ATOM_PAIR") == 0) {
+                return kAtomAtomPair;
+            }
+            return kAtomNone;
+        }));
+        ON_CALL(impl_, XGetWindowAttributes(_, _, _))
+                .WillByDefault(Invoke([](Display*, Window, XWindowAttributes* attr) {
+            *attr = XWindowAttributes();
+            return 1;
+        }));
+        ON_CALL(impl_, XConnectionNumber(_)).WillByDefault(Return(connection_[0]));
+        ON_CALL(impl_, XPending(_)).WillByDefault(Invoke([this](Display*) {
+            return read_connection();
+        }));
+        ON_CALL(impl_, XEventsQueued(_, _)).WillByDefault(Invoke([this](Display*, int) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return static_cast<int>(queued_.size());
+        }));
+        ON_CALL(impl_, XNextEvent(_, _)).WillByDefault(Invoke([this](Display*, XEvent* event) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            *event = queued_.front();
+            queued_.pop_front();
+            return 0;
+        }));
+    }
+
+    void TearDown() override
+    {
+        if (server_.joinable()) {
+            server_.join();
+        }
+        close(connection_[0]);
+        close(connection_[1]);
+        CLOG->clear_category_filter(LogCategory::CLIPBOARD);
+    }
+
+    // the X server sends \p event after \p delay seconds
+    void send(const XEvent& event, double delay = 0.0)
+    {
+        auto deliver = [this, event]() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sent_.push_back(event);
+            EXPECT_EQ(write(connection_[1], "x", 1), 1);
+        };
+        if (delay <= 0.0) {
+            deliver();
+        } else {
+            server_ = std::thread([deliver, delay]() {
+                std::this_thread::sleep_for(std::chrono::duration<double>(delay));
+                deliver();
+            });
+        }
+    }
+
+    // like XPending():  reads what arrived on the connection
+    int read_connection()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        char buffer[16];
+        while (read(connection_[0], buffer, sizeof(buffer)) > 0) {
+        }
+        queued_.insert(queued_.end(), sent_.begin(), sent_.end());
+        sent_.clear();
+        return static_cast<int>(queued_.size());
+    }
+
+    bool read_clipboard(Getter& getter)
+    {
+        return getter.readClipboard(display_, XA_PRIMARY, kTarget, &actual_target_, &data_);
+    }
+
+    NiceMock<MockXWindowsImpl> impl_;
+    Display* display_ = nullptr;
+    int connection_[2] = { -1, -1 };
+    std::thread server_;
+
+    std::mutex mutex_;
+    std::deque<XEvent> sent_;
+    std::deque<XEvent> queued_;
+
+    Atom actual_target_ = None;
+    std::string data_;
+};
+
+TEST_F(XWindowsClipboardTests, readClipboard_ownerReplies_wakesUpWithoutPolling)
+{
+    EXPECT_CALL(impl_, XConvertSelection(display_, XA_PRIMARY, kTarget, kProperty,
+                                         kRequestor, CurrentTime));
+    EXPECT_CALL(impl_, XPending(_)).Times(AtMost(3));
+    send(selection_notify(kRequestor, None), 0.05);
+
+    Getter getter(&impl_, kRequestor, CurrentTime, kProperty);
+    Stopwatch stopwatch;
+    EXPECT_TRUE(read_clipboard(getter));
+
+    EXPECT_LT(stopwatch.getTime(), Getter::kTimeout);
+    EXPECT_EQ(actual_target_, None);
+    EXPECT_FALSE(getter.m_error);
+}
+
+TEST_F(XWindowsClipboardTests, readClipboard_ownerNeverReplies_failsAtDeadline)
+{
+    EXPECT_CALL(impl_, XPending(_)).Times(AtMost(3));
+
+    Getter getter(&impl_, kRequestor, CurrentTime, kProperty);
+    Stopwatch stopwatch;
+    EXPECT_FALSE(read_clipboard(getter));
+
+    double elapsed = stopwatch.getTime();
+    EXPECT_GE(elapsed, Getter::kTimeout);
+    EXPECT_LT(elapsed, Getter::kTimeout + 0.2);
+}
+
+TEST_F(XWindowsClipboardTests, readClipboard_requestorDestroyed_fails)
+{
+    send(destroy_notify(kRequestor));
+
+    Getter getter(&impl_, kRequestor, CurrentTime, kProperty);
+    EXPECT_FALSE(read_clipboard(getter));
+    EXPECT_FALSE(getter.m_error);
+}
+
+TEST_F(XWindowsClipboardTests, readClipboard_otherEvents_putBackInOrder)
+{
+    send(property_notify(kRequestor + 1, kProperty));
+    send(selection_notify(kRequestor + 2, kProperty));
+    send(selection_notify(kRequestor, kAtomNone));
+
+    std::vector<int> put_back;
+    EXPECT_CALL(impl_, XPutBackEvent(_, _)).Times(2)
+            .WillRepeatedly(Invoke([&put_back](Display*, XEvent* event) {
+        put_back.push_back(event->type);
+        return 0;
+    }));
+
+    Getter getter(&impl_, kRequestor, CurrentTime, kProperty);
+    EXPECT_TRUE(read_clipboard(getter));
+
+    // put back last first so they end up in the original order
+    ASSERT_EQ(put_back.size(), 2u);
+    EXPECT_EQ(put_back[0], SelectionNotify);
+    EXPECT_EQ(put_back[1], PropertyNotify);
+}
+
+TEST_F(XWindowsClipboardTests, readClipboard_eventAlreadyQueued_doesNotWait)
+{
+    // Xlib read the reply while doing something else;  the connection
+    // stays quiet
+    queued_.push_back(selection_notify(kRequestor, None));
+    EXPECT_CALL(impl_, XPending(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(impl_, XConnectionNumber(_)).Times(0);
+
+    Getter getter(&impl_, kRequestor, CurrentTime, kProperty);
+    EXPECT_TRUE(read_clipboard(getter));
+}
+
+TEST_F(XWindowsClipboardTests, readTargets_separately_sendsAllRequestsBeforeWaiting)
+{
+    std::vector<Getter::Conversion> conversions;
+    for (Atom i = 0; i < 3; ++i) {
+        conversions.push_back(Getter::Conversion(kTarget + 10 * i, kProperty + 10 * i));
+    }
+
+    ::testing::Expectation converted =
+            EXPECT_CALL(impl_, XConvertSelection(_, XA_PRIMARY, _, _, kRequestor, CurrentTime))
+                .Times(3);
+    EXPECT_CALL(impl_, XPending(_)).Times(::testing::AtLeast(1)).After(converted);
+
+    // the owner answers in its own order
+    send(selection_notify(kRequestor, None, kTarget + 20));
+    send(selection_notify(kRequestor, None, kTarget));
+    send(selection_notify(kRequestor, None, kTarget + 10));
+
+    Getter getter(&impl_, kRequestor, CurrentTime, kProperty);
+    EXPECT_TRUE(getter.readTargets(display_, XA_PRIMARY, conversions, false));
+
+    for (const auto& conversion : conversions) {
+        EXPECT_TRUE(conversion.m_done);
+        EXPECT_FALSE(conversion.m_failed);
+        EXPECT_EQ(conversion.m_actualTarget, None);
+    }
+}
+
+TEST_F(XWindowsClipboardTests, readTargets_multiple_listsTargetsAndConvertsOnce)
+{
+    std::vector<Getter::Conversion> conversions;
+    conversions.push_back(Getter::Conversion(kTarget, kProperty + 1));
+    conversions.push_back(Getter::Conversion(kTarget + 1, kProperty + 2));
+
+    std::vector<Atom> pairs;
+    EXPECT_CALL(impl_, XChangeProperty(_, kRequestor, kProperty, kAtomAtomPair, 32,
+                                       PropModeReplace, _, 4))
+            .WillOnce(Invoke([&pairs](Display*, Window, Atom, Atom, int, int,
+                                      const unsigned char* data, int count) {
+        const Atom* atoms = reinterpret_cast<const Atom*>(data);
+        pairs.assign(atoms, atoms + count);
+        return 0;
+    }));
+    EXPECT_CALL(impl_, XConvertSelection(_, XA_PRIMARY, kAtomMultiple, kProperty,
+                                         kRequestor, CurrentTime));
+
+    // the owner can't convert MULTIPLE
+    send(selection_notify(kRequestor, None, kAtomMultiple));
+
+    Getter getter(&impl_, kRequestor, CurrentTime, kProperty);
+    EXPECT_TRUE(getter.readTargets(display_, XA_PRIMARY, conversions, true));
+
+    EXPECT_EQ(pairs, (std::vector<Atom>{ kTarget, kProperty + 1, kTarget + 1, kProperty + 2 }));
+
+    // so the caller asks for each target separately
+    EXPECT_TRUE(conversions[0].m_failed);
+    EXPECT_TRUE(conversions[1].m_failed);
+}
+
+} // namespace inputleap
@@ -0,0 +1,157 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// gtest must come first, Xlib defines macros like None and Bool
+#include <gtest/gtest.h>
+
+#include "test/mock/platform/MockXWindowsImpl.h"
+#include "platform/XWindowsEventQueueBuffer.h"
+#include "base/Stopwatch.h"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace inputleap;
+using ::testing::_;
+using ::testing::AtMost;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace {
+
+const Window kWindow = 42;
+const Atom kUserEvent = 43;
+
+} // namespace
+
+class XWindowsEventQueueBufferTests : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(pipe2(connection_, O_NONBLOCK), 0);
+
+        ON_CALL(impl_, XInternAtom(_, _, _)).WillByDefault(Return(kUserEvent));
+        ON_CALL(impl_, XConnectionNumber(_)).WillByDefault(Return(connection_[0]));
+        ON_CALL(impl_, XEventsQueued(_, _)).WillByDefault(Invoke([this](Display*, int mode) {
+            return mode == QueuedAlready ? queued() : read_connection();
+        }));
+        ON_CALL(impl_, XPending(_)).WillByDefault(Invoke([this](Display*) {
+            return read_connection();
+        }));
+        // the server echoes user events straight back
+        ON_CALL(impl_, XSendEvent(_, _, _, _, _))
+                .WillByDefault(Invoke([this](Display*, Window, Bool, long, XEvent* event) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sent_.push_back(*event);
+            return 1;
+        }));
+        // like Xlib, flushing may read the replies into the queue and leave
+        // nothing on the connection to wake a waiter
+        ON_CALL(impl_, XFlush(_)).WillByDefault(Invoke([this](Display*) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queued_.insert(queued_.end(), sent_.begin(), sent_.end());
+            sent_.clear();
+            return 1;
+        }));
+    }
+
+    void TearDown() override
+    {
+        close(connection_[0]);
+        close(connection_[1]);
+    }
+
+    int queued()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<int>(queued_.size());
+    }
+
+    // like XEventsQueued(QueuedAfterReading):  reads what arrived on the
+    // connection
+    int read_connection()
+    {
+        char buffer[16];
+        while (read(connection_[0], buffer, sizeof(buffer)) > 0) {
+        }
+        return queued();
+    }
+
+    NiceMock<MockXWindowsImpl> impl_;
+    int fake_display_ = 0;
+    Display* display_ = reinterpret_cast<Display*>(&fake_display_);
+    int connection_[2] = { -1, -1 };
+
+    std::mutex mutex_;
+    std::deque<XEvent> sent_;
+    std::deque<XEvent> queued_;
+};
+
+TEST_F(XWindowsEventQueueBufferTests, waitForEvent_eventQueued_returnsImmediately)
+{
+    XEvent event = {};
+    event.xany.type = PropertyNotify;
+    queued_.push_back(event);
+
+    XWindowsEventQueueBuffer buffer(&impl_, display_, kWindow, nullptr);
+    Stopwatch stopwatch;
+    buffer.waitForEvent(1.0);
+
+    EXPECT_LT(stopwatch.getTime(), 0.1);
+}
+
+TEST_F(XWindowsEventQueueBufferTests, waitForEvent_idle_sleepsUntilTimeout)
+{
+    // one check before sleeping and one after
+    EXPECT_CALL(impl_, XEventsQueued(_, _)).Times(AtMost(4));
+
+    XWindowsEventQueueBuffer buffer(&impl_, display_, kWindow, nullptr);
+    Stopwatch stopwatch;
+    buffer.waitForEvent(0.2);
+    double elapsed = stopwatch.getTime();
+
+    // the call count shows it slept;  an upper bound on the time would
+    // only measure how loaded the machine is
+    EXPECT_GE(elapsed, 0.2);
+}
+
+TEST_F(XWindowsEventQueueBufferTests, addEvent_fromOtherThread_wakesWaiterAtOnce)
+{
+    // one check before sleeping and one after the wake-up;  polling would
+    // check again and again while the poster sleeps
+    EXPECT_CALL(impl_, XEventsQueued(_, _)).Times(AtMost(4));
+
+    XWindowsEventQueueBuffer buffer(&impl_, display_, kWindow, nullptr);
+
+    Stopwatch stopwatch;
+    std::thread poster([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        buffer.addEvent(7);
+    });
+    buffer.waitForEvent(10.0);
+    double woken = stopwatch.getTime();
+    poster.join();
+
+    // woken by the event rather than the timeout
+    EXPECT_EQ(queued(), 1);
+    EXPECT_LT(woken, 5.0);
+}
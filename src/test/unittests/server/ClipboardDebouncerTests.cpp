@@ -0,0 +1,59 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ClipboardDebouncer.h"
+
+#include <gtest/gtest.h>
+
+using namespace inputleap;
+
+TEST(ClipboardDebouncerTests, immediate_withoutQuietPeriodAndRate)
+{
+    ClipboardDebouncer debouncer;
+    EXPECT_TRUE(debouncer.is_immediate());
+    EXPECT_EQ(debouncer.changed(1.0), 0.0);
+}
+
+TEST(ClipboardDebouncerTests, changed_waitsForQuietPeriod)
+{
+    ClipboardDebouncer debouncer(0.1, 0.0);
+    EXPECT_FALSE(debouncer.is_immediate());
+    EXPECT_NEAR(debouncer.changed(1.0), 0.1, 1e-9);
+    EXPECT_TRUE(debouncer.is_pending());
+
+    // every change restarts the quiet period
+    debouncer.changed(1.05);
+    EXPECT_NEAR(debouncer.remaining(1.1), 0.05, 1e-9);
+    EXPECT_EQ(debouncer.remaining(1.16), 0.0);
+
+    debouncer.updated(1.16);
+    EXPECT_FALSE(debouncer.is_pending());
+}
+
+TEST(ClipboardDebouncerTests, changed_limitsUpdateRate)
+{
+    ClipboardDebouncer debouncer(0.1, 2.0);
+
+    // the first update only waits for the quiet period
+    EXPECT_NEAR(debouncer.changed(1.0), 0.1, 1e-9);
+    debouncer.updated(1.1);
+
+    // the next one no sooner than half a second after it
+    EXPECT_NEAR(debouncer.changed(1.2), 0.4, 1e-9);
+    EXPECT_NEAR(debouncer.remaining(1.5), 0.1, 1e-9);
+    EXPECT_EQ(debouncer.remaining(1.61), 0.0);
+}
@@ -0,0 +1,259 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "test/mock/server/MockPrimaryClient.h"
+#include "test/mock/inputleap/MockEventQueue.h"
+#include "server/InputFilter.h"
+#include "server/Server.h"
+#include "base/Event.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace inputleap;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace {
+
+// records which rules performed which actions
+class RecordingAction : public InputFilter::Action {
+public:
+    RecordingAction(std::vector<std::string>* log, const std::string& name) :
+        log_(log), name_(name) { }
+
+    Action* clone() const override { return new RecordingAction(log_, name_); }
+    std::string format() const override { return name_; }
+    void perform(IEventQueue*, const Event&) override { log_->push_back(name_); }
+
+private:
+    std::vector<std::string>* log_;
+    std::string name_;
+};
+
+// a primary client and event queue that hand out hot key ids and let
+// the test deliver events to the filter's handlers
+class FilterHarness {
+public:
+    FilterHarness()
+    {
+        ON_CALL(client, registerHotKey(_, _)).WillByDefault(Invoke(
+            [this](KeyID key, KeyModifierMask mask) {
+                std::uint32_t id = next_id_++;
+                hot_keys_[std::make_pair(key, mask)] = id;
+                return id;
+            }));
+        ON_CALL(queue, add_handler(_, _, _)).WillByDefault(Invoke(
+            [this](EventType type, const EventTarget*, const IEventQueue::EventHandler& handler) {
+                handlers_[type] = handler;
+            }));
+        ON_CALL(queue, add_event(_)).WillByDefault(Invoke(
+            [this](Event&& event) {
+                ++passed_;
+                Event::deleteData(event);
+            }));
+    }
+
+    std::uint32_t hot_key(KeyID key, KeyModifierMask mask) const
+    {
+        return hot_keys_.at(std::make_pair(key, mask));
+    }
+
+    void deliver(EventType type, EventDataBase* data)
+    {
+        Event event(type, &client, data);
+        handlers_.at(type)(event);
+        Event::deleteData(event);
+    }
+
+    void press_hot_key(std::uint32_t id)
+    {
+        deliver(EventType::PRIMARY_SCREEN_HOTKEY_DOWN,
+                create_event_data<IPlatformScreen::HotKeyInfo>(IPlatformScreen::HotKeyInfo{id}));
+    }
+
+    void press_button(ButtonID button, KeyModifierMask mask)
+    {
+        deliver(EventType::PRIMARY_SCREEN_BUTTON_DOWN,
+                create_event_data<IPlatformScreen::ButtonInfo>(
+                    IPlatformScreen::ButtonInfo{button, mask}));
+    }
+
+    NiceMock<MockPrimaryClient> client;
+    NiceMock<MockEventQueue> queue;
+    int passed_ = 0;
+
+private:
+    std::uint32_t next_id_ = 1;
+    std::map<std::pair<KeyID, KeyModifierMask>, std::uint32_t> hot_keys_;
+    std::map<EventType, IEventQueue::EventHandler> handlers_;
+};
+
+InputFilter::Rule make_rule(InputFilter::Condition* condition,
+                            std::vector<std::string>* log, const std::string& name)
+{
+    InputFilter::Rule rule(condition);
+    rule.adoptAction(new RecordingAction(log, name), true);
+    return rule;
+}
+
+} // namespace
+
+TEST(InputFilterTests, keystroke_runs_matching_rule_only)
+{
+    FilterHarness harness;
+    std::vector<std::string> log;
+    InputFilter filter(&harness.queue);
+    filter.addFilterRule(make_rule(new InputFilter::KeystrokeCondition('a', KeyModifierControl),
+                                   &log, "ctrl-a"));
+    filter.addFilterRule(make_rule(new InputFilter::KeystrokeCondition('b', KeyModifierControl),
+                                   &log, "ctrl-b"));
+    filter.setPrimaryClient(&harness.client);
+
+    harness.press_hot_key(harness.hot_key('b', KeyModifierControl));
+    harness.press_hot_key(harness.hot_key('a', KeyModifierControl));
+    harness.press_hot_key(1000);
+
+    EXPECT_EQ(log, (std::vector<std::string>{"ctrl-b", "ctrl-a"}));
+    EXPECT_EQ(harness.passed_, 1);
+
+    filter.setPrimaryClient(nullptr);
+}
+
+TEST(InputFilterTests, rules_added_while_enabled_are_indexed)
+{
+    FilterHarness harness;
+    std::vector<std::string> log;
+    InputFilter filter(&harness.queue);
+    filter.setPrimaryClient(&harness.client);
+    filter.addFilterRule(make_rule(new InputFilter::KeystrokeCondition('x', KeyModifierAlt),
+                                   &log, "alt-x"));
+
+    harness.press_hot_key(harness.hot_key('x', KeyModifierAlt));
+    EXPECT_EQ(log, std::vector<std::string>{"alt-x"});
+
+    filter.setPrimaryClient(nullptr);
+}
+
+TEST(InputFilterTests, button_ignores_lock_modifiers)
+{
+    FilterHarness harness;
+    std::vector<std::string> log;
+    InputFilter filter(&harness.queue);
+    filter.addFilterRule(make_rule(new InputFilter::MouseButtonCondition(kButtonLeft,
+                                                                         KeyModifierShift),
+                                   &log, "shift-left"));
+    filter.setPrimaryClient(&harness.client);
+
+    harness.press_button(kButtonLeft, KeyModifierShift | KeyModifierNumLock);
+    harness.press_button(kButtonLeft, 0);
+    harness.press_button(kButtonRight, KeyModifierShift);
+
+    EXPECT_EQ(log, std::vector<std::string>{"shift-left"});
+    EXPECT_EQ(harness.passed_, 2);
+
+    filter.setPrimaryClient(nullptr);
+}
+
+TEST(InputFilterTests, first_matching_rule_wins_across_condition_kinds)
+{
+    FilterHarness harness;
+    std::vector<std::string> log;
+    InputFilter filter(&harness.queue);
+    filter.addFilterRule(make_rule(new InputFilter::ScreenConnectedCondition(""),
+                                   &log, "connected"));
+    filter.addFilterRule(make_rule(new InputFilter::MouseButtonCondition(kButtonMiddle, 0),
+                                   &log, "middle-1"));
+    filter.addFilterRule(make_rule(new InputFilter::MouseButtonCondition(kButtonMiddle, 0),
+                                   &log, "middle-2"));
+    filter.setPrimaryClient(&harness.client);
+
+    harness.press_button(kButtonMiddle, 0);
+    harness.deliver(EventType::SERVER_CONNECTED,
+                    create_event_data<Server::ScreenConnectedInfo>(
+                        Server::ScreenConnectedInfo{"laptop", ScreenId::intern("laptop")}));
+
+    EXPECT_EQ(log, (std::vector<std::string>{"middle-1", "connected"}));
+
+    filter.setPrimaryClient(nullptr);
+}
+
+TEST(InputFilterTests, copy_rebuilds_index)
+{
+    FilterHarness harness;
+    std::vector<std::string> log;
+    InputFilter filter(&harness.queue);
+    filter.addFilterRule(make_rule(new InputFilter::MouseButtonCondition(kButtonRight, 0),
+                                   &log, "right"));
+
+    InputFilter copy(&harness.queue);
+    copy = filter;
+    copy.setPrimaryClient(&harness.client);
+    harness.press_button(kButtonRight, 0);
+
+    EXPECT_EQ(log, std::vector<std::string>{"right"});
+
+    copy.setPrimaryClient(nullptr);
+}
+
+// the repo has no benchmark harness; run with --gtest_also_run_disabled_tests
+TEST(InputFilterTests, DISABLED_benchmark)
+{
+    FilterHarness harness;
+    std::vector<std::string> log;
+    InputFilter filter(&harness.queue);
+    std::vector<InputFilter::Rule> rules;
+    for (int i = 0; i < 100; ++i) {
+        rules.push_back(make_rule(new InputFilter::KeystrokeCondition(kKeyF1 + i % 12,
+                                                                      KeyModifierControl << (i / 12)),
+                                  &log, "key"));
+        rules.push_back(make_rule(new InputFilter::MouseButtonCondition(
+                                      static_cast<ButtonID>(1 + i % 5), KeyModifierAlt << (i / 5)),
+                                  &log, "button"));
+    }
+    filter.add_rules(rules);
+    filter.setPrimaryClient(&harness.client);
+
+    const int iterations = 200000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        harness.press_hot_key(1000);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%-32s %8.1f ns/event\n", "200 rules, no matching hot key",
+                elapsed.count() * 1e9 / iterations);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        harness.press_button(kButtonLeft, KeyModifierShift);
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%-32s %8.1f ns/event\n", "200 rules, no matching button",
+                elapsed.count() * 1e9 / iterations);
+
+    EXPECT_TRUE(log.empty());
+    EXPECT_EQ(harness.passed_, 2 * iterations);
+
+    filter.setPrimaryClient(nullptr);
+}
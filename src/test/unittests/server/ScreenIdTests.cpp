@@ -0,0 +1,67 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ScreenId.h"
+#include "server/InputFilter.h"
+#include "server/Server.h"
+#include "base/Event.h"
+
+#include <gtest/gtest.h>
+
+using namespace inputleap;
+
+TEST(ScreenIdTests, intern_ignores_case)
+{
+    ScreenId a = ScreenId::intern("ScreenIdTests-Desk");
+    ScreenId b = ScreenId::intern("screenidtests-DESK");
+    ScreenId c = ScreenId::intern("ScreenIdTests-laptop");
+
+    EXPECT_TRUE(a.is_valid());
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a.name(), "ScreenIdTests-Desk");
+    EXPECT_EQ(ScreenId::find("SCREENIDTESTS-DESK"), a);
+}
+
+TEST(ScreenIdTests, default_is_invalid)
+{
+    ScreenId id;
+    EXPECT_FALSE(id.is_valid());
+    EXPECT_EQ(id.value(), 0u);
+    EXPECT_EQ(id.name(), "");
+    EXPECT_FALSE(ScreenId::find("ScreenIdTests-never-interned").is_valid());
+}
+
+TEST(ScreenIdTests, screen_connected_condition_matches_by_id)
+{
+    InputFilter::ScreenConnectedCondition condition("ScreenIdTests-Left");
+    InputFilter::ScreenConnectedCondition any("");
+
+    Server::ScreenConnectedInfo left{"screenidtests-left", ScreenId::intern("screenidtests-left")};
+    Server::ScreenConnectedInfo right{"ScreenIdTests-Right", ScreenId::intern("ScreenIdTests-Right")};
+    Event left_event(EventType::SERVER_CONNECTED, nullptr,
+                     create_event_data<Server::ScreenConnectedInfo>(left));
+    Event right_event(EventType::SERVER_CONNECTED, nullptr,
+                      create_event_data<Server::ScreenConnectedInfo>(right));
+
+    EXPECT_EQ(condition.match(left_event), InputFilter::kActivate);
+    EXPECT_EQ(condition.match(right_event), InputFilter::kNoMatch);
+    EXPECT_EQ(any.match(right_event), InputFilter::kActivate);
+
+    Event::deleteData(left_event);
+    Event::deleteData(right_event);
+}
@@ -0,0 +1,107 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ScreenTopology.h"
+#include "server/Config.h"
+
+#include <gtest/gtest.h>
+
+using namespace inputleap;
+
+namespace {
+
+// left and right of "server" are split between two screens each, "laptop"
+// sits below and wraps around to the top of "server"
+Config make_config()
+{
+    Config config;
+    config.addScreen("server");
+    config.addScreen("Left1");
+    config.addScreen("left2");
+    config.addScreen("right");
+    config.addScreen("laptop");
+    config.addAlias("server", "server.local");
+
+    config.connect("server", kLeft, 0.0f, 0.5f, "Left1", 0.0f, 1.0f);
+    config.connect("server", kLeft, 0.5f, 1.0f, "left2", 0.0f, 1.0f);
+    config.connect("Left1", kRight, 0.0f, 1.0f, "server", 0.0f, 0.5f);
+    config.connect("left2", kRight, 0.0f, 1.0f, "server", 0.5f, 1.0f);
+    config.connect("server", kRight, 0.25f, 0.75f, "right", 0.0f, 1.0f);
+    config.connect("right", kLeft, 0.0f, 1.0f, "server", 0.25f, 0.75f);
+    config.connect("server", kBottom, 0.0f, 1.0f, "laptop", 0.2f, 0.8f);
+    config.connect("laptop", kTop, 0.2f, 0.8f, "server", 0.0f, 1.0f);
+    config.connect("laptop", kBottom, 0.0f, 1.0f, "server", 0.0f, 1.0f);
+    return config;
+}
+
+} // namespace
+
+TEST(ScreenTopologyTests, find_ignores_case_and_resolves_aliases)
+{
+    Config config = make_config();
+    ScreenTopology topology(config);
+
+    EXPECT_EQ(topology.size(), 5u);
+    ScreenTopology::Index server = topology.find("server");
+    ASSERT_NE(server, ScreenTopology::kNoScreen);
+    EXPECT_EQ(topology.find("SERVER"), server);
+    EXPECT_EQ(topology.find("Server.Local"), server);
+    EXPECT_EQ(topology.name(topology.find("left1")), "Left1");
+    EXPECT_EQ(topology.find("missing"), ScreenTopology::kNoScreen);
+}
+
+TEST(ScreenTopologyTests, neighbor_matches_config)
+{
+    Config config = make_config();
+    ScreenTopology topology(config);
+
+    for (auto name = config.begin(); name != config.end(); ++name) {
+        ScreenTopology::Index screen = topology.find(*name);
+        for (int side = kFirstDirection; side <= kLastDirection; ++side) {
+            EDirection dir = static_cast<EDirection>(side);
+            EXPECT_EQ(topology.has_neighbor(screen, dir), config.hasNeighbor(*name, dir));
+            for (int i = 0; i <= 100; ++i) {
+                float t = i / 100.0f;
+                float expected_position = -1.0f;
+                std::string expected = config.getNeighbor(*name, dir, t, &expected_position);
+
+                ScreenTopology::Neighbor neighbor = topology.neighbor(screen, dir, t);
+                if (expected.empty()) {
+                    EXPECT_EQ(neighbor.screen, ScreenTopology::kNoScreen)
+                        << *name << " side " << side << " at " << t;
+                }
+                else {
+                    ASSERT_NE(neighbor.screen, ScreenTopology::kNoScreen)
+                        << *name << " side " << side << " at " << t;
+                    EXPECT_EQ(topology.name(neighbor.screen), expected);
+                    EXPECT_EQ(neighbor.position, expected_position);
+                }
+            }
+        }
+    }
+}
+
+TEST(ScreenTopologyTests, unknown_screen_has_no_neighbors)
+{
+    ScreenTopology empty;
+    EXPECT_EQ(empty.neighbor(0, kLeft, 0.5f).screen, ScreenTopology::kNoScreen);
+    EXPECT_FALSE(empty.has_neighbor(ScreenTopology::kNoScreen, kTop));
+
+    ScreenTopology topology(make_config());
+    EXPECT_EQ(topology.neighbor(ScreenTopology::kNoScreen, kLeft, 0.5f).screen,
+              ScreenTopology::kNoScreen);
+}